@@ -34,13 +34,17 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <map>
+#include <list>
 #include <fstream>
 #include <algorithm>
 #include "config.h"
 #include "ticcutils/PrettyPrint.h"
 #include "ticcutils/StringOps.h"
 #include "ticcutils/XMLtools.h"
+#include "libxml/xpath.h"
 #include "libfolia/folia.h"
+#include "tscan/AlpinoTree.h"
 
 enum DD_type { SUB_VERB, OBJ1_VERB, OBJ2_VERB, VERB_PP, VERB_VC,
 	       VERB_COMP, NOUN_DET, PREP_OBJ1, CRD_CNJ, COMP_BODY, NOUN_VC,
@@ -56,6 +60,17 @@ inline std::ostream& operator<< (std::ostream&os, const DD_type& t ){
   return os;
 }
 
+// The number of punctuation marks in a sentence before each position, so
+// the punctuation between two words is counted with one subtraction.
+class PunctuationIndex {
+ public:
+  PunctuationIndex(): before( 1, 0 ) {};
+  explicit PunctuationIndex( const std::vector<bool>& );
+  int count( int, int ) const;
+ private:
+  std::vector<int> before;
+};
+
 enum WWform { NO_VERB, PASSIVE_VERB, MODAL_VERB, TIME_VERB,
 	      COPULA, HEAD_VERB };
 std::string toString( const WWform& );
@@ -64,24 +79,51 @@ inline std::ostream& operator<< (std::ostream&os, const WWform& wf ){
   return os;
 }
 
-xmlDoc *AlpinoParse( const folia::Sentence *, const std::string& );
-xmlNode *getAlpNodeWord( xmlDoc *, const folia::Word * );
-bool checkImp( const xmlNode * );
-bool checkModifier( const xmlNode * );
+// Evaluates XPath expressions on one Alpino tree. Every expression is
+// compiled once (per thread), and the result for an expression and a
+// context node is remembered as long as the AlpinoQueries lives.
+class AlpinoQueries {
+ public:
+  explicit AlpinoQueries( xmlDoc * );
+  ~AlpinoQueries();
+  std::list<xmlNode*> find( xmlNode *, const std::string& );
+  std::list<xmlNode*> find( const std::string& ); // from the root
+  xmlNode *root() const { return xmlDocGetRootElement( doc ); };
+ private:
+  AlpinoQueries( const AlpinoQueries& ); // no copies
+  AlpinoQueries& operator=( const AlpinoQueries& );
+  xmlDoc *doc;
+  xmlXPathContext *context;
+  std::map<std::pair<std::string,const xmlNode*>,
+	   std::list<xmlNode*>> results;
+};
+
+std::vector<std::string> splitForAlpino( const std::string&,
+					 const std::vector<std::string>&,
+					 size_t );
+xmlDoc *joinAlpinoParses( std::vector<xmlDoc*>&,
+			  const std::vector<std::string>& );
+int getAlpNodeWord( const AlpinoTree&, const folia::Word * );
+bool checkImp( const AlpinoTree&, int );
+bool checkModifier( const AlpinoTree&, int );
 void countCrdCnj( xmlDoc *, int&, int& );
-void mod_stats( xmlDoc *, int&, int& );
+void mod_stats( AlpinoQueries&, int&, int& );
+int tree_d_level( xmlDoc * );
+int get_d_level( const folia::Sentence *, int );
 int get_d_level( const folia::Sentence *s, xmlDoc *alp );
+std::vector<xmlNode*> getSibblings( const xmlNode * );
+xmlNode *node_search( const xmlNode*, const std::string&, const std::string& );
 int indef_npcount( xmlDoc *alp );
-WWform classifyVerb( const xmlNode *, const std::string&, std::string& );
-std::multimap<DD_type,int> getDependencyDist( const xmlNode *,
-					      const std::set<size_t>& );
+WWform classifyVerb( const AlpinoTree&, int, const std::string&, std::string& );
+std::multimap<DD_type,int> getDependencyDist( const AlpinoTree&, int,
+					      const PunctuationIndex& );
 bool isSmallCnj( const xmlNode *);
 
-std::list<xmlNode*> getAdverbialNodes( xmlDoc* );
-std::list<xmlNode*> getNodesByCat( xmlDoc*, const std::string&, const std::string& = "" );
-std::list<xmlNode*> getNodesByRelCat( xmlDoc*, const std::string&, const std::string&, const std::string& = "" );
-std::list<xmlNode*> getNodesByCat( xmlNode*, const std::string&, const std::string& = "" );
-std::list<xmlNode*> getNodesByRelCat( xmlNode*, const std::string&, const std::string&, const std::string& = "" );
+std::list<xmlNode*> getAdverbialNodes( AlpinoQueries& );
+std::list<xmlNode*> getNodesByCat( AlpinoQueries&, const std::string&, const std::string& = "" );
+std::list<xmlNode*> getNodesByRelCat( AlpinoQueries&, const std::string&, const std::string&, const std::string& = "" );
+std::list<xmlNode*> getNodesByCat( AlpinoQueries&, xmlNode*, const std::string&, const std::string& = "" );
+std::list<xmlNode*> getNodesByRelCat( AlpinoQueries&, xmlNode*, const std::string&, const std::string&, const std::string& = "" );
 std::list<std::string> getNodeIds( std::list<xmlNode*> );
 std::list<xmlNode*> complementNodes( std::list<xmlNode*>, std::list<xmlNode*> );
 
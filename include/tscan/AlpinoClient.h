@@ -0,0 +1,140 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef ALPINO_CLIENT_H
+#define ALPINO_CLIENT_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include "libxml/tree.h"
+#include "ticcutils/Configuration.h"
+#include "tscan/Endpoints.h"
+
+// Client for the Alpino servers (see webservice/startalpino.sh).
+//
+// The Alpino server parses one sentence per connection, and closes the
+// connection after sending the XML. So connections can't be reused, but
+// several requests can be in flight at the same time. AlpinoClient spreads
+// the requests over the servers (see Endpoints), with at most
+// 'connections' concurrent connections per server, and retries failed
+// requests. An AlpinoBatch sends all sentences of a document ahead of
+// their analysis, so the parses are there when the sentences need them.
+// Sentences can be added while the batch runs, e.g. as soon as Frog has
+// tagged them. Sentences found in the parse cache (if any) are not sent
+// at all. Sentences of more than 'split' tokens (when not 0) are sent in
+// pieces, which are joined again into one parse (see splitForAlpino).
+// The longest queued sentence is sent first, so a long sentence doesn't
+// start last and keep the document waiting. The client learns for every
+// server how many seconds a token takes to parse there, so a request goes
+// to the server that is expected to be done with it first.
+
+class ParseCache;
+
+// how the parses of a batch were spread over the connections. Times are
+// in seconds since the first request was sent. Parses found in the cache
+// are not counted.
+struct AlpinoSchedule {
+  AlpinoSchedule(): requests(0), connections(0), makespan(0), busy(0),
+		    estimate(0), longest(0), longest_tokens(0),
+		    longest_end(0) {};
+  size_t requests;
+  int connections;
+  double makespan;    // from the first start to the last finish
+  double busy;        // the summed parse times
+  double estimate;    // the summed estimated parse times
+  double longest;     // the parse time of the slowest request
+  size_t longest_tokens;
+  double longest_end; // when the slowest request finished
+};
+std::ostream& operator<<( std::ostream&, const AlpinoSchedule& );
+
+class AlpinoClient {
+ public:
+  AlpinoClient( const std::string&, const std::string&, int = 4, int = 2 );
+  explicit AlpinoClient( const TiCC::Configuration& );
+  // parse one sentence. returns false when the server couldn't parse it
+  bool parse( const std::string&, std::string& );
+  int connections() const { return servers.capacity(); };
+  // the expected parse time of a sentence of this many tokens
+  double estimate( size_t );
+ private:
+  // how a request ended. Only a server that can't be reached is left out
+  // for a while: a sentence it can't parse (in time) says nothing about
+  // the server
+  enum Outcome { PARSED, NO_PARSE, UNREACHABLE };
+  Outcome request( int, const std::string&, std::string& );
+  int max_connections;
+  int retries;
+  unsigned int timeout; // seconds, 0 means wait forever
+  Endpoints servers;
+};
+
+class AlpinoBatch {
+ public:
+  explicit AlpinoBatch( AlpinoClient&, ParseCache * = 0, size_t = 0 );
+  // the sentences, and Frog's tags of their tokens (see splitForAlpino)
+  AlpinoBatch( AlpinoClient&, const std::vector<std::string>&,
+	       const std::vector<std::vector<std::string>>&,
+	       ParseCache * = 0, size_t = 0 );
+  ~AlpinoBatch();
+  // queues a sentence with its tags. returns its position in the batch
+  size_t add( const std::string&, const std::vector<std::string>& );
+  // the positions of the given sentences in the batch. sentences that
+  // weren't queued yet are added.
+  std::vector<size_t> positions( const std::vector<std::string>&,
+				 const std::vector<std::vector<std::string>>& );
+  // waits for the parse of sentence 'i'. returns 0 when it failed.
+  // the caller owns the returned document.
+  xmlDoc *result( size_t );
+  AlpinoSchedule schedule();
+ private:
+  AlpinoBatch( const AlpinoBatch& ); // no copies
+  AlpinoBatch& operator=( const AlpinoBatch& );
+  void start();
+  void work();
+  size_t queue( const std::string&, const std::vector<std::string>& );
+  bool before( size_t, size_t ) const;
+  AlpinoClient& client;
+  ParseCache *cache;
+  size_t split;
+  std::vector<std::string> sentences;
+  std::vector<std::vector<size_t>> pieces; // the requests of each sentence
+  std::vector<std::string> requests;
+  std::vector<size_t> tokens;
+  std::vector<xmlDoc*> parses;
+  std::vector<bool> done;
+  std::vector<size_t> pending; // a heap, the most expensive request on top
+  AlpinoSchedule timing;
+  std::chrono::steady_clock::time_point first_start;
+  bool stopping;
+  std::mutex lock;
+  std::condition_variable queued;
+  std::condition_variable ready;
+  std::vector<std::thread> workers;
+};
+
+#endif // ALPINO_CLIENT_H
@@ -0,0 +1,80 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef ALPINO_POOL_H
+#define ALPINO_POOL_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <sys/types.h>
+#include "libxml/tree.h"
+#include "ticcutils/Configuration.h"
+
+// A pool of local Alpino processes, for parsing without an Alpino server.
+//
+// Every process is started once, as an Alpino server on a free port of
+// this machine, so Alpino's start-up is paid once per process instead of
+// once per sentence. Before the first connection the pool checks that the
+// port is held by the process it started; when another program took the
+// port, Alpino is started again on another one. A sentence is sent over a
+// connection to its process, and the parse is read back from that
+// connection. Each process runs in a directory of its own, so processes
+// don't share any files.
+// Alpino itself gives up on a sentence after the timeout (its user_max,
+// 300 seconds unless set). A process that hasn't answered within twice
+// the timeout is killed; a killed or crashed process is started again for
+// the next sentence.
+
+class AlpinoPool {
+ public:
+  AlpinoPool( const std::string&, int = 1, unsigned int = 300 );
+  AlpinoPool( const TiCC::Configuration&, const std::string& );
+  ~AlpinoPool();
+  // parse one tokenized sentence. returns 0 when Alpino failed.
+  // the caller owns the returned document.
+  xmlDoc *parse( const std::string& );
+ private:
+  AlpinoPool( const AlpinoPool& ); // no copies
+  AlpinoPool& operator=( const AlpinoPool& );
+  struct Process {
+    Process(): pid(-1), port(0), ready(false), busy(false) {};
+    pid_t pid;      // also the process group of Alpino and its children
+    int port;
+    std::string dir;
+    bool ready;     // it accepted a connection, so it is done starting
+    bool busy;
+  };
+  void init( const std::string&, int );
+  bool start( Process& );
+  void stop( Process& );
+  bool running( Process& );
+  int connect( Process& );
+  xmlDoc *request( Process&, const std::string& );
+  std::vector<Process> processes;
+  unsigned int timeout; // seconds
+  std::mutex lock;
+  std::condition_variable released;
+};
+
+#endif // ALPINO_POOL_H
@@ -0,0 +1,151 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef ALPINO_TREE_H
+#define ALPINO_TREE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include "libxml/tree.h"
+
+// The labels of an Alpino tree that tscan looks at. A missing attribute is
+// NONE, a value tscan doesn't know about is OTHER.
+
+namespace AlpRel {
+    enum Type : unsigned char {
+        NONE, OTHER,
+        APP, BODY, CMP, CNJ, CRD, DET, DLINK, DP, HD, HDF, LD, ME, MOD, MWP,
+        NUCL, OBCOMP, OBJ1, OBJ2, PC, POBJ1, PREDC, PREDM, RHD, SAT, SE,
+        SU, SUP, SVP, TAG, TOP, VC, WHD,
+        OBJ // not an Alpino label, but tree_d_level() asks for it
+    };
+    Type fromString( const std::string& );
+}
+
+namespace AlpCat {
+    // also used for 'lcat'
+    enum Type : unsigned char {
+        NONE, OTHER,
+        ADVP, AHI, AP, CONJ, CP, DETP, DU, INF, MWU, NP, OTI, PP, PPART,
+        PPRES, REL, SMAIN, SSUB, SV1, SVAN, TI, TOP, WHQ, WHREL, WHSUB,
+        PART
+    };
+    Type fromString( const std::string& );
+}
+
+namespace AlpPos {
+    enum Type : unsigned char {
+        NONE, OTHER,
+        ADJ, ADV, COMP, COMPARATIVE, DET, FIXED, NAME, NOUN, NUM, PART, PP,
+        PREFIX, PREP, PRON, PUNCT, TAG, VERB, VG
+    };
+    Type fromString( const std::string& );
+}
+
+// One <node> of an Alpino tree. The nodes are stored in document order,
+// so the descendants of node i are the nodes i+1 up to 'last'.
+struct AlpinoNode {
+  AlpRel::Type rel;
+  AlpCat::Type cat;
+  AlpCat::Type lcat;
+  AlpPos::Type pos;
+  int id;
+  int begin;
+  int end;
+  int index;       // -1 when not co-indexed
+  int parent;      // -1 for the top node
+  int first_child; // -1 for a leaf
+  int next;        // the next sibling, -1 for the last one
+  int last;
+  unsigned int word; // the strings are offsets in the text of the tree
+  unsigned int root;
+  unsigned int sc;
+  unsigned int pt;
+};
+
+// An Alpino parse, converted once from the DOM into one array of nodes and
+// one block of text, so the analyses don't have to go through libxml2 and
+// compare attribute strings for every question they ask.
+class AlpinoTree {
+ public:
+  explicit AlpinoTree( xmlDoc * );
+  size_t size() const { return nodes.size(); };
+  const AlpinoNode& operator[]( int i ) const { return nodes[i]; };
+  const char *str( unsigned int offset ) const { return text.c_str() + offset; };
+  bool has( unsigned int offset ) const { return text[offset] != 0; };
+  AlpRel::Type rel( int i ) const { return i < 0 ? AlpRel::NONE : nodes[i].rel; };
+  AlpCat::Type cat( int i ) const { return i < 0 ? AlpCat::NONE : nodes[i].cat; };
+  int word_node( size_t ) const;
+  int search( int, AlpRel::Type ) const;
+  int antecedent( int ) const;
+ private:
+  void add( const xmlNode *, int );
+  void add_antecedents();
+  unsigned int store( const std::string& );
+  std::vector<AlpinoNode> nodes;
+  std::string text;
+  std::vector<int> words; // the one word nodes, on their 'end' position
+  std::vector<int> antecedents; // the antecedent node of each index
+};
+
+// The sentence counts that tscan takes from an Alpino tree: clauses,
+// conjunctions, adverbials, NP modifiers and the tree part of the d-level.
+//
+// analyseAlpinoTree collects them in one walk over the tree.
+// xpathAlpinoTree computes the same counts with the XPath expressions
+// they are defined by. It is much slower, and is kept as the reference
+// that analyseAlpinoTree is tested against (see tests/testtrees).
+
+struct AlpinoTreeStats {
+  AlpinoTreeStats();
+  int dLevel;           // see tree_d_level()
+  int adjNpModCnt;
+  int npModCnt;
+  int vcModCnt;
+  std::vector<std::string> vcModWords; // the words of one-word adverbials
+  int betrCnt;
+  int bijwCnt;
+  int complCnt;
+  int infinComplCnt;
+  int mvFinInbedCnt;
+  int mvInbedCnt;
+  int losBetrCnt;
+  int losBijwCnt;
+  int smainCnt;
+  int ssubCnt;
+  int sv1Cnt;
+  int smainCnjCnt;
+  int ssubCnjCnt;
+  int sv1CnjCnt;
+  int smallCnjCnt;
+  int smallCnjExtraCnt;
+};
+
+bool operator==( const AlpinoTreeStats&, const AlpinoTreeStats& );
+std::ostream& operator<<( std::ostream&, const AlpinoTreeStats& );
+
+AlpinoTreeStats analyseAlpinoTree( const AlpinoTree& );
+AlpinoTreeStats analyseAlpinoTree( xmlDoc * );
+AlpinoTreeStats xpathAlpinoTree( xmlDoc * );
+
+#endif // ALPINO_TREE_H
@@ -0,0 +1,89 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef ENDPOINTS_H
+#define ENDPOINTS_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include "ticcutils/Configuration.h"
+
+// The servers that offer one service, e.g. several Alpino servers started
+// on other ports or machines. A config section lists them as
+//   servers=host:port[:limit],host:port[:limit],...
+// or names one server with 'host' and 'port' (with a suffix for Wopr's
+// two directions: servers_fwd, host_fwd, port_fwd).
+//
+// A request goes to the server with the fewest outstanding requests, that
+// has fewer than 'limit' of them (0 means no limit). When the client tells
+// how long the requests took (see learn), the outstanding requests are
+// weighed with the time a server takes per unit of work (e.g. per token),
+// so a slower server gets fewer of them. A server that fails
+// a request is left out for 'cooldown' seconds (set in the same section),
+// after which the next request tries it again. When all servers are left out,
+// they are used anyway, so a single server is never given up on.
+
+class Endpoints {
+ public:
+  Endpoints( const std::string&, const std::string&, int = 0 );
+  Endpoints( const TiCC::Configuration&, const std::string&,
+	     const std::string& = "", int = 0 );
+  size_t size() const { return servers.size(); };
+  // the summed limits, 0 when a server has no limit
+  int capacity() const;
+  // waits for a server with room for another request. returns its number
+  int acquire();
+  // ends a request on server 'i'. 'ok' is false when the server failed
+  void release( int, bool );
+  // server 'i' did a request of this many units of work in this many
+  // seconds
+  void learn( int, size_t, double );
+  // the expected seconds for this many units of work. 0 until learned
+  double estimate( size_t );
+  const std::string& host( int i ) const { return servers[i].host; };
+  const std::string& port( int i ) const { return servers[i].port; };
+  std::string name( int i ) const { return host( i ) + ":" + port( i ); };
+ private:
+  Endpoints( const Endpoints& ); // no copies
+  Endpoints& operator=( const Endpoints& );
+  int pick() const;
+  double mean_rate() const;
+  struct Server {
+    Server( const std::string& h, const std::string& p, int l ):
+      host( h ), port( p ), limit( l ), outstanding( 0 ), rate( 0 ) {};
+    std::string host;
+    std::string port;
+    int limit;
+    int outstanding;
+    double rate; // seconds per unit of work, 0 until learned
+    std::chrono::steady_clock::time_point retry_at; // when left out
+  };
+  std::vector<Server> servers;
+  unsigned int cooldown; // seconds
+  std::mutex lock;
+  std::condition_variable released;
+};
+
+#endif // ENDPOINTS_H
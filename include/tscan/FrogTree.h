@@ -0,0 +1,46 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FROG_TREE_H
+#define FROG_TREE_H
+
+#include <string>
+#include "libxml/tree.h"
+#include "libfolia/folia.h"
+
+// An approximation of the Alpino parse of a sentence, built from the
+// dependency layer and the POS tags that Frog adds to the FoLiA.
+//
+// Every word with dependents becomes a phrase holding the word as 'hd'
+// and its dependents with their relations, which is how Alpino lays out a
+// tree. The phrase categories are guessed from the head's POS tag and
+// place in the sentence. There are no co-indexed nodes, and the 'sc'
+// frames are only guessed for the passive. So the counts computed from
+// such a tree are approximate. The root of the tree is marked with
+// syntax="frog".
+// The sets of the POS tags and lemmas are given. Returns 0 when the
+// sentence has no dependencies.
+
+xmlDoc *frogDependencyTree( const folia::Sentence *,
+			    const std::string&, const std::string& );
+
+#endif // FROG_TREE_H
@@ -0,0 +1,65 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+#include "libxml/tree.h"
+
+// A persistent cache of Alpino parses.
+//
+// Every parse is stored as a gzip-ed XML file, named after two 64 bit
+// FNV-1a hashes of the tokenized sentence and the identity of the parser
+// (server address and flags), so a changed parser setup doesn't find the
+// old trees. FNV is no cryptographic hash, so a lookup also checks that the
+// cached parse is of the requested sentence; if not, it is a miss.
+// Files are written to a temporary name and renamed, so several tscan
+// processes can share one cache directory. A lookup touches the file; when
+// the cache grows beyond its size limit the least recently used files are
+// removed.
+
+class ParseCache {
+ public:
+  ParseCache( const std::string&, const std::string&, uint64_t );
+  // returns 0 when the sentence isn't in the cache.
+  // the caller owns the returned document.
+  xmlDoc *lookup( const std::string& );
+  void store( const std::string&, xmlDoc * );
+  size_t hits() const { return _hits; };
+  size_t misses() const { return _misses; };
+ private:
+  std::string filename( const std::string& ) const;
+  void evict();
+  std::string dir;
+  std::string identity;
+  uint64_t max_size;
+  std::atomic<uint64_t> added;   // bytes stored since the last eviction
+  std::atomic<size_t> _hits;
+  std::atomic<size_t> _misses;
+  std::mutex evict_lock;
+};
+
+#endif // PARSE_CACHE_H
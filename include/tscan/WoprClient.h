@@ -0,0 +1,84 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef WOPR_CLIENT_H
+#define WOPR_CLIENT_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "ticcutils/Configuration.h"
+#include "tscan/Endpoints.h"
+
+// Client for the Wopr servers (forward and backward).
+//
+// Wopr takes one sentence per line, up to an empty line, and answers with
+// a FoLiA document holding a sentence per input line. A WoprBatch sends
+// all sentences of a document in one request per direction (or in chunks
+// of 'batch' sentences when that is set in [[wopr]]), so a document costs
+// two round trips instead of two per sentence. When Wopr's answer doesn't
+// line up with the request, the sentences of that chunk are sent one by
+// one. Each direction may be served by several Wopr servers (see
+// Endpoints); a request goes to the least busy one.
+
+struct WoprResult {
+  WoprResult();
+  std::vector<double> word_probs; // lprob10 per word, as returned
+  double sent_prob;               // avg_prob10
+  double entropy;
+  double perplexity;
+};
+
+class WoprClient {
+ public:
+  explicit WoprClient( Endpoints& );
+  // sends the sentences in one request. returns false when the request
+  // failed, or the answer doesn't hold one sentence for each of them
+  bool request( const std::vector<std::string>&, std::vector<WoprResult>& );
+ private:
+  Endpoints& servers;
+};
+
+class WoprBatch {
+ public:
+  WoprBatch( const TiCC::Configuration&, Endpoints&, Endpoints&,
+	     const std::vector<std::string>& );
+  ~WoprBatch();
+  // waits for the forward and backward results of sentence 'i'
+  void result( size_t, WoprResult&, WoprResult& );
+ private:
+  WoprBatch( const WoprBatch& ); // no copies
+  WoprBatch& operator=( const WoprBatch& );
+  void work( WoprClient, std::vector<WoprResult>& );
+  std::vector<std::string> sentences;
+  size_t chunk_size;
+  std::vector<WoprResult> fwd;
+  std::vector<WoprResult> bwd;
+  std::vector<int> done; // directions finished, per sentence
+  std::mutex lock;
+  std::condition_variable ready;
+  std::vector<std::thread> workers;
+};
+
+#endif // WOPR_CLIENT_H
@@ -0,0 +1,105 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FEATURES_H
+#define FEATURES_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "tscan/stats.h"
+
+// The features of a word that only depend on the word itself: its text,
+// lemma, POS tag and morphological analyses, and the lexicons. Text is very
+// repetitive at the type level, so these are computed once per type and
+// remembered. The features that depend on the sentence (the Alpino parse)
+// are computed for every token.
+struct word_features {
+  std::vector<std::string> morphemes;
+  std::string compstr;
+  bool isPropNeg;
+  bool isMorphNeg;
+  Conn::Type connType;
+  Situation::Type sitType;
+  SEM::Type sem_type;
+  bool is_compound;
+  int compound_parts;
+  std::string compound_head;
+  std::string compound_sat;
+  Intensify::Type intensify_type; // before the check for a modifier
+  General::Type general_noun_type;
+  General::Type general_verb_type;
+  Adverb::Type adverb_type;
+  Adverb::SubType adverb_sub_type;
+  Afk::Type afkType;
+  top_val top_freq;
+  double prevalenceP;
+  double prevalenceZ;
+  bool f50;
+  bool f65;
+  bool f77;
+  bool f80;
+  // the frequencies are only used for content words
+  int word_freq;
+  int lemma_freq;
+  double word_freq_log;
+  double lemma_freq_log;
+  double word_freq_log_head;
+  double word_freq_log_sat;
+  double word_freq_log_head_sat;
+  top_val top_freq_head;
+  top_val top_freq_sat;
+  bool on_stoplist;
+  std::string my_classification;
+  std::vector<std::string> problems; // lines for the problems file
+};
+
+// The word_features per type, shared by all threads that use the same
+// lexicons. Stops remembering new types when it holds 'max' of them.
+class FeatureMemo {
+ public:
+  explicit FeatureMemo( size_t );
+  // copies the features of 'key' into the second argument
+  bool find( const std::string&, word_features& ) const;
+  void add( const std::string&, const word_features& );
+  // the number of types and the hit rate
+  std::string stats() const;
+ private:
+  FeatureMemo( const FeatureMemo& ); // no copies
+  FeatureMemo& operator=( const FeatureMemo& );
+  // the types are spread over several maps, each with its own lock,
+  // so the threads rarely wait for each other
+  static const size_t SHARDS = 16;
+  struct shard {
+    std::mutex lock;
+    std::unordered_map<std::string,word_features> types;
+  };
+  shard& shard_of( const std::string& ) const;
+  mutable shard shards[SHARDS];
+  size_t max_per_shard;
+  mutable std::atomic<size_t> lookups;
+  mutable std::atomic<size_t> hits;
+};
+
+#endif // FEATURES_H
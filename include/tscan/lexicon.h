@@ -0,0 +1,224 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef LEXICON_H
+#define LEXICON_H
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <type_traits>
+
+// Read-only lexicon tables.
+//
+// A lexicon image holds a string pool and a number of named tables.
+// Every table maps a string onto a fixed-size record, using a minimal
+// perfect hash (hash and displace) to find the only slot a key can be in.
+// Keys are stored in the pool, so a lookup costs one hash computation,
+// two array accesses and one string compare.
+//
+// The image is position independent: it can be built in memory from the
+// text lexicons, or saved to a file (using tscan-lexc) and mmap-ed
+// read-only, so processes on one host share one copy of the lexicons.
+
+namespace Lexicon {
+
+  const char magic[] = "TSCANLX";
+  const uint32_t version = 1;
+
+  struct imageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tables;      // number of tableEntry's in the directory
+    uint64_t size;        // size of the whole image
+    uint64_t pool;        // offset of the string pool
+    uint64_t pool_size;
+    uint64_t directory;   // offset of the table directory
+  };
+
+  struct tableEntry {
+    uint32_t name;        // string pool offset
+    uint32_t source;      // string pool offset of the source filename
+    uint64_t source_size; // size of the source when compiled
+    int64_t source_mtime; // modification time of the source when compiled
+    double param;         // loading parameter (e.g. frequencyClip)
+    int64_t total;        // a table specific total (e.g. frequency sum)
+    uint64_t count;       // number of keys
+    uint64_t buckets;     // number of hash buckets
+    uint64_t record_size;
+    uint64_t seeds;       // offset of buckets int32_t seeds
+    uint64_t slots;       // offset of count slot's
+    uint64_t records;     // offset of count records
+  };
+
+  struct slot {
+    uint32_t key;         // string pool offset
+    uint32_t length;
+  };
+
+  // Where a table came from. Used to decide whether a compiled table is
+  // still valid for the current configuration.
+  struct sourceInfo {
+    sourceInfo(): size(0), mtime(0), param(0), total(0) {};
+    explicit sourceInfo( const std::string&, double = 0 );
+    bool matches( const tableEntry&, const char * ) const;
+    std::string file;
+    uint64_t size;
+    int64_t mtime;
+    double param;
+    int64_t total;
+  };
+
+  uint64_t hash( const std::string& );
+
+  class rawTable {
+  public:
+    rawTable(): _count(0), _buckets(0), _record_size(0),
+      seeds(0), slots(0), records(0), pool(0), pool_size(0) {};
+    rawTable( const char *, const tableEntry& );
+    const void *find( const std::string& ) const;
+    size_t size() const { return _count; };
+    size_t record_size() const { return _record_size; };
+    // an offset outside the pool (a corrupt file) gives the empty string
+    const char *str( uint32_t off ) const {
+      return off < pool_size ? pool + off : pool;
+    };
+    std::string key( size_t i ) const {
+      if ( !in_pool( slots[i] ) ){
+	return "";
+      }
+      return std::string( pool + slots[i].key, slots[i].length );
+    };
+  private:
+    bool in_pool( const slot& s ) const {
+      return s.key < pool_size && s.length <= pool_size - s.key;
+    };
+    uint64_t _count;
+    uint64_t _buckets;
+    uint64_t _record_size;
+    const int32_t *seeds;
+    const slot *slots;
+    const char *records;
+    const char *pool;
+    uint64_t pool_size;
+  };
+
+  template <typename R>
+    class Table {
+  public:
+    Table() {};
+    explicit Table( const rawTable& r ): raw(r) {};
+    // returns 0 when the key isn't found
+    const R *find( const std::string& key ) const {
+      return static_cast<const R*>( raw.find( key ) );
+    };
+    bool contains( const std::string& key ) const {
+      return raw.find( key ) != 0;
+    };
+    size_t size() const { return raw.size(); };
+    // the keys are stored in no particular order
+    std::string key( size_t i ) const { return raw.key( i ); };
+    // strings inside records are stored as offsets in the string pool
+    std::string str( uint32_t off ) const { return raw.str( off ); };
+  private:
+    rawTable raw;
+  };
+
+  class Builder {
+  public:
+    Builder();
+    uint32_t add_string( const std::string& );
+    template <typename R>
+      void add_table( const std::string& name,
+		      const std::map<std::string,R>& m,
+		      const sourceInfo& src ){
+      static_assert( std::is_pod<R>::value,
+		     "lexicon records must be plain data" );
+      std::vector<std::string> keys;
+      std::vector<char> recs( m.size() * sizeof(R) );
+      size_t i = 0;
+      for ( const auto& it : m ){
+	keys.push_back( it.first );
+	memcpy( &recs[i*sizeof(R)], &it.second, sizeof(R) );
+	++i;
+      }
+      add_raw( name, keys, recs, sizeof(R), src );
+    };
+    void add_set( const std::string&,
+		  const std::set<std::string>&,
+		  const sourceInfo& );
+    void image( std::vector<uint64_t>& ) const;
+  private:
+    void add_raw( const std::string&,
+		  const std::vector<std::string>&,
+		  const std::vector<char>&,
+		  size_t,
+		  const sourceInfo& );
+    struct table {
+      tableEntry entry;
+      std::vector<int32_t> seeds;
+      std::vector<slot> slots;
+      std::vector<char> records;
+    };
+    std::string pool;
+    std::map<std::string,uint32_t> pooled;
+    std::vector<table> tables;
+  };
+
+  class Image {
+  public:
+    Image();
+    ~Image();
+    bool load( const std::string&, std::string& );
+    void assign( const Builder& );
+    bool save( const std::string& ) const;
+    bool empty() const { return base == 0; };
+    const tableEntry *entry( const std::string& ) const;
+    bool is_current( const std::string&, const sourceInfo& ) const;
+    const char *str( uint32_t ) const;
+    template <typename R>
+      bool table( const std::string& name, Table<R>& t ) const {
+      const tableEntry *e = entry( name );
+      if ( !e || e->record_size != sizeof(R) ){
+	return false;
+      }
+      t = Table<R>( rawTable( base, *e ) );
+      return true;
+    };
+    size_t size() const { return _size; };
+  private:
+    Image( const Image& ); // no copies
+    Image& operator=( const Image& );
+    void clear();
+    bool valid() const;
+    const char *base;
+    size_t _size;
+    bool mapped;
+    std::vector<uint64_t> heap;
+  };
+
+}
+
+#endif // LEXICON_H
@@ -0,0 +1,86 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PHRASES_H
+#define PHRASES_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Multi-word expressions, compiled into one trie over token numbers.
+//
+// Every phrase is added for one form of the words (the text, the lowercased
+// text or the lemma) with a set of category bits. Matching a sentence walks
+// the trie once from every word, for each form, and reports every phrase
+// found with its categories. Which of the matches count, and in which order,
+// is left to the caller.
+
+class PhraseMatches;
+
+class Phrases {
+ public:
+  enum Form { TEXT, LTEXT, LEMMA, FORMS };
+  Phrases();
+  void clear();
+  // adds a phrase of at least two space separated words
+  void add( Form, const std::string&, uint32_t );
+  size_t size() const { return phrases; };
+  // the (approximate) memory used by the trie
+  size_t heap_size() const;
+  // finds all phrases in a sentence. 'words[f][i]' is form 'f' of word 'i'
+  void match( const std::vector<std::string> (&)[FORMS],
+	      PhraseMatches& ) const;
+ private:
+  static const uint32_t NONE = UINT32_MAX;
+  uint32_t token( const std::string& ) const;
+  uint32_t next( uint32_t, uint32_t ) const;
+  struct node {
+    node() { for ( int f=0; f < FORMS; ++f ) categories[f] = 0; };
+    uint32_t categories[FORMS]; // the phrases ending here, per form
+  };
+  std::unordered_map<std::string,uint32_t> tokens;
+  std::unordered_map<uint64_t,uint32_t> edges; // (node,token) -> node
+  std::vector<node> nodes; // nodes[0] is the root
+  size_t phrases;
+};
+
+// The phrases found in one sentence.
+class PhraseMatches {
+ public:
+  // the categories of the phrase of 'length' words starting at word
+  // 'start', 0 when there is none
+  uint32_t at( size_t, size_t ) const;
+  // adds the matches of another set of phrases in the same sentence
+  void merge( const PhraseMatches& );
+ private:
+  friend class Phrases;
+  struct match {
+    uint32_t length;
+    uint32_t categories;
+  };
+  std::vector<match> matches; // ordered on the first word
+  std::vector<size_t> first;  // per word, its first entry in matches
+};
+
+#endif // PHRASES_H
@@ -0,0 +1,290 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include "ticcutils/Configuration.h"
+#include "tscan/cgn.h"
+#include "tscan/sem.h"
+#include "tscan/intensify.h"
+#include "tscan/general.h"
+#include "tscan/afk.h"
+#include "tscan/adverb.h"
+#include "tscan/stats.h"
+#include "tscan/lexicon.h"
+#include "tscan/phrases.h"
+#include "tscan/features.h"
+
+struct cf_data {
+  long int count;
+  double freq;
+};
+
+struct prevalence {
+  double percentage;
+  double zscore;
+};
+
+// the lexicon records for nouns and for the self-defined classification
+// hold their strings in the string pool of the lexicon
+struct noun_entry {
+  SEM::Type type;
+  bool is_compound;
+  int compound_parts;
+  uint32_t head;
+  uint32_t satellite_clean;
+};
+
+struct classification_entry {
+  CGN::Type tag;
+  uint32_t classification;
+};
+
+// a set of CGN tags, one bit per CGN::Type
+typedef uint32_t tag_mask;
+
+inline tag_mask tag_bit( CGN::Type tag ){
+  return 1u << tag;
+}
+
+// Everything the lexicons know about one string, so analysing a word takes
+// one lookup per form (word, lemma, ...) instead of one per lexicon.
+// 'fields' tells which of the lexicons hold the string.
+enum word_field {
+  ADJ_SEM = 1<<0,
+  VERB_SEM = 1<<1,
+  NOUN_SEM = 1<<2,
+  INTENSIFY = 1<<3,
+  GENERAL_NOUN = 1<<4,
+  GENERAL_VERB = 1<<5,
+  ADVERB = 1<<6,
+  STAPH_FREQ = 1<<7,
+  WORD_FREQ = 1<<8,
+  LEMMA_FREQ = 1<<9,
+  TOP_FREQ = 1<<10,
+  PREVALENCE = 1<<11,
+  AFK = 1<<12,
+  CLASSIFICATION = 1<<13
+};
+
+// the connectives and situations, in the order they are checked
+enum conn_list { TEMPORALS, OPSOMMERS_WG, OPSOMMERS_ZIN,
+		 CONTRAST, COMPARS, CAUSALS, CONN_LISTS };
+enum sit_list { TIME_SITS, CAUSAL_SITS, SPACE_SITS, EMOTION_SITS,
+		SIT_LISTS };
+
+// the categories of the multi-word expressions in settingData::phrases
+enum phrase_category {
+  MULTI_CONN = 1<<0,                         // one bit per conn_list
+  NEG_LONG = 1<<CONN_LISTS,                  // "met uitzondering van"
+  MULTI_SIT = 1<<(CONN_LISTS+1),             // one bit per sit_list
+  MULTI_INTENSIFY = 1<<(CONN_LISTS+SIT_LISTS+1),
+  PREP_EXPR = 1<<(CONN_LISTS+SIT_LISTS+2),
+  MULTI_AFK = 1<<(CONN_LISTS+SIT_LISTS+3)
+};
+
+inline uint32_t conn_phrase( conn_list l ){
+  return MULTI_CONN << l;
+}
+
+inline uint32_t sit_phrase( sit_list l ){
+  return MULTI_SIT << l;
+}
+
+struct word_entry {
+  bool has( word_field f ) const { return (fields & f) != 0; };
+  uint32_t fields;
+  tag_mask connectives[CONN_LISTS];
+  tag_mask situations[SIT_LISTS];
+  tag_mask stop;
+  SEM::Type adj_sem;
+  SEM::Type verb_sem;
+  noun_entry noun;
+  Intensify::Type intensify;
+  General::Type general_noun;
+  General::Type general_verb;
+  Adverb::adverb adverb;
+  top_val top_freq;
+  Afk::Type afk;
+  classification_entry classification;
+  cf_data staph_freq;
+  cf_data word_freq;
+  cf_data lemma_freq;
+  prevalence prev;
+};
+
+inline bool has( const word_entry *e, word_field f ){
+  return e && e->has( f );
+}
+
+inline bool tagged( tag_mask mask, CGN::Type tag ){
+  // listed for 'tag' or without a tag
+  return ( mask & ( tag_bit( tag ) | tag_bit( CGN::UNASS ) ) ) != 0;
+}
+
+// the entries for the forms of one word (0 when not in any lexicon)
+struct word_lexicon {
+  const word_entry *word;
+  const word_entry *l_word;
+  const word_entry *lemma;
+  const word_entry *l_lemma;
+  const word_entry *full_lemma;
+};
+
+struct settingData {
+  void init( const TiCC::Configuration&, bool = true );
+  // (re)reads only the lexicons. false when one of them can't be read
+  bool load_lexicons( const TiCC::Configuration&, bool = true );
+  // the memory of the lexicons: read from text files, or mapped from the
+  // bundle (which is shared with other processes)
+  size_t heap_size() const;
+  size_t mapped_size() const { return compiled.size(); };
+  bool save_lexicons( const std::string& ) const;
+  bool doAlpino;
+  bool doAlpinoServer;
+  bool doFrogSyntax;
+  unsigned int alpinoSplit;
+  std::string alpinoDump;
+  bool doWopr;
+  bool doXfiles;
+  bool showProblems;
+  bool sentencePerLine;
+  std::string style;
+  int rarityLevel;
+  unsigned int overlapSize;
+  size_t featureMemo; // remember the word_features of this many types
+  double freq_clip;
+  double mtld_threshold;
+  Lexicon::Table<SEM::Type> adj_sem;
+  Lexicon::Table<noun_entry> noun_sem;
+  Lexicon::Table<SEM::Type> verb_sem;
+  Lexicon::Table<Intensify::Type> intensify;
+  Lexicon::Table<General::Type> general_nouns;
+  Lexicon::Table<General::Type> general_verbs;
+  Lexicon::Table<Adverb::adverb> adverbs;
+  Lexicon::Table<cf_data> staph_word_freq_lex;
+  long int staph_total;
+  Lexicon::Table<cf_data> word_freq_lex;
+  long int word_total;
+  Lexicon::Table<cf_data> lemma_freq_lex;
+  long int lemma_total;
+  Lexicon::Table<top_val> top_freq_lex;
+  Lexicon::Table<tag_mask> temporals1;
+  Lexicon::Table<uint8_t> multi_temporals;
+  Lexicon::Table<tag_mask> causals1;
+  Lexicon::Table<uint8_t> multi_causals;
+  Lexicon::Table<tag_mask> opsommers_wg;
+  Lexicon::Table<uint8_t> multi_opsommers_wg;
+  Lexicon::Table<tag_mask> opsommers_zin;
+  Lexicon::Table<uint8_t> multi_opsommers_zin;
+  Lexicon::Table<tag_mask> contrast1;
+  Lexicon::Table<uint8_t> multi_contrast;
+  Lexicon::Table<tag_mask> compars1;
+  Lexicon::Table<uint8_t> multi_compars;
+  Lexicon::Table<tag_mask> causal_sits;
+  Lexicon::Table<uint8_t> multi_causal_sits;
+  Lexicon::Table<tag_mask> space_sits;
+  Lexicon::Table<uint8_t> multi_space_sits;
+  Lexicon::Table<tag_mask> time_sits;
+  Lexicon::Table<uint8_t> multi_time_sits;
+  Lexicon::Table<tag_mask> emotion_sits;
+  Lexicon::Table<uint8_t> multi_emotion_sits;
+  Lexicon::Table<uint8_t> vzexpr2;
+  Lexicon::Table<uint8_t> vzexpr3;
+  Lexicon::Table<uint8_t> vzexpr4;
+  Lexicon::Table<Afk::Type> afkos;
+  Lexicon::Table<prevalence> prevalences;
+  Lexicon::Table<tag_mask> stop_lemmata;
+  Lexicon::Table<classification_entry> my_classification;
+  Lexicon::Table<word_entry> words; // the above, except the multi-word lists
+  Phrases phrases; // the multi-word lists, see phrase_category
+ private:
+  void bind_tables();
+  void build_phrases();
+  std::string word_table_signature() const;
+  void fuse( Lexicon::Builder&, const Lexicon::sourceInfo& ) const;
+  bool use_compiled( const std::vector<std::string>&,
+		     const Lexicon::sourceInfo& );
+  template <typename R>
+    void bind( const std::string&, Lexicon::Table<R>& ) const;
+  long int table_total( const std::string& ) const;
+  Lexicon::Image compiled;  // the mmap-ed lexicon bundle, if any
+  Lexicon::Image loaded;    // tables read from the text lexicons
+  std::set<std::string> from_compiled;
+};
+
+extern settingData settings;
+
+// The lexicons are used by the jobs as a reference counted snapshot. A
+// reload builds a new snapshot next to the current one and swaps it in;
+// jobs that already started keep theirs until they are done. Only the
+// lexicons of a snapshot are used: the options (useAlpino etc.) are those
+// of 'settings', which is the first snapshot.
+typedef std::shared_ptr<const settingData> lexicon_snapshot;
+
+// A per-job layer over the shared word lexicons. Custom word lists (e.g.
+// uploaded to the webservice) add entries or override the shared ones,
+// without copying or reloading the shared tables: only the words on the
+// custom lists are stored here. It keeps its snapshot alive.
+class LexiconOverlay {
+ public:
+  explicit LexiconOverlay( const lexicon_snapshot& s ):
+    base( s ), memo( settings.featureMemo ){};
+  // a layer on top of 'below': starts with its lists, on its snapshot
+  explicit LexiconOverlay( const LexiconOverlay* );
+  const lexicon_snapshot& snapshot() const { return base; };
+  const settingData& lexicons() const { return *base; };
+  // true for the word lists that can be layered
+  static bool is_list( const std::string& );
+  // adds the word list 'file' as list 'name' (e.g. "noun_semtypes")
+  bool read( const std::string&, const std::string& );
+  // the same, with the list read from a stream
+  bool read( const std::string&, std::istream& );
+  bool empty() const { return entries.empty(); };
+  // the entry in this layer, or else the shared one (0 when not found)
+  const word_entry *find( const std::string& ) const;
+  std::string str( uint32_t ) const;
+  // the multi-word expressions of the custom lists
+  const Phrases& phrases() const { return multi; };
+  // the features of the word types analysed with these lexicons
+  FeatureMemo& features() const { return memo; };
+ private:
+  word_entry& entry( const std::string& );
+  uint32_t add_string( const std::string& );
+  lexicon_snapshot base;
+  std::map<std::string,word_entry> entries;
+  std::vector<std::string> strings;
+  Phrases multi;
+  mutable FeatureMemo memo;
+};
+
+bool tagged_lookup( const Lexicon::Table<tag_mask>&,
+		    CGN::Type,
+		    const std::string& );
+
+#endif // SETTINGS_H
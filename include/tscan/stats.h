@@ -9,6 +9,7 @@
 #include "ticcutils/XMLtools.h"
 #include "libfolia/folia.h"
 #include "tscan/Alpino.h"
+#include "tscan/AlpinoClient.h"
 #include "tscan/cgn.h"
 #include "tscan/sem.h"
 #include "tscan/intensify.h"
@@ -19,12 +20,21 @@
 #include "tscan/adverb.h"
 #include "tscan/ner.h"
 #include "tscan/utils.h"
+#include "tscan/phrases.h"
 
 struct sentStats; // Forward declaration
 struct wordStats; // Forward declaration
+struct word_entry; // Forward declaration
+struct word_lexicon; // Forward declaration
+struct word_features; // Forward declaration
+class LexiconOverlay; // Forward declaration
+class WoprBatch; // Forward declaration
+struct AlpinoTreeStats; // Forward declaration
 
 enum top_val { top1000, top2000, top3000, top5000, top10000, top20000, notFound };
 enum csvKind { DOC_CSV, PAR_CSV, SENT_CSV, WORD_CSV };
+const std::string csv_extension( csvKind );
+const std::string csv_label( csvKind );
 
 struct basicStats {
   basicStats( int pos, folia::FoliaElement* el, const std::string& cat ):
@@ -106,7 +116,8 @@ struct basicStats {
 
 
 struct wordStats : public basicStats {
-  wordStats( int, folia::Word*, const xmlNode*, const std::set<size_t>&, bool );
+  wordStats( int, folia::Word*, const AlpinoTree*, int,
+	     const PunctuationIndex&, bool, const LexiconOverlay* );
   void CSVheader( std::ostream&, const std::string& ) const;
   void wordDifficultiesHeader( std::ostream& ) const;
   void wordDifficultiesToCSV( std::ostream& ) const;
@@ -148,26 +159,29 @@ struct wordStats : public basicStats {
   Situation::Type getSitType() const { return sitType; };
   void addMetrics() const;
   bool checkContent( bool ) const;
-  Conn::Type checkConnective() const;
-  Situation::Type checkSituation() const;
-  bool checkNominal( const xmlNode* ) const;
+  Conn::Type checkConnective( const word_lexicon& ) const;
+  Situation::Type checkSituation( const word_lexicon& ) const;
+  bool checkNominal( const AlpinoTree&, int ) const;
   void setCGNProps( const folia::PosAnnotation* );
   CGN::Prop wordProperty() const { return prop; };
-  void checkNoun();
-  SEM::Type checkSemProps() const;
-  Intensify::Type checkIntensify(const xmlNode*) const;
-  General::Type checkGeneralNoun() const;
-  General::Type checkGeneralVerb() const;
-  Afk::Type checkAfk() const;
-  std::string checkMyClassification() const;
-  bool checkStoplist() const;
+  word_lexicon lexiconLookup() const;
+  void lookupFeatures( word_features& );
+  void setFeatures( const word_features& );
+  void checkNoun( const word_lexicon& );
+  SEM::Type checkSemProps( const word_lexicon& );
+  Intensify::Type checkIntensify( const word_lexicon& ) const;
+  General::Type checkGeneralNoun( const word_lexicon& ) const;
+  General::Type checkGeneralVerb( const word_lexicon& ) const;
+  Afk::Type checkAfk( const word_lexicon& ) const;
+  std::string checkMyClassification( const word_lexicon& ) const;
+  bool checkStoplist( const word_lexicon& ) const;
   bool checkPropNeg() const;
   bool checkMorphNeg() const;
-  void prevalenceLookup();
-  void staphFreqLookup();
-  top_val topFreqLookup(const std::string&) const;
-  int wordFreqLookup(const std::string&) const;
-  void freqLookup();
+  void prevalenceLookup( const word_lexicon& );
+  void staphFreqLookup( const word_lexicon& );
+  top_val topFreqLookup( const word_entry* ) const;
+  int wordFreqLookup( const word_entry* ) const;
+  void freqLookup( const word_lexicon&, word_features& ) const;
   void getSentenceOverlap( const std::vector<std::string>&, const std::vector<std::string>& );
   bool isOverlapCandidate() const;
   std::vector<const wordStats*> collectWords() const;
@@ -236,6 +250,8 @@ struct wordStats : public basicStats {
   std::string compstr;
   bool on_stoplist;
   std::string my_classification;
+  const LexiconOverlay *overlay; // the lexicons of the job
+  std::vector<std::string> problems; // for the problems file
 };
 
 
@@ -246,6 +262,8 @@ struct structStats: public basicStats {
     wordInclCnt(0), // wordCnt including stopwords
     sentCnt(0),
     parseFailCnt(0),
+    parseSplitCnt(0),
+    frogSyntaxCnt(0),
     vdBvCnt(0),
     vdNwCnt(0),
     vdVrijCnt(0),
@@ -561,6 +579,8 @@ struct structStats: public basicStats {
   void intensToCSV( std::ostream& ) const;
   void miscHeader( std::ostream& ) const;
   void miscToCSV( std::ostream& ) const;
+  virtual void scheduleHeader( std::ostream& ) const {};
+  virtual void scheduleToCSV( std::ostream& ) const {};
   void CSVheader( std::ostream&, const std::string& ) const;
   void toCSV( std::ostream& ) const;
   void merge( structStats* );
@@ -579,6 +599,8 @@ struct structStats: public basicStats {
   int wordInclCnt;
   int sentCnt;
   int parseFailCnt;
+  int parseSplitCnt;
+  int frogSyntaxCnt;
   int vdBvCnt;
   int vdNwCnt;
   int vdVrijCnt;
@@ -890,46 +912,51 @@ struct structStats: public basicStats {
 
 
 struct sentStats : public structStats {
-  sentStats( int, folia::Sentence*, const sentStats* );
+  sentStats( int, folia::Sentence*, AlpinoBatch*, size_t,
+	     WoprBatch*, size_t, const LexiconOverlay* );
   bool isSentence() const { return true; };
-  void resolveConnectives();
-  void resolveSituations();
-  void resolveMultiWordIntensify();
-  void resolveMultiWordAfks();
+  void resolveOverlap( const sentStats* );
+  void resolveConnectives( const PhraseMatches& );
+  void resolveSituations( const PhraseMatches& );
+  void resolveMultiWordIntensify( const PhraseMatches& );
+  void resolveMultiWordAfks( const PhraseMatches& );
   void addMetrics() const;
   bool checkAls( size_t );
   double getMeanAL() const;
   double getHighestAL() const;
-  Conn::Type checkMultiConnectives( const std::string& );
-  Situation::Type checkMultiSituations( const std::string& );
-  void resolvePrepExpr();
-  void resolveAdverbials( xmlDoc* );
-  void resolveRelativeClauses( xmlDoc* );
-  void resolveFiniteVerbs( xmlDoc* );
-  void resolveConjunctions( xmlDoc* );
-  void resolveSmallConjunctions( xmlDoc* );
+  Conn::Type checkMultiConnectives( uint32_t );
+  Situation::Type checkMultiSituations( uint32_t );
+  void resolvePrepExpr( const PhraseMatches& );
+  void resolveTreeStats( const AlpinoTreeStats& );
+  void resolveAdverbials( const AlpinoTreeStats& );
   void setCommonCounts( wordStats* );
+  const LexiconOverlay *overlay; // the lexicons of the job
 };
 
 
 struct parStats: public structStats {
-  parStats( int, folia::Paragraph* );
+  parStats( int, folia::Paragraph*, const std::vector<sentStats*>& );
   void addMetrics() const;
 };
 
 
 struct docStats : public structStats {
-  docStats( folia::Document* );
+  docStats( folia::Document*, AlpinoBatch*, const LexiconOverlay* );
   bool isDocument() const { return true; };
   void toCSV( const std::string&, csvKind ) const;
+  void toCSV( std::ostream&, const std::string&, csvKind ) const;
   double rarity( int level ) const;
   void addMetrics() const;
+  void scheduleHeader( std::ostream& ) const;
+  void scheduleToCSV( std::ostream& ) const;
   int word_overlapCnt() const { return doc_word_overlapCnt; };
   int lemma_overlapCnt() const { return doc_lemma_overlapCnt; };
   void calculate_doc_overlap();
   int doc_word_overlapCnt;
   int doc_lemma_overlapCnt;
   double rarity_index;
+  bool alpino_scheduled; // the sentences were sent to Alpino servers
+  AlpinoSchedule alpino_schedule;
 };
 
 #endif /* STATS_H */
@@ -20,6 +20,7 @@
 
 */
 
+#include <stdexcept>
 #include "tscan/Alpino.h"
 #include "ticcutils/Unicode.h"
 
@@ -66,36 +67,20 @@ void aggregate( multimap<DD_type,int>& out, const multimap<DD_type,int>& in ) {
   }
 }
 
-xmlNode *getAlpNodeWord( xmlDoc *doc, const folia::Word *w ){
-  // search the XML node that matches the FoLiA word w
+int getAlpNodeWord( const AlpinoTree& tree, const folia::Word *w ){
+  // search the node that matches the FoLiA word w
   string id = w->id();
   string::size_type ppos = id.find_last_of( '.' );
   string posS = id.substr( ppos + 1 );
   if ( posS.empty() ){
     cerr << "unable to extract a word index from " << id << endl;
-    return 0;
-  }
-  else {
-    list<xmlNode*> nodelist = TiCC::FindNodes( doc, "//node" );
-    list<xmlNode*>::const_iterator it = nodelist.begin();
-    while ( it != nodelist.end() ) {
-      xmlNode *pnt = *it;
-      folia::KWargs atts = folia::getAttributes( pnt );
-      string epos = atts["end"];
-      if ( epos == posS ){
-  string bpos = atts["begin"];
-  int start = TiCC::stringTo<int>( bpos );
-  int finish = TiCC::stringTo<int>( epos );
-  //  cerr << "begin = " << start << ", end=" << finish << endl;
-  if ( start + 1 == finish ){
-    // the node must exactly be 1 long
-    return pnt;
+    return -1;
   }
-      }
-      ++it;
-    }
-    return 0;
+  size_t pos;
+  if ( !TiCC::stringTo( posS, pos ) ){
+    return -1;
   }
+  return tree.word_node( pos );
 }
 
 vector< xmlNode*> getSibblings( const xmlNode *node ){
@@ -139,61 +124,6 @@ xmlNode *node_search( const xmlNode* node,
   return 0;
 }
 
-xmlNode *node_search( const xmlNode* node,
-          const string& att,
-          const set<string>& values ){
-  // resursively search for a node with an att that has one of the values
-  xmlNode *pnt = node->children;
-  while ( pnt ){
-    // breath first search
-    if ( pnt->type == XML_ELEMENT_NODE ){
-      string aval = TiCC::getAttribute( pnt, att );
-      if ( values.find( aval ) != values.end() )
-  return pnt;
-    }
-    pnt = pnt->next;;
-  }
-  // no luck, so get down the non-root nodes
-  pnt = node->children;
-  while ( pnt ){
-    if ( pnt->type == XML_ELEMENT_NODE ){
-      if ( TiCC::getAttribute( pnt, "root" ) == "" ){
-  xmlNode *tmp = node_search( pnt, att, values );
-  if ( tmp )
-    return tmp;
-      }
-    }
-    pnt = pnt->next;;
-  }
-  return 0;
-}
-
-void get_index_nodes( const xmlNode* node, vector<xmlNode*>& result ){
-  // recursively search for nodes with the 'index' attribute
-  xmlNode *pnt = node->children;
-  while ( pnt ){
-    if ( pnt->type == XML_ELEMENT_NODE ){
-      folia::KWargs atts = folia::getAttributes( pnt );
-      if ( atts["index"] != "" &&
-     !(atts["pos"] == "" && atts["cat"] == "" ) ){
-  result.push_back( pnt );
-      }
-      else if ( atts["root"] == "" ){
-  get_index_nodes( pnt, result );
-      }
-    }
-    pnt = pnt->next;;
-  }
-}
-
-vector<xmlNode *> getIndexNodes( xmlDoc *doc ){
-  // search for nodes with the 'index' attribute
-  xmlNode *pnt = xmlDocGetRootElement( doc );
-  vector<xmlNode*> result;
-  get_index_nodes( pnt->children, result );
-  return result;
-}
-
 
 const string modalA[] = { "kunnen", "moeten", "hoeven", "behoeven", "mogen",
         "willen", "blijken", "lijken", "schijnen", "heten" };
@@ -266,347 +196,264 @@ string toString( const DD_type& t ){
   return result;
 }
 
-int get_begin( const xmlNode *n ){
-  string bpos = TiCC::getAttribute( n, "begin" );
-  return TiCC::stringTo<int>( bpos );
+PunctuationIndex::PunctuationIndex( const vector<bool>& is_punct ):
+  before( is_punct.size() + 1, 0 )
+{
+  for ( size_t i=0; i < is_punct.size(); ++i ){
+    before[i+1] = before[i] + is_punct[i];
+  }
+}
+
+int PunctuationIndex::count( int from, int to ) const {
+  // the number of punctuation marks at the positions from up to and
+  // including to
+  int last = before.size() - 2;
+  if ( from < 0 ) from = 0;
+  if ( to > last ) to = last;
+  if ( from > to ){
+    return 0;
+  }
+  return before[to+1] - before[from];
 }
 
 void store_result( multimap<DD_type,int>& result, DD_type type,
-       const xmlNode *n1, const xmlNode*n2,
-       const set<size_t>& puncts ){
+		   const AlpinoTree& tree, int n1, int n2,
+		   const PunctuationIndex& puncts ){
   // store distances per type. Compensate for skipped punctuation
-  int pos1 = get_begin( n1 );
-  int pos2 = get_begin( n2 );
+  int pos1 = tree[n1].begin;
+  int pos2 = tree[n2].begin;
   if ( pos1 > pos2 )
     swap( pos1, pos2 );
-  int dist = pos2-pos1-1;
-  for ( int i=pos1; i <= pos2; ++i )
-    if ( puncts.find( i ) != puncts.end() ){
-      //      cerr << "lower the dist, because of a punctuation" << endl;
-      --dist;
-    }
+  int dist = pos2-pos1-1 - puncts.count( pos1, pos2 );
   //  cerr << "store " << type << "(" << pos1 << "," << pos2 << ")=" << dist << endl;
   if ( dist >= 0 ){
     result.insert( make_pair( type, dist ) );
   }
 }
 
-multimap<DD_type, int> getDependencyDist( const xmlNode *head_node,
-            const set<size_t>& puncts ){
-  // walk down the Alpino tree and gather all types of distances
-  multimap<DD_type,int> result;
-  if ( head_node ){
-    folia::KWargs atts = folia::getAttributes( head_node );
-    string head_rel = atts["rel"];
-    string head_pos = atts["pos"];
-    if ( head_rel == "hd" && head_pos == "verb" ){
-      vector< xmlNode *> head_siblings = getSibblings( head_node );
-      for ( vector< xmlNode *>::const_iterator it=head_siblings.begin();
-      it != head_siblings.end();
-      ++it ){
-  folia::KWargs args = folia::getAttributes( *it );
-  //  cerr << "bekijk " << args << endl;
-  if ( args["rel"] == "su" || args["rel"] == "sup" ){
-    if ( !(*it)->children ){
-      //      cerr << "geval 1 " << endl;
-      xmlNode *target = *it;
-      if ( args["index"] != "" &&
-     args["pos"] == "" && args["cat"] == "" ){
-        //        cerr << "geval 2 " << endl;
-        vector<xmlNode*> inodes = getIndexNodes( head_node->doc );
-        for ( size_t i=0; i < inodes.size(); ++i ){
-    folia::KWargs iatts = folia::getAttributes(inodes[i]);
-    if ( iatts["index"] == args["index"] ){
-      target = inodes[i];
-      break;
-    }
-        }
-        if ( target->children ){
-    xmlNode *res = node_search( target , "rel", "cnj" );
-    if ( res ){
-      //      cerr << "geval 3 " << endl;
-      string root = TiCC::getAttribute( res, "root" );
-      if ( !root.empty() ){
-        //        cerr << "geval 3A " << endl;
-        target = res;
+static int argument_node( const AlpinoTree& tree, int arg ){
+  // the node to measure to for a one word subject or object of a verb.
+  // For a trace that is its antecedent, or the conjunct or head of it
+  int target = arg;
+  const AlpinoNode& n = tree[arg];
+  if ( n.index >= 0 && n.pos == AlpPos::NONE && n.cat == AlpCat::NONE ){
+    int ante = tree.antecedent( n.index );
+    if ( ante >= 0 ){
+      target = ante;
+    }
+    if ( tree[target].first_child >= 0 ){
+      int res = tree.search( target, AlpRel::CNJ );
+      if ( res >= 0 ){
+	if ( tree.has( tree[res].root ) ){
+	  target = res;
+	}
       }
-    }
-    else {
-      //      cerr << "geval 4 " << endl;
-      xmlNode *res = node_search( target , "rel", "hd" );
-      if ( res ){
-        //        cerr << "geval 4A " << endl;
-        target = res;
-      }
-    }
-        }
-      }
-      store_result( result, SUB_VERB, head_node, target, puncts );
-    }
-    else {
-      //      cerr << "geval 6 " << endl;
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, SUB_VERB, head_node, res, puncts );
-      }
-      res = node_search( *it, "rel", "cnj" );
-      if ( res ){
-        store_result( result, SUB_VERB, head_node, res, puncts );
+      else {
+	res = tree.search( target, AlpRel::HD );
+	if ( res >= 0 ){
+	  target = res;
+	}
       }
     }
   }
-  else if ( args["rel"] == "obj1" ){
-    if ( !(*it)->children ){
-      xmlNode *target = *it;
-      if ( args["index"] != "" &&
-     args["pos"] == "" && args["cat"] == "" ){
-        vector<xmlNode*> inodes = getIndexNodes( head_node->doc );
-        for ( size_t i=0; i < inodes.size(); ++i ){
-    string myindex = TiCC::getAttribute( inodes[i], "index" );
-    if ( args["index"] == myindex ){
-      target = inodes[i];
-      break;
-    }
-        }
-        if ( target->children ){
-    xmlNode *res = node_search( target , "rel", "cnj" );
-    if ( res ){
-      string root = TiCC::getAttribute( res, "root" );
-      if ( !root.empty() ){
-        target = res;
-      }
-    }
-    else {
-      xmlNode *res = node_search( target , "rel", "hd" );
-      if ( res ){
-        target = res;
-      }
-    }
-        }
-      }
-      store_result( result, OBJ1_VERB, head_node, target, puncts );
-    }
-    else {
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, OBJ1_VERB, head_node, res, puncts );
-      }
-      res = node_search( *it, "rel", "cnj" );
-      if ( res ){
-        store_result( result, OBJ1_VERB, head_node, res, puncts );
-      }
-    }
+  return target;
+}
+
+static void store_argument( multimap<DD_type,int>& result, DD_type type,
+			    const AlpinoTree& tree, int head, int arg,
+			    const PunctuationIndex& puncts ){
+  // store the distance between a verb and its subject or object
+  if ( tree[arg].first_child < 0 ){
+    store_result( result, type, tree, head, argument_node( tree, arg ),
+		  puncts );
   }
-  else if ( args["rel"] == "obj2" ){
-    if ( !(*it)->children ){
-      xmlNode *target = *it;
-      if ( args["index"] != "" &&
-     args["pos"] == "" && args["cat"] == "" ){
-        vector<xmlNode*> inodes = getIndexNodes( head_node->doc);
-        for ( size_t i=0; i < inodes.size(); ++i ){
-    string myindex = TiCC::getAttribute( inodes[i], "index" );
-    if ( args["index"] == myindex ){
-      target = inodes[i];
-      break;
-    }
-        }
-        if ( target->children ){
-    xmlNode *res = node_search( target , "rel", "cnj" );
-    if ( res ){
-      string root = TiCC::getAttribute( res, "root" );
-      if ( !root.empty() ){
-        target = res;
-      }
-    }
-    else {
-      xmlNode *res = node_search( target , "rel", "hd" );
-      if ( res ){
-        target = res;
-      }
-    }
-        }
-      }
-      store_result( result, OBJ2_VERB, head_node, target, puncts );
-    }
-    else {
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, OBJ2_VERB, head_node, res, puncts );
-      }
-      res = node_search( *it, "rel", "cnj" );
-      if ( res ){
-        store_result( result, OBJ2_VERB, head_node, res, puncts );
-      }
+  else {
+    int res = tree.search( arg, AlpRel::HD );
+    if ( res >= 0 ){
+      store_result( result, type, tree, head, res, puncts );
     }
-  }
-  else if ( args["rel"] == "vc" ){
-    xmlNode *res = node_search( *it, "rel", "hd" );
-    if ( res ){
-      store_result( result, VERB_VC, head_node, res, puncts );
+    res = tree.search( arg, AlpRel::CNJ );
+    if ( res >= 0 ){
+      store_result( result, type, tree, head, res, puncts );
     }
   }
-  else if ( args["rel"] == "svp" ){
-    if ( args["lcat"] == "part" )
-      store_result( result, VERB_SVP, head_node, *it, puncts );
+}
+
+multimap<DD_type, int> getDependencyDist( const AlpinoTree& tree, int head,
+					  const PunctuationIndex& puncts ){
+  // walk down the Alpino tree and gather all types of distances
+  multimap<DD_type,int> result;
+  if ( head < 0 || tree[head].parent < 0 ){
+    return result;
   }
-  else if ( args["rel"] == "predc" ){
-    if ( args["lcat"] == "np" ){
-      store_result( result, VERB_PREDC_N, head_node, *it, puncts );
-    }
-    else if ( args["lcat"] == "ap" ){
-      store_result( result, VERB_PREDC_A, head_node, *it, puncts );
-    }
-    xmlNode *res = node_search( *it, "rel", "hd" );
-    if ( res ){
-      string lcat = TiCC::getAttribute( res, "lcat" );
-      if ( lcat == "np" ){
-        store_result( result, VERB_PREDC_N, head_node, res, puncts );
+  const AlpinoNode& h = tree[head];
+  int first = tree[h.parent].first_child; // the siblings of head
+  if ( h.rel == AlpRel::HD && h.pos == AlpPos::VERB ){
+    for ( int s = first; s >= 0; s = tree[s].next ){
+      if ( s == head ){
+	continue;
       }
-      else if ( lcat == "ap" ){
-        store_result( result, VERB_PREDC_A, head_node, res, puncts );
+      const AlpinoNode& sib = tree[s];
+      if ( sib.rel == AlpRel::SU || sib.rel == AlpRel::SUP ){
+	store_argument( result, SUB_VERB, tree, head, s, puncts );
       }
-    }
-  }
-  else if ( args["rel"] == "mod" ){
-    if ( args["lcat"] == "advp" ){
-      store_result( result, VERB_MOD_BW, head_node, *it, puncts );
-    }
-    else if ( args["lcat"] == "ap" ){
-      store_result( result, VERB_MOD_A, head_node, *it, puncts );
-    }
-    else if ( args["lcat"] == "np" ){
-      store_result( result, VERB_NOUN, head_node, *it, puncts );
-    }
-    xmlNode *res = node_search( *it, "rel", "hd" );
-    if ( res ){
-      string lcat = TiCC::getAttribute( res, "lcat" );
-      if ( lcat == "advp" ){
-        store_result( result, VERB_MOD_BW, head_node, res, puncts );
+      else if ( sib.rel == AlpRel::OBJ1 ){
+	store_argument( result, OBJ1_VERB, tree, head, s, puncts );
       }
-      else if ( lcat == "ap" ){
-        store_result( result, VERB_MOD_A, head_node, res, puncts );
+      else if ( sib.rel == AlpRel::OBJ2 ){
+	store_argument( result, OBJ2_VERB, tree, head, s, puncts );
       }
-      else if ( lcat == "np" ){
-        store_result( result, VERB_NOUN, head_node, res, puncts );
+      else if ( sib.rel == AlpRel::VC ){
+	int res = tree.search( s, AlpRel::HD );
+	if ( res >= 0 ){
+	  store_result( result, VERB_VC, tree, head, res, puncts );
+	}
       }
-    }
-  }
-  if ( args["cat"] == "cp" ){
-    xmlNode *res = node_search( *it, "rel", "cmp" );
-    if ( res ){
-      store_result( result, VERB_COMP, head_node, res, puncts );
-    }
-  }
-  else if ( args["cat"] == "pp" ){
-    xmlNode *res = node_search( *it, "rel", "hd" );
-    if ( res ){
-      store_result( result, VERB_PP, head_node, res, puncts );
-    }
-  }
+      else if ( sib.rel == AlpRel::SVP ){
+	if ( sib.lcat == AlpCat::PART )
+	  store_result( result, VERB_SVP, tree, head, s, puncts );
       }
-    }
-    else if ( head_rel == "hd" && head_pos == "noun" &&
-        TiCC::getAttribute( head_node->parent, "cat" ) == "np" ){
-      vector< xmlNode *> head_siblings = getSibblings( head_node );
-      for ( vector< xmlNode *>::const_iterator it=head_siblings.begin();
-      it != head_siblings.end();
-      ++it ){
-  folia::KWargs args = folia::getAttributes( *it );
-  //  cerr << "bekijk " << args << endl;
-  if ( args["rel"] == "det" ){
-    if ( !(*it)->children ){
-      store_result( result, NOUN_DET, head_node, *it, puncts );
-    }
-    else {
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, NOUN_DET, head_node, res, puncts );
+      else if ( sib.rel == AlpRel::PREDC ){
+	if ( sib.lcat == AlpCat::NP ){
+	  store_result( result, VERB_PREDC_N, tree, head, s, puncts );
+	}
+	else if ( sib.lcat == AlpCat::AP ){
+	  store_result( result, VERB_PREDC_A, tree, head, s, puncts );
+	}
+	int res = tree.search( s, AlpRel::HD );
+	if ( res >= 0 ){
+	  if ( tree[res].lcat == AlpCat::NP ){
+	    store_result( result, VERB_PREDC_N, tree, head, res, puncts );
+	  }
+	  else if ( tree[res].lcat == AlpCat::AP ){
+	    store_result( result, VERB_PREDC_A, tree, head, res, puncts );
+	  }
+	}
       }
-      res = node_search( *it, "rel", "mpw" );
-      // determiners kunnen voor Alpino net als een onderwerp of lijdend
-      // voorwerp samengesteld zijn uit meerdere woorden...
-      // weet alleen even geen voorbeeld...
-      if ( res ){
-        string root = TiCC::getAttribute( *it, "root" );
-        if ( !root.empty() )
-    store_result( result, NOUN_DET, head_node, res, puncts );
+      else if ( sib.rel == AlpRel::MOD ){
+	if ( sib.lcat == AlpCat::ADVP ){
+	  store_result( result, VERB_MOD_BW, tree, head, s, puncts );
+	}
+	else if ( sib.lcat == AlpCat::AP ){
+	  store_result( result, VERB_MOD_A, tree, head, s, puncts );
+	}
+	else if ( sib.lcat == AlpCat::NP ){
+	  store_result( result, VERB_NOUN, tree, head, s, puncts );
+	}
+	int res = tree.search( s, AlpRel::HD );
+	if ( res >= 0 ){
+	  if ( tree[res].lcat == AlpCat::ADVP ){
+	    store_result( result, VERB_MOD_BW, tree, head, res, puncts );
+	  }
+	  else if ( tree[res].lcat == AlpCat::AP ){
+	    store_result( result, VERB_MOD_A, tree, head, res, puncts );
+	  }
+	  else if ( tree[res].lcat == AlpCat::NP ){
+	    store_result( result, VERB_NOUN, tree, head, res, puncts );
+	  }
+	}
+      }
+      if ( sib.cat == AlpCat::CP ){
+	int res = tree.search( s, AlpRel::CMP );
+	if ( res >= 0 ){
+	  store_result( result, VERB_COMP, tree, head, res, puncts );
+	}
+      }
+      else if ( sib.cat == AlpCat::PP ){
+	int res = tree.search( s, AlpRel::HD );
+	if ( res >= 0 ){
+	  store_result( result, VERB_PP, tree, head, res, puncts );
+	}
       }
     }
   }
-  if ( args["rel"] == "vc" ){
-    xmlNode *res = node_search( *it, "rel", "hd" );
-    if ( res ){
-      store_result( result, NOUN_VC, head_node, res, puncts );
-    }
-  }
+  else if ( h.rel == AlpRel::HD && h.pos == AlpPos::NOUN
+	    && tree.cat( h.parent ) == AlpCat::NP ){
+    for ( int s = first; s >= 0; s = tree[s].next ){
+      if ( s == head ){
+	continue;
       }
-    }
-    else if ( head_rel == "hd" && head_pos == "prep"
-        && TiCC::getAttribute( head_node->parent, "cat" ) == "pp" ){
-      vector< xmlNode *> head_siblings = getSibblings( head_node );
-      for ( vector< xmlNode *>::const_iterator it=head_siblings.begin();
-      it != head_siblings.end();
-      ++it ){
-  folia::KWargs args = folia::getAttributes( *it );
-  //  cerr << "bekijk " << args << endl;
-  if ( args["rel"] == "obj1" ){
-    if ( !(*it)->children ){
-      store_result( result, PREP_OBJ1, head_node, *it, puncts );
-    }
-    else {
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, PREP_OBJ1, head_node, res, puncts );
+      const AlpinoNode& sib = tree[s];
+      if ( sib.rel == AlpRel::DET ){
+	if ( sib.first_child < 0 ){
+	  store_result( result, NOUN_DET, tree, head, s, puncts );
+	}
+	else {
+	  int res = tree.search( s, AlpRel::HD );
+	  if ( res >= 0 ){
+	    store_result( result, NOUN_DET, tree, head, res, puncts );
+	  }
+	  // the DOM version also looked for multi word determiners here, but
+	  // under the misspelled label 'mpw', so it never found one
+	}
       }
-      res = node_search( *it, "rel", "cnj" );
-      if ( res ){
-        if ( TiCC::getAttribute( res, "root" ) != "" )
-    store_result( result, NOUN_DET, head_node, res, puncts );
+      if ( sib.rel == AlpRel::VC ){
+	int res = tree.search( s, AlpRel::HD );
+	if ( res >= 0 ){
+	  store_result( result, NOUN_VC, tree, head, res, puncts );
+	}
       }
     }
   }
+  else if ( h.rel == AlpRel::HD && h.pos == AlpPos::PREP
+	    && tree.cat( h.parent ) == AlpCat::PP ){
+    for ( int s = first; s >= 0; s = tree[s].next ){
+      if ( s == head ){
+	continue;
       }
-    }
-    else if ( head_rel == "crd" ){
-      vector< xmlNode *> head_siblings = getSibblings( head_node );
-      for ( vector< xmlNode *>::const_iterator it=head_siblings.begin();
-      it != head_siblings.end();
-      ++it ){
-  folia::KWargs args = folia::getAttributes( *it );
-  //  cerr << "bekijk " << args << endl;
-  if ( args["rel"] == "cnj" ){
-    if ( !(*it)->children ){
-      store_result( result, CRD_CNJ, head_node, *it, puncts );
-    }
-    else {
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, CRD_CNJ, head_node, res, puncts );
+      if ( tree[s].rel == AlpRel::OBJ1 ){
+	if ( tree[s].first_child < 0 ){
+	  store_result( result, PREP_OBJ1, tree, head, s, puncts );
+	}
+	else {
+	  int res = tree.search( s, AlpRel::HD );
+	  if ( res >= 0 ){
+	    store_result( result, PREP_OBJ1, tree, head, res, puncts );
+	  }
+	  res = tree.search( s, AlpRel::CNJ );
+	  if ( res >= 0 ){
+	    if ( tree.has( tree[res].root ) )
+	      store_result( result, NOUN_DET, tree, head, res, puncts );
+	  }
+	}
       }
     }
   }
+  else if ( h.rel == AlpRel::CRD ){
+    for ( int s = first; s >= 0; s = tree[s].next ){
+      if ( s == head ){
+	continue;
       }
-    }
-    else if ( head_rel == "cmp" &&
-        ( head_pos == "comp" || head_pos == "comparative" ) ){
-      string word = TiCC::getAttribute( head_node, "word" );
-      if ( word != "te" ){
-  vector< xmlNode *> head_siblings = getSibblings( head_node );
-  for ( vector< xmlNode *>::const_iterator it=head_siblings.begin();
-        it != head_siblings.end();
-        ++it ){
-    folia::KWargs args = folia::getAttributes( *it );
-    if ( args["rel"] == "body" ){
-      xmlNode *res = node_search( *it, "rel", "hd" );
-      if ( res ){
-        store_result( result, COMP_BODY, head_node, res, puncts );
-      }
-      res = node_search( *it, "rel", "cnj" );
-      if ( res ){
-        store_result( result, COMP_BODY, head_node, res, puncts );
+      if ( tree[s].rel == AlpRel::CNJ ){
+	if ( tree[s].first_child < 0 ){
+	  store_result( result, CRD_CNJ, tree, head, s, puncts );
+	}
+	else {
+	  int res = tree.search( s, AlpRel::HD );
+	  if ( res >= 0 ){
+	    store_result( result, CRD_CNJ, tree, head, res, puncts );
+	  }
+	}
       }
     }
   }
+  else if ( h.rel == AlpRel::CMP &&
+	    ( h.pos == AlpPos::COMP || h.pos == AlpPos::COMPARATIVE ) ){
+    if ( string( tree.str( h.word ) ) != "te" ){
+      for ( int s = first; s >= 0; s = tree[s].next ){
+	if ( s == head ){
+	  continue;
+	}
+	if ( tree[s].rel == AlpRel::BODY ){
+	  int res = tree.search( s, AlpRel::HD );
+	  if ( res >= 0 ){
+	    store_result( result, COMP_BODY, tree, head, res, puncts );
+	  }
+	  res = tree.search( s, AlpRel::CNJ );
+	  if ( res >= 0 ){
+	    store_result( result, COMP_BODY, tree, head, res, puncts );
+	  }
+	}
       }
     }
   }
@@ -637,51 +484,65 @@ string toString( const WWform& wf ){
 
 //#define WW_DEBUG
 
-WWform classifyVerb( const xmlNode *wnode, const string& lemma,
-         string& full_lemma ){
+static bool root_below( const AlpinoTree& tree, int node,
+			const set<string>& roots ){
+  // is there a node with one of these roots below node? Searched like
+  // node_search() does
+  for ( int c = tree[node].first_child; c >= 0; c = tree[c].next ){
+    if ( roots.find( tree.str( tree[c].root ) ) != roots.end() )
+      return true;
+  }
+  for ( int c = tree[node].first_child; c >= 0; c = tree[c].next ){
+    if ( !tree.has( tree[c].root ) && root_below( tree, c, roots ) )
+      return true;
+  }
+  return false;
+}
+
+WWform classifyVerb( const AlpinoTree& tree, int wnode, const string& lemma,
+		     string& full_lemma ){
   // classify a Verb.
   // also detect 'splits' like 'bel op' giving 'opbellen'
   full_lemma.clear();
-  if ( wnode ){
-    vector< xmlNode *> siblinglist = getSibblings( wnode );
+  if ( wnode >= 0 ){
+    // the siblings of wnode
+    int first = -1;
+    if ( tree[wnode].parent >= 0 ){
+      first = tree[tree[wnode].parent].first_child;
+    }
 #ifdef WW_DEBUG
     cerr << "classify VERB lemma=" << lemma << endl;
 #endif
     if ( lemma == "zijn" || lemma == "worden" ){
 #ifdef WW_DEBUG
       cerr << "passief? lemma=" << lemma << endl;
-      cerr << "attributes: " << folia::getAttributes( wnode ) << endl;
+      cerr << "sc=" << tree.str( tree[wnode].sc ) << endl;
 #endif
-      string sc = TiCC::getAttribute( wnode, "sc" );
-      if ( sc == "passive" ){
+      if ( string( tree.str( tree[wnode].sc ) ) == "passive" ){
 #ifdef WW_DEBUG
-  cerr << "sc=\"passive\" ==> resultaat = passiefww" << endl;
+	cerr << "sc=\"passive\" ==> resultaat = passiefww" << endl;
 #endif
-  return PASSIVE_VERB;
+	return PASSIVE_VERB;
       }
     }
     if ( koppels.find( lemma ) != koppels.end() ){
-      for ( size_t i=0; i < siblinglist.size(); ++i ){
-  folia::KWargs atts = folia::getAttributes( siblinglist[i] );
-  if ( atts["rel"] == "predc" ){
-    //    cerr << "resultaat = koppelww" << endl;
-    return COPULA;
-  }
+      for ( int s = first; s >= 0; s = tree[s].next ){
+	if ( s != wnode && tree[s].rel == AlpRel::PREDC ){
+	  //	  cerr << "resultaat = koppelww" << endl;
+	  return COPULA;
+	}
       }
     }
     if ( lemma == "schijnen" ){
-      for ( size_t i=0; i < siblinglist.size(); ++i ){
-  folia::KWargs atts = folia::getAttributes( siblinglist[i] );
-  if ( atts["rel"] == "su" ){
-    static string schijn_words[] = { "zon", "ster", "maan", "lamp", "licht" };
-    static set<string> sws( schijn_words, schijn_words+5 );
-    xmlNode *node = node_search( siblinglist[i],
-               "root", sws );
-    if ( node ){
-      //      cerr << "resultaat 1 = hoofdww" << endl;
-      return HEAD_VERB;
-    }
-  }
+      for ( int s = first; s >= 0; s = tree[s].next ){
+	if ( s != wnode && tree[s].rel == AlpRel::SU ){
+	  static string schijn_words[] = { "zon", "ster", "maan", "lamp", "licht" };
+	  static set<string> sws( schijn_words, schijn_words+5 );
+	  if ( root_below( tree, s, sws ) ){
+	    //	    cerr << "resultaat 1 = hoofdww" << endl;
+	    return HEAD_VERB;
+	  }
+	}
       }
     }
     if ( lemma == "zullen" ){
@@ -692,12 +553,12 @@ WWform classifyVerb( const xmlNode *wnode, const string& lemma,
       return MODAL_VERB;
     }
     if ( lemma == "hebben" ){
-      for ( size_t i=0; i < siblinglist.size(); ++i ){
-  folia::KWargs atts = folia::getAttributes( siblinglist[i] );
-  if ( atts["rel"] == "vc" && (atts["cat"] == "ppart" || atts["cat"] == "inf" ) ){
-    //    cerr << "resultaat = tijdww" << endl;
-    return TIME_VERB;
-  }
+      for ( int s = first; s >= 0; s = tree[s].next ){
+	if ( s != wnode && tree[s].rel == AlpRel::VC
+	     && ( tree[s].cat == AlpCat::PPART || tree[s].cat == AlpCat::INF ) ){
+	  //	  cerr << "resultaat = tijdww" << endl;
+	  return TIME_VERB;
+	}
       }
       //      cerr << "resultaat 2 = hoofdww" << endl;
       return HEAD_VERB;
@@ -707,14 +568,10 @@ WWform classifyVerb( const xmlNode *wnode, const string& lemma,
       return TIME_VERB;
     }
     //    cerr << "resultaat 3 = hoofdww" << endl;
-    for ( vector< xmlNode *>::const_iterator it=siblinglist.begin();
-    it != siblinglist.end();
-    ++it ){
-      folia::KWargs args = folia::getAttributes( *it );
-      if ( args["rel"] == "svp" ){
-  if ( args["lcat"] == "part" ){
-    full_lemma = args["word"] + lemma;
-  }
+    for ( int s = first; s >= 0; s = tree[s].next ){
+      if ( s != wnode && tree[s].rel == AlpRel::SVP
+	   && tree[s].lcat == AlpCat::PART ){
+	full_lemma = tree.str( tree[s].word ) + lemma;
       }
     }
     return HEAD_VERB;
@@ -725,43 +582,11 @@ WWform classifyVerb( const xmlNode *wnode, const string& lemma,
   }
 }
 
-int get_d_level( const folia::Sentence *s, xmlDoc *alp ){
-  // determine de d-level of a folia::Sentence
-  vector<folia::PosAnnotation*> poslist;
-  vector<folia::Word*> wordlist = s->words();
-  int pv_counter = 0;
-  int neven_counter = 0;
-  for ( size_t i=0; i < wordlist.size(); ++i ){
-    folia::Word *w = wordlist[i];
-    vector<folia::PosAnnotation*> posV = w->select<folia::PosAnnotation>("http://ilk.uvt.nl/folia/sets/frog-mbpos-cgn");
-    if ( posV.size() != 1 )
-      throw folia::ValueError( "word doesn't have POS tag info" );
-    folia::PosAnnotation *pa = posV[0];
-    string pos = pa->feat("head");
-    poslist.push_back( pa );
-    if ( pos == "WW" ){
-      //      cerr << "WW " << pa->xmlstring() << endl;
-      string wvorm = pa->feat("wvorm");
-      if( wvorm == "pv" )
-  ++pv_counter;
-      //      cerr << "pv_counter= " << pv_counter << endl;
-    }
-    if ( pos == "VG" ){
-      //      cerr << "VG " << pa->xmlstring() << endl;
-      string cp = pa->feat("conjtype");
-      if ( cp == "neven" )
-  ++neven_counter;
-      //      cerr << "neven_counter= " << neven_counter << endl;
-    }
-  }
-  if ( pv_counter - neven_counter > 2 ){
-    // op niveau 7 staan zinnen met meerdere bijzinnen, maar deelzinnen die
-    // in nevenschikking staan tellen hiervoor niet mee
-    return 7;
-  }
-
-  // < 7
-  list<xmlNode *> nodelist = TiCC::FindNodes( alp, "//node" );
+int tree_d_level( xmlDoc *alp ){
+  // the part of the d-level that follows from the Alpino tree alone:
+  // 6, 4, 3, 1 or 0
+  AlpinoQueries q( alp );
+  list<xmlNode *> nodelist = q.find( "//node" );
   list<xmlNode *>::const_iterator nit = nodelist.begin();
   while ( nit != nodelist.end() ){
     // we kijken of het om een level 6 zin gaat:
@@ -797,21 +622,6 @@ int get_d_level( const folia::Sentence *s, xmlDoc *alp ){
   }
 
   // < 6
-  for ( size_t i=0; i < poslist.size(); ++i ){
-    // we kijken of het om een level 5 zin gaat
-    // Zinnen met ondergeschikte bijzinnen
-    //     ("Pietje wilde naar huis, omdat het regende.")
-    string pos = poslist[i]->feat("head");
-    if ( pos == "VG" ){
-      string cp = poslist[i]->feat("conjtype");
-      if ( cp == "onder" ){
-  if ( poslist[i]->parent()->text() != "dat" )
-    return 5;
-      }
-    }
-  }
-
-  // < 5
   nit = nodelist.begin();
   while ( nit != nodelist.end() ){
     // we kijken of het om een level 4 zin gaat
@@ -900,21 +710,6 @@ int get_d_level( const folia::Sentence *s, xmlDoc *alp ){
   }
 
   // < 3
-  for ( size_t i=0; i < poslist.size(); ++i ){
-    // we kijken of het om een level 2 zin gaat
-    // zinnen met nevenschikkingen
-    // cerr << "bekijk " << poslist[i] << endl;
-    // cerr << "head=" << poslist[i]->feat("head") << endl;
-    // cerr << "head=" << poslist[i]->feat("headfeature") << endl;
-    string pos = poslist[i]->feat("head");
-    if ( pos == "VG" ){
-      string cp = poslist[i]->feat("conjtype");
-      if ( cp == "neven" )
-  return 2;
-    }
-  }
-
-  // < 2
   nit = nodelist.begin();
   while ( nit != nodelist.end() ){
     // we kijken of het om een level 1 zin gaat
@@ -949,49 +744,133 @@ int get_d_level( const folia::Sentence *s, xmlDoc *alp ){
     ++nit;
   }
 
-  // < 1
   return 0;
 }
 
-bool checkImp( const xmlNode *alp_node ){
+int get_d_level( const folia::Sentence *s, int tree_level ){
+  // determine de d-level of a folia::Sentence, given the d-level that
+  // follows from its Alpino tree (see tree_d_level)
+  vector<folia::PosAnnotation*> poslist;
+  vector<folia::Word*> wordlist = s->words();
+  int pv_counter = 0;
+  int neven_counter = 0;
+  for ( size_t i=0; i < wordlist.size(); ++i ){
+    folia::Word *w = wordlist[i];
+    vector<folia::PosAnnotation*> posV = w->select<folia::PosAnnotation>("http://ilk.uvt.nl/folia/sets/frog-mbpos-cgn");
+    if ( posV.size() != 1 )
+      throw folia::ValueError( "word doesn't have POS tag info" );
+    folia::PosAnnotation *pa = posV[0];
+    string pos = pa->feat("head");
+    poslist.push_back( pa );
+    if ( pos == "WW" ){
+      //      cerr << "WW " << pa->xmlstring() << endl;
+      string wvorm = pa->feat("wvorm");
+      if( wvorm == "pv" )
+  ++pv_counter;
+      //      cerr << "pv_counter= " << pv_counter << endl;
+    }
+    if ( pos == "VG" ){
+      //      cerr << "VG " << pa->xmlstring() << endl;
+      string cp = pa->feat("conjtype");
+      if ( cp == "neven" )
+  ++neven_counter;
+      //      cerr << "neven_counter= " << neven_counter << endl;
+    }
+  }
+  if ( pv_counter - neven_counter > 2 ){
+    // op niveau 7 staan zinnen met meerdere bijzinnen, maar deelzinnen die
+    // in nevenschikking staan tellen hiervoor niet mee
+    return 7;
+  }
+
+  if ( tree_level == 6 ){
+    return 6;
+  }
+
+  // < 6
+  for ( size_t i=0; i < poslist.size(); ++i ){
+    // we kijken of het om een level 5 zin gaat
+    // Zinnen met ondergeschikte bijzinnen
+    //     ("Pietje wilde naar huis, omdat het regende.")
+    string pos = poslist[i]->feat("head");
+    if ( pos == "VG" ){
+      string cp = poslist[i]->feat("conjtype");
+      if ( cp == "onder" ){
+  if ( poslist[i]->parent()->text() != "dat" )
+    return 5;
+      }
+    }
+  }
+
+  if ( tree_level == 4 || tree_level == 3 ){
+    return tree_level;
+  }
+
+  // < 3
+  for ( size_t i=0; i < poslist.size(); ++i ){
+    // we kijken of het om een level 2 zin gaat
+    // zinnen met nevenschikkingen
+    // cerr << "bekijk " << poslist[i] << endl;
+    // cerr << "head=" << poslist[i]->feat("head") << endl;
+    // cerr << "head=" << poslist[i]->feat("headfeature") << endl;
+    string pos = poslist[i]->feat("head");
+    if ( pos == "VG" ){
+      string cp = poslist[i]->feat("conjtype");
+      if ( cp == "neven" )
+  return 2;
+    }
+  }
+
+  // < 2
+  return tree_level;
+}
+
+int get_d_level( const folia::Sentence *s, xmlDoc *alp ){
+  return get_d_level( s, tree_d_level( alp ) );
+}
+
+bool checkImp( const AlpinoTree& tree, int alp_node ){
   // check if this is an Imperative
-  vector< xmlNode *> siblings = getSibblings( alp_node );
+  int parent = tree[alp_node].parent;
+  if ( parent < 0 ){
+    return true;
+  }
   bool su_found = false;
-  for ( size_t i=0; i < siblings.size(); ++i ){
-    string rel = TiCC::getAttribute( siblings[i], "rel" );
-    if ( rel == "su" || rel == "sup" )
+  for ( int s = tree[parent].first_child; s >= 0; s = tree[s].next ){
+    if ( s != alp_node
+	 && ( tree[s].rel == AlpRel::SU || tree[s].rel == AlpRel::SUP ) )
       su_found = true;
   }
   return !su_found;
 }
 
-bool checkModifier( const xmlNode *alp_node ){
+bool checkModifier( const AlpinoTree& tree, int alp_node ){
   // check if this node is directly below:
   // - a form AP, PPART, PPRES or INF (adjective or non-conjugated verb)
   // - a type SMAIN or SSUB (conjugated verb), and the node itself is a MOD
   bool modifies = false;
-  string rel = TiCC::getAttribute(alp_node, "rel");
-  string p_cat = TiCC::getAttribute(alp_node->parent, "cat");
+  AlpRel::Type rel = tree[alp_node].rel;
+  AlpCat::Type p_cat = tree.cat( tree[alp_node].parent );
 
-  if (p_cat == "ap" || p_cat == "ppart" ||
-      p_cat == "ppres" || p_cat == "inf") {
+  if (p_cat == AlpCat::AP || p_cat == AlpCat::PPART ||
+      p_cat == AlpCat::PPRES || p_cat == AlpCat::INF) {
     modifies = true;
   }
-  else if (rel == "mod" && (p_cat == "smain" || p_cat == "ssub")) {
+  else if (rel == AlpRel::MOD && (p_cat == AlpCat::SMAIN || p_cat == AlpCat::SSUB)) {
     modifies = true;
   }
   return modifies;
 }
 
 // Retrieves counts for adjectives and other noun modifiers
-void mod_stats( xmlDoc *doc, int& adjNpMod, int& npMod ) {
+void mod_stats( AlpinoQueries& q, int& adjNpMod, int& npMod ) {
   adjNpMod = 0;
   npMod = 0;
 
-  list<xmlNode*> npnodes = TiCC::FindNodes(doc, "//node[@cat='np']");
+  list<xmlNode*> npnodes = q.find("//node[@cat='np']");
   for (auto& node : npnodes) {
-    adjNpMod += TiCC::FindNodes(node, "./node[@rel='mod' and @pos='adj']").size();
-    npMod += TiCC::FindNodes(node, "./node[(@rel='det' and (@pt='tw' or @pt='n')) or @rel='mod' or @rel='app' or @rel='vc']").size();
+    adjNpMod += q.find(node, "./node[@rel='mod' and @pos='adj']").size();
+    npMod += q.find(node, "./node[(@rel='det' and (@pt='tw' or @pt='n')) or @rel='mod' or @rel='app' or @rel='vc']").size();
   }
 }
 
@@ -1022,42 +901,42 @@ bool isSmallCnj( const xmlNode *eNode ){
 }
 
 // Returns adverbial nodes: "mod" or "predm" directly below a verb (or folia::Sentence) instance.
-list<xmlNode*> getAdverbialNodes( xmlDoc *doc ) {
+list<xmlNode*> getAdverbialNodes( AlpinoQueries& q ) {
   string verbs = "|smain|ssub|sv1|inf|ti|ppart|ppresent|";
-  return TiCC::FindNodes(doc, "//node[contains('" + verbs + "', concat('|', @cat, '|'))]/node[@rel='mod' or @rel='predm']");
+  return q.find("//node[contains('" + verbs + "', concat('|', @cat, '|'))]/node[@rel='mod' or @rel='predm']");
 }
 
 // Returns nodes that have the given cat as attribute in the complete xmlDoc.
-list<xmlNode*> getNodesByCat( xmlDoc *doc, const string& cat, const string& extra ) {
-  return getNodesByCat(xmlDocGetRootElement(doc), cat, extra);
+list<xmlNode*> getNodesByCat( AlpinoQueries& q, const string& cat, const string& extra ) {
+  return getNodesByCat(q, q.root(), cat, extra);
 }
 
 // Returns nodes that have the given rel/cat as attribute in the complete xmlDoc.
-list<xmlNode*> getNodesByRelCat( xmlDoc *doc, const string& rel, const string& cat, const string& extra ) {
-  return getNodesByRelCat(xmlDocGetRootElement(doc), rel, cat, extra);
+list<xmlNode*> getNodesByRelCat( AlpinoQueries& q, const string& rel, const string& cat, const string& extra ) {
+  return getNodesByRelCat(q, q.root(), rel, cat, extra);
 }
 
 // Returns nodes that have the given cat as attribute, starting from the given xmlNode.
 // The cat parameter can start with a "!" to signal that the attribute should NOT be the given cat/rel.
-list<xmlNode*> getNodesByCat( xmlNode *node, const string& cat, const string& extra ) {
+list<xmlNode*> getNodesByCat( AlpinoQueries& q, xmlNode *node, const string& cat, const string& extra ) {
   string catAttr = cat.at(0) == '!' ? ("@cat!='" + cat.substr(1) + "'") : ("@cat='" + cat + "'");
   string xPath = ".//node[" + catAttr + "]";
   if (!extra.empty()) {
     xPath += extra;
   }
-  return TiCC::FindNodes( node, xPath );
+  return q.find( node, xPath );
 }
 
 // Returns nodes that have the given rel/cat as attribute, starting from the given xmlNode.
 // The cat/rel parameters can start with a "!" to signal that the attribute should NOT be the given cat/rel.
-list<xmlNode*> getNodesByRelCat( xmlNode *node, const string& rel, const string& cat, const string& extra ) {
+list<xmlNode*> getNodesByRelCat( AlpinoQueries& q, xmlNode *node, const string& rel, const string& cat, const string& extra ) {
   string relAttr = rel.at(0) == '!' ? ("@rel!='" + rel.substr(1) + "'") : ("@rel='" + rel + "'");
   string catAttr = cat.at(0) == '!' ? ("@cat!='" + cat.substr(1) + "'") : ("@cat='" + cat + "'");
   string xPath = ".//node[" + relAttr + " and " + catAttr + "]";
   if (!extra.empty()) {
     xPath += extra;
   }
-  return TiCC::FindNodes( node, xPath );
+  return q.find( node, xPath );
 }
 
 // Returns the id attribute for each xmlNode in the list.
@@ -1088,26 +967,232 @@ list<xmlNode*> complementNodes( list<xmlNode*> nodesA, list<xmlNode*> nodesB) {
   return result;
 }
 
-xmlDoc *AlpinoParse( const folia::Sentence *s, const string& dirname ){
-  //  parse a FoLiA folia::Sentence into an Alpino tree.
-  string txt = TiCC::UnicodeToUTF8(s->toktext());
-  //  cerr << "parse line: " << txt << endl;
-  string txtfile = dirname + "parse.txt";
-  ofstream os( txtfile.c_str() );
-  os << txt;
-  os.close();
-  string parseCmd = "Alpino -fast -flag treebank " + dirname +
-    " end_hook=xml -parse < " + txtfile + " -notk > /dev/null 2>&1";
-  // cerr << "run: " << parseCmd << endl;
-  int res = system( parseCmd.c_str() );
-  if ( res ){
-    cerr << "Alpino failed: RES = " << res << endl;
-  }
-  remove( txtfile.c_str() );
-  string xmlfile = dirname + "1.xml";
-  xmlDoc *xmldoc = xmlReadFile( xmlfile.c_str(), 0, XML_PARSE_NOBLANKS );
-  if ( xmldoc ){
-    return xmldoc;
+// the compiled expressions of this thread
+struct CompiledQueries {
+  ~CompiledQueries(){
+    for ( const auto& it : queries ){
+      xmlXPathFreeCompExpr( it.second );
+    }
+  }
+  xmlXPathCompExpr *get( const string& expr ){
+    auto it = queries.find( expr );
+    if ( it != queries.end() ){
+      return it->second;
+    }
+    xmlXPathCompExpr *comp = xmlXPathCompile( (const xmlChar*)expr.c_str() );
+    if ( !comp ){
+      throw runtime_error( "invalid XPath expression: " + expr );
+    }
+    queries[expr] = comp;
+    return comp;
+  }
+  map<string,xmlXPathCompExpr*> queries;
+};
+
+static thread_local CompiledQueries compiled_queries;
+
+AlpinoQueries::AlpinoQueries( xmlDoc *d ):
+  doc( d )
+{
+  context = xmlXPathNewContext( doc );
+}
+
+AlpinoQueries::~AlpinoQueries(){
+  xmlXPathFreeContext( context );
+}
+
+list<xmlNode*> AlpinoQueries::find( const string& expr ){
+  return find( root(), expr );
+}
+
+list<xmlNode*> AlpinoQueries::find( xmlNode *node, const string& expr ){
+  auto key = make_pair( expr, (const xmlNode*)node );
+  auto it = results.find( key );
+  if ( it != results.end() ){
+    return it->second;
+  }
+  xmlXPathCompExpr *comp = compiled_queries.get( expr );
+  context->node = node;
+  xmlXPathObject *obj = xmlXPathCompiledEval( comp, context );
+  list<xmlNode*> found;
+  if ( obj ){
+    if ( obj->type != XPATH_NODESET ){
+      xmlXPathFreeObject( obj );
+      throw runtime_error( "XPath expression doesn't give nodes: " + expr );
+    }
+    xmlNodeSet *nodes = obj->nodesetval;
+    if ( nodes ){
+      for ( int i=0; i < nodes->nodeNr; ++i ){
+	found.push_back( nodes->nodeTab[i] );
+      }
+    }
+    xmlXPathFreeObject( obj );
+  }
+  results[key] = found;
+  return found;
+}
+
+static int boundary_rank( const vector<string>& words,
+			  const vector<string>& tags, size_t i ){
+  // how good a place it is to start a new piece at words[i]
+  const string& prev = words[i-1];
+  if ( prev == ";" || prev == ":" ){
+    return 3;
+  }
+  if ( tags.size() == words.size() && tags[i] == "VG(neven)" ){
+    return 2;
+  }
+  if ( prev == "," ){
+    return 1;
+  }
+  return 0;
+}
+
+static string join_words( const vector<string>& words,
+			  size_t begin, size_t end ){
+  string result;
+  for ( size_t i = begin; i < end; ++i ){
+    if ( i > begin ){
+      result += " ";
+    }
+    result += words[i];
+  }
+  return result;
+}
+
+vector<string> splitForAlpino( const string& sentence,
+			       const vector<string>& tags, size_t max ){
+  // cuts a tokenized sentence of more than max tokens into pieces of at
+  // most max tokens, which Alpino parses on their own. A piece preferably
+  // ends at a semicolon or colon, else before a coordinating conjunction,
+  // else after a comma, and is not much shorter than max. When there is
+  // no such boundary the sentence is cut at max tokens.
+  // The coordinating conjunctions are the tokens with Frog's tag
+  // VG(neven) in 'tags', which holds a tag per token, or is empty when
+  // the tags are unknown.
+  vector<string> words;
+  TiCC::split( sentence, words );
+  if ( max == 0 || words.size() <= max ){
+    return vector<string>( 1, sentence );
+  }
+  size_t shortest = std::max<size_t>( 1, max/4 );
+  vector<string> result;
+  size_t begin = 0;
+  while ( words.size() - begin > max ){
+    size_t cut = begin + max;
+    int best = 0;
+    for ( size_t i = begin + shortest; i <= begin + max; ++i ){
+      int rank = boundary_rank( words, tags, i );
+      if ( rank > 0 && rank >= best ){
+	best = rank;
+	cut = i;
+      }
+    }
+    result.push_back( join_words( words, begin, cut ) );
+    begin = cut;
+  }
+  result.push_back( join_words( words, begin, words.size() ) );
+  return result;
+}
+
+static void shift_nodes( xmlNode *node, int offset, int index_offset,
+			 int& id, int& max_index ){
+  // renumber a node copied from the parse of a piece and its descendants,
+  // so they fit in the joined tree
+  if ( node->type != XML_ELEMENT_NODE ||
+       !xmlStrEqual( node->name, (const xmlChar*)"node" ) ){
+    return;
+  }
+  const char *positions[] = { "begin", "end" };
+  for ( const auto& att : positions ){
+    string val = TiCC::getAttribute( node, att );
+    if ( !val.empty() ){
+      int pos = TiCC::stringTo<int>( val ) + offset;
+      xmlSetProp( node, (const xmlChar*)att,
+		  (const xmlChar*)TiCC::toString( pos ).c_str() );
+    }
+  }
+  xmlSetProp( node, (const xmlChar*)"id",
+	      (const xmlChar*)TiCC::toString( id++ ).c_str() );
+  string index = TiCC::getAttribute( node, "index" );
+  if ( !index.empty() ){
+    int ind = TiCC::stringTo<int>( index );
+    max_index = std::max( max_index, ind );
+    xmlSetProp( node, (const xmlChar*)"index",
+		(const xmlChar*)TiCC::toString( ind + index_offset ).c_str() );
+  }
+  for ( xmlNode *child = node->children; child; child = child->next ){
+    shift_nodes( child, offset, index_offset, id, max_index );
+  }
+}
+
+static xmlNode *top_node( xmlDoc *doc ){
+  xmlNode *root = xmlDocGetRootElement( doc );
+  for ( xmlNode *pnt = root ? root->children : 0; pnt; pnt = pnt->next ){
+    if ( pnt->type == XML_ELEMENT_NODE &&
+	 xmlStrEqual( pnt->name, (const xmlChar*)"node" ) ){
+      return pnt;
+    }
   }
   return 0;
 }
+
+xmlDoc *joinAlpinoParses( vector<xmlDoc*>& pieces,
+			  const vector<string>& texts ){
+  // combine the parses of the pieces of a split sentence into one tree,
+  // with the trees of the pieces below one top node. The root gets a
+  // 'split' attribute with the number of pieces.
+  // The pieces are freed. Returns 0 when one of the pieces has no parse.
+  bool complete = true;
+  for ( const auto& piece : pieces ){
+    if ( !piece || !top_node( piece ) ){
+      complete = false;
+    }
+  }
+  if ( !complete ){
+    for ( const auto& piece : pieces ){
+      xmlFreeDoc( piece );
+    }
+    pieces.clear();
+    return 0;
+  }
+  xmlDoc *doc = xmlNewDoc( (const xmlChar*)"1.0" );
+  xmlNode *root = xmlNewDocNode( doc, 0, (const xmlChar*)"alpino_ds", 0 );
+  xmlDocSetRootElement( doc, root );
+  xmlSetProp( root, (const xmlChar*)"version", (const xmlChar*)"1.3" );
+  xmlSetProp( root, (const xmlChar*)"split",
+	      (const xmlChar*)TiCC::toString( pieces.size() ).c_str() );
+  xmlNode *top = xmlNewChild( root, 0, (const xmlChar*)"node", 0 );
+  xmlSetProp( top, (const xmlChar*)"begin", (const xmlChar*)"0" );
+  xmlSetProp( top, (const xmlChar*)"cat", (const xmlChar*)"top" );
+  xmlSetProp( top, (const xmlChar*)"id", (const xmlChar*)"0" );
+  xmlSetProp( top, (const xmlChar*)"rel", (const xmlChar*)"top" );
+  int offset = 0;
+  int index_offset = 0;
+  int id = 1;
+  for ( const auto& piece : pieces ){
+    xmlNode *piece_top = top_node( piece );
+    int max_index = 0;
+    for ( xmlNode *pnt = piece_top->children; pnt; pnt = pnt->next ){
+      xmlNode *copy = xmlDocCopyNode( pnt, doc, 1 );
+      shift_nodes( copy, offset, index_offset, id, max_index );
+      xmlAddChild( top, copy );
+    }
+    offset += TiCC::stringTo<int>( TiCC::getAttribute( piece_top, "end" ) );
+    index_offset += max_index;
+    xmlFreeDoc( piece );
+  }
+  pieces.clear();
+  xmlSetProp( top, (const xmlChar*)"end",
+	      (const xmlChar*)TiCC::toString( offset ).c_str() );
+  string sentence;
+  for ( const auto& text : texts ){
+    if ( !sentence.empty() ){
+      sentence += " ";
+    }
+    sentence += text;
+  }
+  xmlNewTextChild( root, 0, (const xmlChar*)"sentence",
+		   (const xmlChar*)sentence.c_str() );
+  return doc;
+}
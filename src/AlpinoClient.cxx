@@ -0,0 +1,383 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include "libxml/parser.h"
+#include "ticcutils/StringOps.h"
+#include "ticcutils/SocketBasics.h"
+#include "tscan/Alpino.h"
+#include "tscan/AlpinoClient.h"
+#include "tscan/ParseCache.h"
+
+using namespace std;
+
+//#define DEBUG_ALPINO
+
+AlpinoClient::AlpinoClient( const string& h, const string& p,
+			    int conn, int tries ):
+  max_connections( conn ),
+  retries( tries ),
+  timeout( 0 ),
+  servers( h, p, conn )
+{}
+
+static int connections_setting( const TiCC::Configuration& cf ){
+  // the default limit of concurrent connections per server
+  int result = 4;
+  string val = cf.lookUp( "connections", "alpino" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, result ) || result < 1 ){
+      cerr << "invalid value for 'connections' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  return result;
+}
+
+AlpinoClient::AlpinoClient( const TiCC::Configuration& cf ):
+  max_connections( connections_setting( cf ) ),
+  retries( 2 ),
+  timeout( 0 ),
+  servers( cf, "alpino", "", max_connections )
+{
+  if ( servers.capacity() == 0 ){
+    cerr << "every Alpino server needs a connection limit" << endl;
+    exit( EXIT_FAILURE );
+  }
+  string val = cf.lookUp( "retries", "alpino" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, retries ) || retries < 0 ){
+      cerr << "invalid value for 'retries' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  val = cf.lookUp( "timeout", "alpino" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, timeout ) ){
+      cerr << "invalid value for 'timeout' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+}
+
+AlpinoClient::Outcome AlpinoClient::request( int server,
+					     const string& sentence,
+					     string& xml ){
+  Sockets::ClientSocket client;
+  if ( !client.connect( servers.host( server ), servers.port( server ) ) ){
+    cerr << "failed to open Alpino connection: "<< servers.name( server )
+	 << endl;
+    cerr << "Reason: " << client.getMessage() << endl;
+    return UNREACHABLE;
+  }
+  client.write( sentence + "\n\n" );
+  xml.clear();
+  // the timeout holds for the whole answer, not for every line of it
+  auto deadline = chrono::steady_clock::now() + chrono::seconds( timeout );
+  string s;
+  while ( true ){
+    bool got;
+    if ( timeout > 0 ){
+      auto left = chrono::duration_cast<chrono::milliseconds>
+	( deadline - chrono::steady_clock::now() ).count();
+      if ( left <= 0 ){
+	break;
+      }
+      // whole seconds, rounded up
+      got = client.read( s, ( left + 999 ) / 1000 );
+    }
+    else {
+      got = client.read( s );
+    }
+    if ( !got ){
+      break;
+    }
+    xml += s + "\n";
+  }
+#ifdef DEBUG_ALPINO
+  cerr << "received data [" << xml << "]" << endl;
+#endif
+  // the socket doesn't tell a closed connection from a read that timed
+  // out, but only a complete document is a parse
+  if ( xml.find( "</alpino_ds>" ) == string::npos ){
+    if ( timeout > 0 && chrono::steady_clock::now() >= deadline ){
+      cerr << "no answer from Alpino server " << servers.name( server )
+	   << " within " << timeout << " seconds" << endl;
+    }
+    xml.clear();
+    return NO_PARSE;
+  }
+  return PARSED;
+}
+
+static size_t token_count( const string& sentence ){
+  return count( sentence.begin(), sentence.end(), ' ' ) + 1;
+}
+
+bool AlpinoClient::parse( const string& sentence, string& xml ){
+  bool ok = false;
+  for ( int attempt=0; !ok && attempt <= retries; ++attempt ){
+    if ( attempt > 0 ){
+      cerr << "retrying Alpino (" << attempt << "/" << retries << ")" << endl;
+      this_thread::sleep_for( chrono::milliseconds( 200 * attempt ) );
+    }
+    // a retry may go to another server
+    int server = servers.acquire();
+    auto start = chrono::steady_clock::now();
+    Outcome outcome = request( server, sentence, xml );
+    ok = ( outcome == PARSED );
+    if ( ok ){
+      chrono::duration<double> took = chrono::steady_clock::now() - start;
+      servers.learn( server, token_count( sentence ), took.count() );
+    }
+    servers.release( server, outcome != UNREACHABLE );
+  }
+  return ok;
+}
+
+double AlpinoClient::estimate( size_t tokens ){
+  // 0 until the first parse is done
+  return servers.estimate( tokens );
+}
+
+ostream& operator<<( ostream& os, const AlpinoSchedule& s ){
+  os << s.requests << " parses on " << s.connections << " connections in "
+     << s.makespan << "s (busy " << s.busy << "s, estimated "
+     << s.estimate << "s), the longest took " << s.longest << "s ("
+     << s.longest_tokens << " tokens) and finished at " << s.longest_end
+     << "s";
+  return os;
+}
+
+AlpinoBatch::AlpinoBatch( AlpinoClient& c, ParseCache *pc, size_t max ):
+  client( c ),
+  cache( pc ),
+  split( max ),
+  stopping( false )
+{
+  start();
+}
+
+AlpinoBatch::AlpinoBatch( AlpinoClient& c, const vector<string>& sents,
+			  const vector<vector<string>>& tags,
+			  ParseCache *pc, size_t max ):
+  client( c ),
+  cache( pc ),
+  split( max ),
+  stopping( false )
+{
+  for ( size_t i=0; i < sents.size(); ++i ){
+    queue( sents[i], tags[i] );
+  }
+  start();
+}
+
+void AlpinoBatch::start(){
+  timing.connections = client.connections();
+  for ( int i=0; i < client.connections(); ++i ){
+    workers.push_back( thread( &AlpinoBatch::work, this ) );
+  }
+}
+
+AlpinoBatch::~AlpinoBatch(){
+  // don't start new requests, but wait for the running ones
+  {
+    lock_guard<mutex> l( lock );
+    stopping = true;
+  }
+  queued.notify_all();
+  for ( auto& w : workers ){
+    w.join();
+  }
+  for ( const auto& doc : parses ){
+    // not collected
+    xmlFreeDoc( doc );
+  }
+}
+
+size_t AlpinoBatch::queue( const string& sentence,
+			  const vector<string>& tags ){
+  // called with the lock held. A long sentence becomes several requests
+  size_t pos = sentences.size();
+  sentences.push_back( sentence );
+  vector<size_t> mine;
+  for ( const auto& piece : splitForAlpino( sentence, tags, split ) ){
+    size_t r = requests.size();
+    mine.push_back( r );
+    requests.push_back( piece );
+    tokens.push_back( token_count( piece ) );
+    parses.push_back( 0 );
+    done.push_back( false );
+    pending.push_back( r );
+    push_heap( pending.begin(), pending.end(),
+	       [this]( size_t a, size_t b ){ return before( b, a ); } );
+  }
+  pieces.push_back( mine );
+  return pos;
+}
+
+size_t AlpinoBatch::add( const string& sentence,
+			const vector<string>& tags ){
+  size_t pos;
+  {
+    lock_guard<mutex> l( lock );
+    pos = queue( sentence, tags );
+  }
+  queued.notify_all();
+  return pos;
+}
+
+vector<size_t> AlpinoBatch::positions( const vector<string>& sents,
+				       const vector<vector<string>>& tags ){
+  // the batch normally holds exactly these sentences, in the same order.
+  // but sentences may have been queued that aren't analysed, or the
+  // other way round.
+  vector<size_t> result;
+  size_t pos = 0;
+  for ( size_t i=0; i < sents.size(); ++i ){
+    const string& sent = sents[i];
+    size_t found;
+    size_t size;
+    {
+      lock_guard<mutex> l( lock );
+      found = find( sentences.begin() + pos, sentences.end(), sent )
+	- sentences.begin();
+      size = sentences.size();
+    }
+    if ( found < size ){
+      pos = found + 1;
+      result.push_back( found );
+    }
+    else {
+      result.push_back( add( sent, tags[i] ) );
+    }
+  }
+  return result;
+}
+
+bool AlpinoBatch::before( size_t a, size_t b ) const {
+  // request 'a' is sent before request 'b': the longest first, and of
+  // equally long ones the first queued. The estimated parse time grows
+  // with the number of tokens, so that is what is compared.
+  if ( tokens[a] != tokens[b] ){
+    return tokens[a] > tokens[b];
+  }
+  return a < b;
+}
+
+void AlpinoBatch::work(){
+  // the most expensive queued request is sent first, so the longest
+  // sentences of a document don't end up in the tail of its parses
+  while ( true ){
+    size_t i;
+    string sentence;
+    {
+      unique_lock<mutex> l( lock );
+      queued.wait( l, [this]{ return stopping || !pending.empty(); } );
+      if ( stopping ){
+	return;
+      }
+      pop_heap( pending.begin(), pending.end(),
+		[this]( size_t a, size_t b ){ return before( b, a ); } );
+      i = pending.back();
+      pending.pop_back();
+      sentence = requests[i];
+    }
+    xmlDoc *doc = 0;
+    if ( cache ){
+      doc = cache->lookup( sentence );
+    }
+    if ( !doc ){
+      string xml;
+      double expected = client.estimate( tokens[i] );
+      auto start = chrono::steady_clock::now();
+      {
+	lock_guard<mutex> l( lock );
+	if ( timing.requests++ == 0 ){
+	  first_start = start;
+	}
+      }
+      bool ok = client.parse( sentence, xml );
+      auto finish = chrono::steady_clock::now();
+      {
+	lock_guard<mutex> l( lock );
+	chrono::duration<double> took = finish - start;
+	chrono::duration<double> end = finish - first_start;
+	timing.busy += took.count();
+	timing.estimate += expected;
+	timing.makespan = max( timing.makespan, end.count() );
+	if ( took.count() > timing.longest ){
+	  timing.longest = took.count();
+	  timing.longest_tokens = tokens[i];
+	  timing.longest_end = end.count();
+	}
+      }
+      if ( ok ){
+	doc = xmlReadMemory( xml.c_str(), xml.length(),
+			     0, 0, XML_PARSE_NOBLANKS );
+	if ( cache ){
+	  cache->store( sentence, doc );
+	}
+      }
+    }
+    {
+      lock_guard<mutex> l( lock );
+      parses[i] = doc;
+      done[i] = true;
+    }
+    ready.notify_all();
+  }
+}
+
+xmlDoc *AlpinoBatch::result( size_t i ){
+  vector<xmlDoc*> docs;
+  vector<string> texts;
+  {
+    unique_lock<mutex> l( lock );
+    const vector<size_t> mine = pieces[i];
+    ready.wait( l, [this,&mine]{
+	for ( const auto& r : mine ){
+	  if ( !done[r] ){
+	    return false;
+	  }
+	}
+	return true;
+      } );
+    for ( const auto& r : mine ){
+      docs.push_back( parses[r] );
+      parses[r] = 0;
+      texts.push_back( requests[r] );
+    }
+  }
+  if ( docs.size() == 1 ){
+    return docs[0];
+  }
+  return joinAlpinoParses( docs, texts );
+}
+
+AlpinoSchedule AlpinoBatch::schedule(){
+  lock_guard<mutex> l( lock );
+  return timing;
+}
@@ -0,0 +1,461 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <set>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "libxml/parser.h"
+#include "ticcutils/StringOps.h"
+#include "tscan/AlpinoPool.h"
+
+using namespace std;
+
+//#define DEBUG_POOL
+
+// local processes always get a time limit, or a stuck one would never
+// come back: this is the user_max of webservice/startalpino.sh
+const unsigned int default_timeout = 300;
+
+AlpinoPool::AlpinoPool( const string& dir, int size, unsigned int t ):
+  timeout( t > 0 ? t : default_timeout )
+{
+  init( dir, size );
+}
+
+AlpinoPool::AlpinoPool( const TiCC::Configuration& cf, const string& dir ):
+  timeout( default_timeout )
+{
+  int size = 1;
+  string val = cf.lookUp( "processes", "alpino" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, size ) || size < 1 ){
+      cerr << "invalid value for 'processes' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  val = cf.lookUp( "timeout", "alpino" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, timeout ) ){
+      cerr << "invalid value for 'timeout' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+    if ( timeout == 0 ){
+      timeout = default_timeout;
+    }
+  }
+  init( dir, size );
+}
+
+void AlpinoPool::init( const string& dir, int size ){
+  // writing to a process that just died must not kill tscan
+  signal( SIGPIPE, SIG_IGN );
+  processes.resize( size );
+  for ( int i=0; i < size; ++i ){
+    // the processes are started when they are needed
+    processes[i].dir = dir + "alpino" + TiCC::toString( i ) + "/";
+    mkdir( processes[i].dir.c_str(), S_IRWXU|S_IRWXG );
+  }
+}
+
+AlpinoPool::~AlpinoPool(){
+  for ( auto& p : processes ){
+    stop( p );
+    rmdir( p.dir.c_str() );
+  }
+}
+
+static int free_port(){
+  // a port on this machine that nothing listens on now. 0 on failure.
+  // Another program may take it before Alpino does, see connect()
+  int fd = socket( AF_INET, SOCK_STREAM, 0 );
+  if ( fd < 0 ){
+    return 0;
+  }
+  struct sockaddr_in addr;
+  socklen_t len = sizeof( addr );
+  memset( &addr, 0, len );
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  addr.sin_port = 0;
+  int result = 0;
+  if ( bind( fd, (struct sockaddr*)&addr, len ) == 0
+       && getsockname( fd, (struct sockaddr*)&addr, &len ) == 0 ){
+    result = ntohs( addr.sin_port );
+  }
+  close( fd );
+  return result;
+}
+
+bool AlpinoPool::start( Process& p ){
+  p.port = free_port();
+  if ( p.port == 0 ){
+    cerr << "no free port for an Alpino process" << endl;
+    return false;
+  }
+  // the same settings as webservice/startalpino.sh
+  vector<string> args = { "Alpino", "-notk", "-fast",
+			  "user_max=" + TiCC::toString( timeout * 1000 ),
+			  "server_kind=parse",
+			  "server_port=" + TiCC::toString( p.port ),
+			  "assume_input_is_tokenized=on", "end_hook=xml",
+			  "-init_dict_p", "batch_command=alpino_server" };
+  vector<char*> argv;
+  for ( auto& arg : args ){
+    argv.push_back( &arg[0] );
+  }
+  argv.push_back( 0 );
+  const char *dir = p.dir.c_str();
+  pid_t pid = fork();
+  if ( pid < 0 ){
+    cerr << "unable to start Alpino" << endl;
+    return false;
+  }
+  if ( pid == 0 ){
+    // a process group of its own, so its port can be recognised, and
+    // it can be stopped with all its children
+    setpgid( 0, 0 );
+    // the child keeps its temporary files in its own directory
+    if ( chdir( dir ) ){
+      _exit( 127 );
+    }
+    int null = open( "/dev/null", O_RDWR );
+    dup2( null, 0 );
+    dup2( null, 1 );
+    dup2( null, 2 );
+    execvp( "Alpino", &argv[0] );
+    _exit( 127 );
+  }
+  setpgid( pid, pid );
+  p.pid = pid;
+  p.ready = false;
+#ifdef DEBUG_POOL
+  cerr << "started Alpino process " << pid << " on port " << p.port
+       << " in " << p.dir << endl;
+#endif
+  return true;
+}
+
+void AlpinoPool::stop( Process& p ){
+  if ( p.pid > 0 ){
+    kill( -p.pid, SIGKILL );
+    waitpid( p.pid, 0, 0 );
+    p.pid = -1;
+  }
+  p.ready = false;
+}
+
+bool AlpinoPool::running( Process& p ){
+  if ( p.pid <= 0 ){
+    return false;
+  }
+  int status;
+  if ( waitpid( p.pid, &status, WNOHANG ) == 0 ){
+    return true;
+  }
+  // it is gone. its children are stopped too
+  kill( -p.pid, SIGKILL );
+  p.pid = -1;
+  p.ready = false;
+  return false;
+}
+
+static set<string> listening_sockets( int port ){
+  // the inodes of the sockets that listen on 'port', from /proc/net
+  set<string> result;
+  for ( const auto& table : { "/proc/net/tcp", "/proc/net/tcp6" } ){
+    ifstream is( table );
+    string line;
+    getline( is, line ); // the header
+    while ( getline( is, line ) ){
+      istringstream ls( line );
+      string slot, local, remote, state, queues, timer, retransmits, uid,
+	timeouts, inode;
+      ls >> slot >> local >> remote >> state >> queues >> timer
+	 >> retransmits >> uid >> timeouts >> inode;
+      string::size_type colon = local.rfind( ':' );
+      if ( state == "0A" && colon != string::npos // LISTEN
+	   && strtol( local.c_str() + colon + 1, 0, 16 ) == port ){
+	result.insert( "socket:[" + inode + "]" );
+      }
+    }
+  }
+  return result;
+}
+
+static bool in_group( const string& pid, pid_t group ){
+  // the process group is the 3rd field after the command name, which is
+  // between parentheses and may hold spaces
+  ifstream is( "/proc/" + pid + "/stat" );
+  string stat;
+  getline( is, stat );
+  string::size_type close = stat.rfind( ')' );
+  if ( close == string::npos ){
+    return false;
+  }
+  istringstream fields( stat.substr( close + 1 ) );
+  string state;
+  pid_t parent = 0;
+  pid_t pgrp = 0;
+  fields >> state >> parent >> pgrp;
+  return pgrp == group;
+}
+
+enum Listener { NOBODY, OURS, FOREIGN, UNKNOWN };
+
+static Listener listener( pid_t group, int port ){
+  // who listens on 'port': process group 'group' or another program.
+  // UNKNOWN when there is no /proc to tell
+  if ( access( "/proc/net/tcp", R_OK ) != 0 ){
+    return UNKNOWN;
+  }
+  set<string> sockets = listening_sockets( port );
+  if ( sockets.empty() ){
+    return NOBODY;
+  }
+  Listener result = FOREIGN;
+  DIR *procs = opendir( "/proc" );
+  struct dirent *proc;
+  while ( result == FOREIGN && procs && ( proc = readdir( procs ) ) ){
+    string pid = proc->d_name;
+    if ( pid.find_first_not_of( "0123456789" ) != string::npos
+	 || !in_group( pid, group ) ){
+      continue;
+    }
+    string fd_dir = "/proc/" + pid + "/fd/";
+    DIR *fds = opendir( fd_dir.c_str() );
+    struct dirent *fd;
+    while ( result == FOREIGN && fds && ( fd = readdir( fds ) ) ){
+      char target[64];
+      ssize_t len = readlink( ( fd_dir + fd->d_name ).c_str(),
+			      target, sizeof( target ) - 1 );
+      if ( len > 0 ){
+	target[len] = 0;
+	if ( sockets.find( target ) != sockets.end() ){
+	  result = OURS;
+	}
+      }
+    }
+    if ( fds ){
+      closedir( fds );
+    }
+  }
+  if ( procs ){
+    closedir( procs );
+  }
+  return result;
+}
+
+static int open_connection( int port ){
+  // a connection to 'port' on this machine. -1 on failure
+  int fd = socket( AF_INET, SOCK_STREAM, 0 );
+  if ( fd < 0 ){
+    return -1;
+  }
+  fcntl( fd, F_SETFD, FD_CLOEXEC );
+  struct sockaddr_in addr;
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  addr.sin_port = htons( port );
+  if ( ::connect( fd, (struct sockaddr*)&addr, sizeof( addr ) ) != 0 ){
+    close( fd );
+    return -1;
+  }
+  return fd;
+}
+
+int AlpinoPool::connect( Process& p ){
+  // returns a connection to the process, or -1
+  if ( p.ready ){
+    int fd = open_connection( p.port );
+    if ( fd >= 0 ){
+      return fd;
+    }
+    cerr << "unable to connect to Alpino on port " << p.port
+	 << ", it is restarted" << endl;
+    stop( p );
+  }
+  // a new process only listens once it has loaded its grammar, which
+  // takes a while. Until then, it is asked again.
+  const int startup = 600; // seconds
+  int restarts = 0;
+  auto begin = chrono::steady_clock::now();
+  while ( true ){
+    if ( !running( p ) ){
+      // e.g. because another program took its port
+      if ( ++restarts > 3 || !start( p ) ){
+	cerr << "unable to start Alpino" << endl;
+	return -1;
+      }
+      begin = chrono::steady_clock::now();
+      continue;
+    }
+    Listener who = listener( p.pid, p.port );
+    if ( who == FOREIGN ){
+      cerr << "port " << p.port << " was taken by another program, "
+	   << "Alpino is started on another port" << endl;
+      stop( p );
+      continue;
+    }
+    if ( who == OURS || who == UNKNOWN ){
+      int fd = open_connection( p.port );
+      if ( fd >= 0 ){
+	p.ready = true;
+	return fd;
+      }
+    }
+    chrono::duration<double> waited = chrono::steady_clock::now() - begin;
+    if ( waited.count() > startup ){
+      cerr << "Alpino didn't start listening on port " << p.port
+	   << " within " << startup << " seconds" << endl;
+      stop( p );
+      return -1;
+    }
+    this_thread::sleep_for( chrono::milliseconds( 200 ) );
+  }
+}
+
+static bool write_all( int fd, const string& data ){
+  size_t done = 0;
+  while ( done < data.size() ){
+    ssize_t n = write( fd, data.c_str() + done, data.size() - done );
+    if ( n < 0 ){
+      if ( errno == EINTR ){
+	continue;
+      }
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
+xmlDoc *AlpinoPool::request( Process& p, const string& sentence ){
+  int fd = connect( p );
+  if ( fd < 0 ){
+    return 0;
+  }
+  if ( !write_all( fd, sentence + "\n\n" ) ){
+    cerr << "unable to send a sentence to Alpino, it will be restarted"
+	 << endl;
+    close( fd );
+    stop( p );
+    return 0;
+  }
+  // Alpino closes the connection after the parse. It stops parsing after
+  // 'timeout' seconds itself, so a process that hasn't answered in twice
+  // that time is stuck. That is one deadline for the whole answer.
+  auto deadline = chrono::steady_clock::now()
+    + chrono::seconds( 2 * timeout );
+  string xml;
+  bool eof = false;
+  char buf[4096];
+  while ( !eof ){
+    auto left = chrono::duration_cast<chrono::milliseconds>
+      ( deadline - chrono::steady_clock::now() ).count();
+    if ( left <= 0 ){
+      break;
+    }
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int ready = poll( &pfd, 1, left );
+    if ( ready < 0 && errno == EINTR ){
+      continue;
+    }
+    if ( ready <= 0 ){
+      break;
+    }
+    ssize_t n = read( fd, buf, sizeof( buf ) );
+    if ( n < 0 && errno == EINTR ){
+      continue;
+    }
+    if ( n <= 0 ){
+      eof = true;
+    }
+    else {
+      xml.append( buf, n );
+    }
+  }
+  close( fd );
+  bool complete = xml.find( "</alpino_ds>" ) != string::npos;
+  if ( !eof && !complete ){
+    cerr << "Alpino didn't answer within " << 2 * timeout << " seconds, "
+	 << "it will be restarted" << endl;
+    stop( p );
+    return 0;
+  }
+  if ( !complete ){
+    // no parse (in time) for this sentence
+    if ( !running( p ) ){
+      cerr << "Alpino stopped while parsing, it will be restarted" << endl;
+    }
+    return 0;
+  }
+  return xmlReadMemory( xml.c_str(), xml.length(), 0, 0, XML_PARSE_NOBLANKS );
+}
+
+xmlDoc *AlpinoPool::parse( const string& sentence ){
+  Process *p = 0;
+  {
+    // wait for an idle process
+    unique_lock<mutex> l( lock );
+    released.wait( l, [this,&p]{
+	for ( auto& candidate : processes ){
+	  if ( !candidate.busy ){
+	    p = &candidate;
+	    return true;
+	  }
+	}
+	return false;
+      } );
+    p->busy = true;
+  }
+  xmlDoc *doc = 0;
+  if ( running( *p ) || start( *p ) ){
+    doc = request( *p, sentence );
+  }
+  {
+    lock_guard<mutex> l( lock );
+    p->busy = false;
+  }
+  released.notify_one();
+  return doc;
+}
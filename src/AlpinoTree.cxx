@@ -0,0 +1,834 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <list>
+#include <set>
+#include <map>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include "ticcutils/StringOps.h"
+#include "ticcutils/XMLtools.h"
+#include "tscan/Alpino.h"
+#include "tscan/AlpinoTree.h"
+
+using namespace std;
+
+AlpinoTreeStats::AlpinoTreeStats():
+  dLevel(0),
+  adjNpModCnt(0),
+  npModCnt(0),
+  vcModCnt(0),
+  betrCnt(0),
+  bijwCnt(0),
+  complCnt(0),
+  infinComplCnt(0),
+  mvFinInbedCnt(0),
+  mvInbedCnt(0),
+  losBetrCnt(0),
+  losBijwCnt(0),
+  smainCnt(0),
+  ssubCnt(0),
+  sv1Cnt(0),
+  smainCnjCnt(0),
+  ssubCnjCnt(0),
+  sv1CnjCnt(0),
+  smallCnjCnt(0),
+  smallCnjExtraCnt(0)
+{}
+
+bool operator==( const AlpinoTreeStats& a, const AlpinoTreeStats& b ){
+  return a.dLevel == b.dLevel
+    && a.adjNpModCnt == b.adjNpModCnt
+    && a.npModCnt == b.npModCnt
+    && a.vcModCnt == b.vcModCnt
+    && multiset<string>( a.vcModWords.begin(), a.vcModWords.end() )
+    == multiset<string>( b.vcModWords.begin(), b.vcModWords.end() )
+    && a.betrCnt == b.betrCnt
+    && a.bijwCnt == b.bijwCnt
+    && a.complCnt == b.complCnt
+    && a.infinComplCnt == b.infinComplCnt
+    && a.mvFinInbedCnt == b.mvFinInbedCnt
+    && a.mvInbedCnt == b.mvInbedCnt
+    && a.losBetrCnt == b.losBetrCnt
+    && a.losBijwCnt == b.losBijwCnt
+    && a.smainCnt == b.smainCnt
+    && a.ssubCnt == b.ssubCnt
+    && a.sv1Cnt == b.sv1Cnt
+    && a.smainCnjCnt == b.smainCnjCnt
+    && a.ssubCnjCnt == b.ssubCnjCnt
+    && a.sv1CnjCnt == b.sv1CnjCnt
+    && a.smallCnjCnt == b.smallCnjCnt
+    && a.smallCnjExtraCnt == b.smallCnjExtraCnt;
+}
+
+ostream& operator<<( ostream& os, const AlpinoTreeStats& ts ){
+  os << "dLevel=" << ts.dLevel
+     << " adjNpMod=" << ts.adjNpModCnt
+     << " npMod=" << ts.npModCnt
+     << " vcMod=" << ts.vcModCnt << " [";
+  for ( const auto& w : ts.vcModWords ){
+    os << " " << w;
+  }
+  os << " ] betr=" << ts.betrCnt
+     << " bijw=" << ts.bijwCnt
+     << " compl=" << ts.complCnt
+     << " infinCompl=" << ts.infinComplCnt
+     << " mvFinInbed=" << ts.mvFinInbedCnt
+     << " mvInbed=" << ts.mvInbedCnt
+     << " losBetr=" << ts.losBetrCnt
+     << " losBijw=" << ts.losBijwCnt
+     << " smain=" << ts.smainCnt
+     << " ssub=" << ts.ssubCnt
+     << " sv1=" << ts.sv1Cnt
+     << " smainCnj=" << ts.smainCnjCnt
+     << " ssubCnj=" << ts.ssubCnjCnt
+     << " sv1Cnj=" << ts.sv1CnjCnt
+     << " smallCnj=" << ts.smallCnjCnt
+     << " smallCnjExtra=" << ts.smallCnjExtraCnt;
+  return os;
+}
+
+/*************
+ * THE TREE
+ *************/
+
+namespace AlpRel {
+  static const map<string,Type> labels = {
+    { "app", APP }, { "body", BODY }, { "cmp", CMP }, { "cnj", CNJ },
+    { "crd", CRD }, { "det", DET }, { "dlink", DLINK }, { "dp", DP },
+    { "hd", HD }, { "hdf", HDF }, { "ld", LD }, { "me", ME }, { "mod", MOD },
+    { "mwp", MWP }, { "nucl", NUCL }, { "obcomp", OBCOMP }, { "obj1", OBJ1 },
+    { "obj2", OBJ2 }, { "pc", PC }, { "pobj1", POBJ1 }, { "predc", PREDC },
+    { "predm", PREDM }, { "rhd", RHD }, { "sat", SAT }, { "se", SE },
+    { "su", SU }, { "sup", SUP }, { "svp", SVP }, { "tag", TAG },
+    { "top", TOP }, { "vc", VC }, { "whd", WHD }, { "obj", OBJ } };
+
+  Type fromString( const string& s ){
+    const auto it = labels.find( s );
+    return ( it == labels.end() ) ? OTHER : it->second;
+  }
+}
+
+namespace AlpCat {
+  static const map<string,Type> labels = {
+    { "advp", ADVP }, { "ahi", AHI }, { "ap", AP }, { "conj", CONJ },
+    { "cp", CP }, { "detp", DETP }, { "du", DU }, { "inf", INF },
+    { "mwu", MWU }, { "np", NP }, { "oti", OTI }, { "pp", PP },
+    { "ppart", PPART }, { "ppres", PPRES }, { "rel", REL },
+    { "smain", SMAIN }, { "ssub", SSUB }, { "sv1", SV1 }, { "svan", SVAN },
+    { "ti", TI }, { "top", TOP }, { "whq", WHQ }, { "whrel", WHREL },
+    { "whsub", WHSUB }, { "part", PART } };
+
+  Type fromString( const string& s ){
+    const auto it = labels.find( s );
+    return ( it == labels.end() ) ? OTHER : it->second;
+  }
+}
+
+namespace AlpPos {
+  static const map<string,Type> labels = {
+    { "adj", ADJ }, { "adv", ADV }, { "comp", COMP },
+    { "comparative", COMPARATIVE }, { "det", DET }, { "fixed", FIXED },
+    { "name", NAME }, { "noun", NOUN }, { "num", NUM }, { "part", PART },
+    { "pp", PP }, { "prefix", PREFIX }, { "prep", PREP }, { "pron", PRON },
+    { "punct", PUNCT }, { "tag", TAG }, { "verb", VERB }, { "vg", VG } };
+
+  Type fromString( const string& s ){
+    const auto it = labels.find( s );
+    return ( it == labels.end() ) ? OTHER : it->second;
+  }
+}
+
+static int to_int( const string& s ){
+  int result;
+  if ( !s.empty() && TiCC::stringTo( s, result ) ){
+    return result;
+  }
+  return -1;
+}
+
+AlpinoTree::AlpinoTree( xmlDoc *doc ):
+  text( 1, '\0' ) // offset 0 is the empty string
+{
+  if ( doc ){
+    add( xmlDocGetRootElement( doc ), -1 );
+    add_antecedents();
+  }
+}
+
+unsigned int AlpinoTree::store( const string& s ){
+  if ( s.empty() ){
+    return 0;
+  }
+  unsigned int result = text.size();
+  text += s;
+  text += '\0';
+  return result;
+}
+
+void AlpinoTree::add( const xmlNode *pnt, int parent ){
+  int prev = -1;
+  for ( ; pnt; pnt = pnt->next ){
+    if ( pnt->type != XML_ELEMENT_NODE ){
+      continue;
+    }
+    if ( TiCC::Name( pnt ) != "node" ){
+      add( pnt->children, parent );
+      continue;
+    }
+    AlpinoNode n;
+    n.rel = AlpRel::NONE;
+    n.cat = AlpCat::NONE;
+    n.lcat = AlpCat::NONE;
+    n.pos = AlpPos::NONE;
+    n.id = -1;
+    n.begin = -1;
+    n.end = -1;
+    n.index = -1;
+    n.parent = parent;
+    n.first_child = -1;
+    n.next = -1;
+    n.word = 0;
+    n.root = 0;
+    n.sc = 0;
+    n.pt = 0;
+    for ( const xmlAttr *a = pnt->properties; a; a = a->next ){
+      xmlChar *v = xmlNodeListGetString( pnt->doc, a->children, 1 );
+      string val = v ? (const char*)v : "";
+      xmlFree( v );
+      string att = (const char*)a->name;
+      if ( att == "rel" ) n.rel = AlpRel::fromString( val );
+      else if ( att == "cat" ) n.cat = AlpCat::fromString( val );
+      else if ( att == "lcat" ) n.lcat = AlpCat::fromString( val );
+      else if ( att == "pos" ) n.pos = AlpPos::fromString( val );
+      else if ( att == "id" ) n.id = to_int( val );
+      else if ( att == "begin" ) n.begin = to_int( val );
+      else if ( att == "end" ) n.end = to_int( val );
+      else if ( att == "index" ) n.index = to_int( val );
+      else if ( att == "word" ) n.word = store( val );
+      else if ( att == "root" ) n.root = store( val );
+      else if ( att == "sc" ) n.sc = store( val );
+      else if ( att == "pt" ) n.pt = store( val );
+    }
+    int me = nodes.size();
+    nodes.push_back( n );
+    if ( prev >= 0 ){
+      nodes[prev].next = me;
+    }
+    else if ( parent >= 0 && nodes[parent].first_child < 0 ){
+      nodes[parent].first_child = me;
+    }
+    prev = me;
+    if ( n.begin >= 0 && n.begin + 1 == n.end ){
+      // a word. the first one in document order, like "//node" gives them
+      if ( (size_t)n.end >= words.size() ){
+	words.resize( n.end + 1, -1 );
+      }
+      if ( words[n.end] < 0 ){
+	words[n.end] = me;
+      }
+    }
+    add( pnt->children, me );
+    nodes[me].last = nodes.size();
+  }
+}
+
+int AlpinoTree::word_node( size_t end ) const {
+  // the node of the word that ends at 'end', which is the position
+  // in the FoLiA word ids
+  return ( end < words.size() ) ? words[end] : -1;
+}
+
+int AlpinoTree::search( int node, AlpRel::Type rel ) const {
+  // like node_search(): first the children, then recursively below the
+  // children that are not a word
+  for ( int c = nodes[node].first_child; c >= 0; c = nodes[c].next ){
+    if ( nodes[c].rel == rel ){
+      return c;
+    }
+  }
+  for ( int c = nodes[node].first_child; c >= 0; c = nodes[c].next ){
+    if ( !has( nodes[c].root ) ){
+      int result = search( c, rel );
+      if ( result >= 0 ){
+	return result;
+      }
+    }
+  }
+  return -1;
+}
+
+void AlpinoTree::add_antecedents(){
+  // for every index, the first node with it that is not a trace itself.
+  // Like getIndexNodes() did, don't look below the top node's siblings,
+  // other antecedents or words
+  if ( nodes.empty() ){
+    return;
+  }
+  int i = 1;
+  while ( i < nodes[0].last ){
+    const AlpinoNode& n = nodes[i];
+    if ( n.index >= 0
+	 && !( n.pos == AlpPos::NONE && n.cat == AlpCat::NONE ) ){
+      if ( (size_t)n.index >= antecedents.size() ){
+	antecedents.resize( n.index + 1, -1 );
+      }
+      if ( antecedents[n.index] < 0 ){
+	antecedents[n.index] = i;
+      }
+      i = n.last;
+    }
+    else if ( has( n.root ) ){
+      i = n.last;
+    }
+    else {
+      ++i;
+    }
+  }
+}
+
+int AlpinoTree::antecedent( int index ) const {
+  if ( index < 0 || (size_t)index >= antecedents.size() ){
+    return -1;
+  }
+  return antecedents[index];
+}
+
+/*************
+ * ONE WALK
+ *************/
+
+static bool is_clause( AlpCat::Type cat ){
+  switch ( cat ){
+  case AlpCat::SMAIN:
+  case AlpCat::SSUB:
+  case AlpCat::SV1:
+  case AlpCat::REL:
+  case AlpCat::WHREL:
+  case AlpCat::CP:
+  case AlpCat::OTI:
+  case AlpCat::TI:
+  case AlpCat::WHSUB:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool is_verbal( AlpCat::Type cat ){
+  // the XPath also lists 'ppresent', which is no Alpino category
+  switch ( cat ){
+  case AlpCat::SMAIN:
+  case AlpCat::SSUB:
+  case AlpCat::SV1:
+  case AlpCat::INF:
+  case AlpCat::TI:
+  case AlpCat::PPART:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool has_nucl_sibling( const AlpinoTree& tree, int i ){
+  int p = tree[i].parent;
+  if ( p < 0 ){
+    return false;
+  }
+  for ( int j = tree[p].first_child; j >= 0; j = tree[j].next ){
+    if ( j != i && tree[j].rel == AlpRel::NUCL ){
+      return true;
+    }
+  }
+  return false;
+}
+
+// the clause nodes as the XPath expressions in xpathAlpinoTree find them,
+// below the node tree[context], or in the whole tree when context is -1
+struct Clauses {
+  vector<int> rel;      // relative clauses
+  vector<int> cp;       // adverbial clauses
+  vector<int> whsub;    // complement clauses:
+  vector<int> whrel;    //   not yet without the relative ones
+  vector<int> cp_compl; //   not yet without the adverbial ones
+  vector<int> ti;       // infinitive complements
+};
+
+static void find_clauses( const AlpinoTree& tree,
+			  const vector<bool>& below_cnj_ssub,
+			  int context, Clauses& cl ){
+  int first = context + 1;
+  int last = ( context < 0 ) ? tree.size() : tree[context].last;
+  for ( int y = first; y < last; ++y ){
+    const AlpinoNode& n = tree[y];
+    if ( n.cat == AlpCat::TI ){
+      cl.ti.push_back( y );
+    }
+    bool finite = ( n.cat == AlpCat::SSUB );
+    bool finite_sv1 = finite || n.cat == AlpCat::SV1;
+    int p = n.parent;
+    if ( finite_sv1 ){
+      // the ancestors of y, below the context
+      bool mod_rel = false;
+      bool mod_whrel = false;
+      bool mod_cp = false;
+      bool whsub = false;
+      bool whrel = false;
+      bool cp = false;
+      for ( int x = p; x >= 0 && x != context; x = tree[x].parent ){
+	const AlpinoNode& a = tree[x];
+	if ( a.rel == AlpRel::MOD ){
+	  mod_rel |= ( a.cat == AlpCat::REL );
+	  mod_whrel |= ( a.cat == AlpCat::WHREL );
+	  mod_cp |= ( a.cat == AlpCat::CP );
+	}
+	int q = a.parent;
+	if ( q >= 0 && q != context
+	     && tree[q].cat != AlpCat::NONE && tree[q].cat != AlpCat::TOP ){
+	  whsub |= ( a.cat == AlpCat::WHSUB );
+	  whrel |= ( a.cat == AlpCat::WHREL );
+	  cp |= ( a.cat == AlpCat::CP
+		  && a.rel != AlpRel::NONE && a.rel != AlpRel::SAT );
+	}
+      }
+      bool conj_rel = false;
+      bool conj_cp = false;
+      if ( p >= 0 && p != context && tree[p].rel == AlpRel::CNJ ){
+	bool below_mod_conj = false;
+	for ( int x = tree[p].parent; x >= 0 && x != context;
+	      x = tree[x].parent ){
+	  if ( tree[x].rel == AlpRel::MOD && tree[x].cat == AlpCat::CONJ ){
+	    below_mod_conj = true;
+	    break;
+	  }
+	}
+	if ( below_mod_conj ){
+	  conj_rel = ( tree[p].cat == AlpCat::REL
+		       || tree[p].cat == AlpCat::WHREL );
+	  conj_cp = ( tree[p].cat == AlpCat::CP );
+	}
+      }
+      if ( finite ){
+	if ( mod_rel ) cl.rel.push_back( y );
+	if ( mod_whrel ) cl.rel.push_back( y );
+	if ( conj_rel ) cl.rel.push_back( y );
+	if ( whsub ) cl.whsub.push_back( y );
+	if ( whrel ) cl.whrel.push_back( y );
+	if ( cp ) cl.cp_compl.push_back( y );
+      }
+      if ( mod_cp ) cl.cp.push_back( y );
+      if ( conj_cp ) cl.cp.push_back( y );
+    }
+    if ( ( n.cat == AlpCat::SV1 || n.cat == AlpCat::CP )
+	 && has_nucl_sibling( tree, y )
+	 && ( n.cat != AlpCat::CP || !below_cnj_ssub[y] ) ){
+      cl.cp.push_back( y );
+    }
+    if ( n.rel == AlpRel::CNJ && n.cat == AlpCat::SV1
+	 && p >= 0 && p != context
+	 && tree[p].rel == AlpRel::SAT && has_nucl_sibling( tree, p ) ){
+      cl.cp.push_back( y );
+    }
+    if ( n.rel == AlpRel::CNJ && n.cat == AlpCat::SSUB ){
+      for ( int x = p; x >= 0 && x != context; x = tree[x].parent ){
+	if ( tree[x].rel == AlpRel::SAT && has_nucl_sibling( tree, x ) ){
+	  cl.cp.push_back( y );
+	  break;
+	}
+      }
+    }
+  }
+}
+
+static vector<int> complement_nodes( const AlpinoTree& tree,
+				     vector<int> a, vector<int> b ){
+  // the nodes of a that are not in b, compared on their id, like
+  // complementNodes()
+  auto by_id = [&tree]( int x, int y ){ return tree[x].id < tree[y].id; };
+  sort( a.begin(), a.end(), by_id );
+  sort( b.begin(), b.end(), by_id );
+  vector<int> result;
+  set_difference( a.begin(), a.end(), b.begin(), b.end(),
+		  back_inserter( result ), by_id );
+  return result;
+}
+
+static vector<int> complement_clauses( const AlpinoTree& tree,
+				       const Clauses& cl ){
+  vector<int> result = cl.whsub;
+  vector<int> tmp = complement_nodes( tree, cl.whrel, cl.rel );
+  result.insert( result.end(), tmp.begin(), tmp.end() );
+  tmp = complement_nodes( tree, cl.cp_compl, cl.cp );
+  result.insert( result.end(), tmp.begin(), tmp.end() );
+  return result;
+}
+
+static void insert_ids( const AlpinoTree& tree, const vector<int>& nodes,
+			set<int>& ids ){
+  for ( const auto& n : nodes ){
+    ids.insert( tree[n].id );
+  }
+}
+
+static void finite_ids( const AlpinoTree& tree, const Clauses& cl,
+			set<int>& ids ){
+  insert_ids( tree, cl.rel, ids );
+  insert_ids( tree, cl.cp, ids );
+  insert_ids( tree, complement_clauses( tree, cl ), ids );
+}
+
+static int tree_d_level( const AlpinoTree& tree ){
+  // the same checks as tree_d_level( xmlDoc* ), all in one go
+  bool level6 = false;
+  bool level4 = false;
+  bool level3 = false;
+  bool level1 = false;
+  bool found4 = false;
+  for ( size_t i=0; i < tree.size(); ++i ){
+    const AlpinoNode& n = tree[i];
+    AlpRel::Type prel = tree.rel( n.parent );
+    AlpCat::Type pcat = tree.cat( n.parent );
+    if ( n.rel == AlpRel::MOD && n.cat == AlpCat::REL ){
+      level6 |= ( prel == AlpRel::SU );
+    }
+    else if ( n.rel == AlpRel::SU &&
+	      ( n.cat == AlpCat::CP
+		|| n.cat == AlpCat::WHSUB || n.cat == AlpCat::WHREL
+		|| n.cat == AlpCat::TI  || n.cat == AlpCat::OTI
+		|| n.cat == AlpCat::INF ) ){
+      level6 = true;
+    }
+    else if ( n.pos == AlpPos::VERB ){
+      level6 |= ( prel == AlpRel::SU && pcat == AlpCat::NP );
+    }
+    if ( level6 ){
+      return 6;
+    }
+    if ( n.rel == AlpRel::OBCOMP ){
+      level4 = true;
+    }
+    if ( n.rel == AlpRel::VC ){
+      for ( int c = n.first_child; c >= 0 && !found4; c = tree[c].next ){
+	found4 = tree[c].index >= 0 && tree[c].rel == AlpRel::SU;
+      }
+      if ( found4 && n.parent >= 0 ){
+	for ( int s = tree[n.parent].first_child; s >= 0; s = tree[s].next ){
+	  if ( s != (int)i
+	       && tree[s].index < 0 && tree[s].rel == AlpRel::OBJ ){
+	    level4 = true;
+	  }
+	}
+      }
+    }
+    if ( n.rel == AlpRel::MOD && n.cat == AlpCat::REL ){
+      level3 |= ( prel == AlpRel::OBJ1 );
+    }
+    else if ( n.pos == AlpPos::VERB ){
+      level3 |= ( prel == AlpRel::OBJ1 && pcat == AlpCat::NP );
+    }
+    else if ( n.rel == AlpRel::VC &&
+	      ( n.cat == AlpCat::CP || n.cat == AlpCat::WHSUB ) ){
+      level3 = true;
+    }
+    else if ( n.rel == AlpRel::SUP ){
+      level3 = true;
+    }
+    if ( n.rel == AlpRel::VC
+	 && ( n.cat == AlpCat::TI || n.cat == AlpCat::OTI
+	      || n.cat == AlpCat::INF ) ){
+      int su_node = tree.search( i, AlpRel::SU );
+      if ( su_node >= 0 && tree[su_node].index >= 0 && n.parent >= 0 ){
+	for ( int s = tree[n.parent].first_child; s >= 0; s = tree[s].next ){
+	  if ( s != (int)i && tree[s].rel == AlpRel::SU
+	       && tree[s].index == tree[su_node].index ){
+	    level1 = true;
+	  }
+	}
+      }
+    }
+  }
+  if ( level4 ) return 4;
+  if ( level3 ) return 3;
+  if ( level1 ) return 1;
+  return 0;
+}
+
+AlpinoTreeStats analyseAlpinoTree( const AlpinoTree& tree ){
+  AlpinoTreeStats ts;
+  // what is below each node
+  vector<bool> below_ssub( tree.size(), false );     // cat='ssub'
+  vector<bool> below_clause( tree.size(), false );   // a clause category
+  vector<bool> below_cnj_ssub( tree.size(), false ); // rel='cnj' and cat='ssub'
+  for ( int i = tree.size()-1; i >= 0; --i ){
+    const AlpinoNode& n = tree[i];
+    if ( n.parent >= 0 ){
+      if ( below_ssub[i] || n.cat == AlpCat::SSUB ){
+	below_ssub[n.parent] = true;
+      }
+      if ( below_clause[i] || is_clause( n.cat ) ){
+	below_clause[n.parent] = true;
+      }
+      if ( below_cnj_ssub[i]
+	   || ( n.rel == AlpRel::CNJ && n.cat == AlpCat::SSUB ) ){
+	below_cnj_ssub[n.parent] = true;
+      }
+    }
+  }
+  for ( size_t i=0; i < tree.size(); ++i ){
+    const AlpinoNode& n = tree[i];
+    if ( n.cat == AlpCat::SMAIN ) ++ts.smainCnt;
+    else if ( n.cat == AlpCat::SSUB ) ++ts.ssubCnt;
+    else if ( n.cat == AlpCat::SV1 ) ++ts.sv1Cnt;
+    if ( n.rel == AlpRel::CNJ ){
+      if ( n.cat == AlpCat::SMAIN ) ++ts.smainCnjCnt;
+      if ( n.cat == AlpCat::SSUB || below_ssub[i] ) ++ts.ssubCnjCnt;
+      if ( n.cat == AlpCat::SV1 ) ++ts.sv1CnjCnt;
+      if ( !is_clause( n.cat ) ) ++ts.smallCnjCnt;
+    }
+    if ( n.cat == AlpCat::CONJ && !below_clause[i] ){
+      --ts.smallCnjExtraCnt;
+    }
+    if ( ( n.rel == AlpRel::MOD || n.rel == AlpRel::PREDM )
+	 && is_verbal( tree.cat( n.parent ) ) ){
+      ++ts.vcModCnt;
+      if ( tree.has( n.word ) ){
+	ts.vcModWords.push_back( tree.str( n.word ) );
+      }
+    }
+    if ( n.cat == AlpCat::NP ){
+      for ( int j = n.first_child; j >= 0; j = tree[j].next ){
+	const AlpinoNode& c = tree[j];
+	if ( c.rel == AlpRel::MOD && c.pos == AlpPos::ADJ ){
+	  ++ts.adjNpModCnt;
+	}
+	string pt = tree.str( c.pt );
+	if ( ( c.rel == AlpRel::DET && ( pt == "tw" || pt == "n" ) )
+	     || c.rel == AlpRel::MOD || c.rel == AlpRel::APP
+	     || c.rel == AlpRel::VC ){
+	  ++ts.npModCnt;
+	}
+      }
+    }
+    if ( n.cat == AlpCat::SSUB ){
+      // 'loose' clauses, directly below the top node
+      bool los_betr = false;
+      bool los_bijw = false;
+      for ( int x = n.parent; x >= 0; x = tree[x].parent ){
+	if ( tree.cat( tree[x].parent ) == AlpCat::TOP ){
+	  los_betr |= ( tree[x].cat == AlpCat::REL
+			|| tree[x].cat == AlpCat::WHREL );
+	  los_bijw |= ( tree[x].cat == AlpCat::CP );
+	}
+      }
+      ts.losBetrCnt += los_betr;
+      ts.losBijwCnt += los_bijw;
+    }
+  }
+  ts.smallCnjExtraCnt += ts.smallCnjCnt;
+
+  Clauses cl;
+  find_clauses( tree, below_cnj_ssub, -1, cl );
+  vector<int> compl_nodes = complement_clauses( tree, cl );
+  ts.betrCnt = cl.rel.size();
+  ts.bijwCnt = cl.cp.size();
+  ts.complCnt = compl_nodes.size();
+  ts.infinComplCnt = cl.ti.size();
+
+  // the clauses embedded in these
+  set<int> embedders;
+  embedders.insert( cl.rel.begin(), cl.rel.end() );
+  embedders.insert( cl.cp.begin(), cl.cp.end() );
+  embedders.insert( compl_nodes.begin(), compl_nodes.end() );
+  set<int> ids;
+  set<int> all_ids;
+  for ( const auto& node : embedders ){
+    Clauses embedded;
+    find_clauses( tree, below_cnj_ssub, node, embedded );
+    finite_ids( tree, embedded, ids );
+    finite_ids( tree, embedded, all_ids );
+    insert_ids( tree, embedded.ti, all_ids );
+  }
+  ts.mvFinInbedCnt = ids.size();
+  for ( const auto& node : cl.ti ){
+    if ( embedders.find( node ) != embedders.end() ){
+      continue;
+    }
+    Clauses embedded;
+    find_clauses( tree, below_cnj_ssub, node, embedded );
+    finite_ids( tree, embedded, all_ids );
+    insert_ids( tree, embedded.ti, all_ids );
+  }
+  ts.mvInbedCnt = all_ids.size();
+
+  ts.dLevel = tree_d_level( tree );
+  return ts;
+}
+
+AlpinoTreeStats analyseAlpinoTree( xmlDoc *doc ){
+  return analyseAlpinoTree( AlpinoTree( doc ) );
+}
+
+/*************
+ * REFERENCE
+ *************/
+
+AlpinoTreeStats xpathAlpinoTree( xmlDoc *alpDoc ){
+  AlpinoTreeStats ts;
+  AlpinoQueries q( alpDoc );
+  ts.dLevel = tree_d_level( alpDoc );
+  mod_stats( q, ts.adjNpModCnt, ts.npModCnt );
+
+  // Adverbials
+  list<xmlNode*> nodes = getAdverbialNodes(q);
+  ts.vcModCnt = nodes.size();
+  for (auto& node : nodes) {
+    string word = TiCC::getAttribute(node, "word");
+    if (word != "") {
+      ts.vcModWords.push_back( word );
+    }
+  }
+
+  // Relative clauses
+  string hasFiniteVerb = "//node[@cat='ssub']";
+  string hasDirectFiniteVerb = "/node[@cat='ssub']";
+  string hasFiniteVerbSv1 = "//node[@cat='ssub' or @cat='sv1']";
+  string hasDirectFiniteVerbSv1 = "/node[@cat='ssub' or @cat='sv1']";
+
+  // Betrekkelijke/bijvoeglijke bijzinnen (zonder/met nevenschikking)
+  list<xmlNode*> relNodes = getNodesByRelCat(q, "mod", "rel", hasFiniteVerb);
+  relNodes.merge(getNodesByRelCat(q, "mod", "whrel", hasFiniteVerb));
+  string relConjPath = ".//node[@rel='mod' and @cat='conj']//node[@rel='cnj' and (@cat='rel' or @cat='whrel')]" + hasDirectFiniteVerb;
+  relNodes.merge(q.find(relConjPath));
+
+  // Bijwoordelijke bijzinnen (zonder/met nevenschikking + licht afwijkende bijzinnen)
+  list<xmlNode*> cpNodes = getNodesByRelCat(q, "mod", "cp", hasFiniteVerbSv1);
+  string cpConjPath = ".//node[@rel='mod' and @cat='conj']//node[@rel='cnj' and @cat='cp']" + hasDirectFiniteVerbSv1;
+  cpNodes.merge(q.find(cpConjPath));
+  string cpNuclAExtra = "(@cat!='cp' or not(descendant::node[@rel='cnj' and @cat='ssub']))";
+  string nuclPath = "(following-sibling::node[@rel='nucl'] or preceding-sibling::node[@rel='nucl'])";
+  string cpNuclAPath = ".//node[(@cat='sv1' or @cat='cp') and " + nuclPath + " and " + cpNuclAExtra + "]";
+  cpNodes.merge(q.find(cpNuclAPath));
+  string cpNuclBPath = ".//node[@rel='sat' and " + nuclPath + "]/node[@rel='cnj' and @cat='sv1']";
+  cpNodes.merge(q.find(cpNuclBPath));
+  string cpNuclCPath = ".//node[@rel='sat' and " + nuclPath + "]//node[@rel='cnj' and @cat='ssub']";
+  cpNodes.merge(q.find(cpNuclCPath));
+
+  // Finiete complementszinnen
+  // Check whether the previous node is not the top node to prevent clashes with loose clauses below
+  string notTop = ".//node[@cat!='top']";
+  string complWhsubPath = notTop + "/node[@cat='whsub']" + hasFiniteVerb;
+  string complWhrelPath = notTop + "/node[@cat='whrel']" + hasFiniteVerb;
+  string complCpPath = notTop + "/node[@rel!='sat' and @cat='cp']" + hasFiniteVerb;
+  list<xmlNode*> complNodes = q.find(complWhsubPath);
+  complNodes.merge(complementNodes(q.find(complWhrelPath), relNodes));
+  complNodes.merge(complementNodes(q.find(complCpPath), cpNodes));
+
+  // Infinietcomplementen
+  list<xmlNode*> tiNodes = getNodesByCat(q, "ti");
+
+  // Save counts
+  ts.betrCnt = relNodes.size();
+  ts.bijwCnt = cpNodes.size();
+  ts.complCnt = complNodes.size();
+  ts.infinComplCnt = tiNodes.size();
+
+  // Checks for embedded finite clauses
+  list<xmlNode*> allRelNodes (relNodes);
+  allRelNodes.merge(cpNodes);
+  allRelNodes.merge(complNodes);
+  list<string> ids;
+  for (auto& node : allRelNodes) {
+    list<xmlNode*> embedRelNodes = getNodesByRelCat(q, node, "mod", "rel", hasFiniteVerb);
+    embedRelNodes.merge(getNodesByRelCat(q, node, "mod", "whrel", hasFiniteVerb));
+    embedRelNodes.merge(q.find(node, relConjPath));
+    ids.merge(getNodeIds(embedRelNodes));
+
+    list<xmlNode*> embedCpNodes = getNodesByRelCat(q, node, "mod", "cp", hasFiniteVerbSv1);
+    embedCpNodes.merge(q.find(node, cpConjPath));
+    embedCpNodes.merge(q.find(node, cpNuclAPath));
+    embedCpNodes.merge(q.find(node, cpNuclBPath));
+    embedCpNodes.merge(q.find(node, cpNuclCPath));
+    ids.merge(getNodeIds(embedCpNodes));
+
+    ids.merge(getNodeIds(q.find(node, complWhsubPath)));
+    ids.merge(getNodeIds(complementNodes(q.find(node, complWhrelPath), embedRelNodes)));
+    ids.merge(getNodeIds(complementNodes(q.find(node, complCpPath), embedCpNodes)));
+  }
+  set<string> mvFinEmbedIds(ids.begin(), ids.end());
+  ts.mvFinInbedCnt = mvFinEmbedIds.size();
+
+  // Checks for all embedded clauses
+  allRelNodes.merge(tiNodes);
+  ids.clear();
+  for (auto& node : allRelNodes) {
+    list<xmlNode*> embedRelNodes = getNodesByRelCat(q, node, "mod", "rel", hasFiniteVerb);
+    embedRelNodes.merge(getNodesByRelCat(q, node, "mod", "whrel", hasFiniteVerb));
+    embedRelNodes.merge(q.find(node, relConjPath));
+    ids.merge(getNodeIds(embedRelNodes));
+
+    list<xmlNode*> embedCpNodes = getNodesByRelCat(q, node, "mod", "cp", hasFiniteVerbSv1);
+    embedCpNodes.merge(q.find(node, cpConjPath));
+    embedCpNodes.merge(q.find(node, cpNuclAPath));
+    embedCpNodes.merge(q.find(node, cpNuclBPath));
+    embedCpNodes.merge(q.find(node, cpNuclCPath));
+    ids.merge(getNodeIds(embedCpNodes));
+
+    ids.merge(getNodeIds(q.find(node, complWhsubPath)));
+    ids.merge(getNodeIds(complementNodes(q.find(node, complWhrelPath), embedRelNodes)));
+    ids.merge(getNodeIds(complementNodes(q.find(node, complCpPath), embedCpNodes)));
+
+    ids.merge(getNodeIds(getNodesByCat(q, node, "ti")));
+  }
+  set<string> mvInbedIds(ids.begin(), ids.end());
+  ts.mvInbedCnt = mvInbedIds.size();
+
+  // Count 'loose' (directly under top node) relative clauses
+  string losBetr = "//node[@cat='top']/node[@cat='rel' or @cat='whrel']" + hasFiniteVerb;
+  ts.losBetrCnt = q.find(losBetr).size();
+  string losBijw = "//node[@cat='top']/node[@cat='cp']" + hasFiniteVerb;
+  ts.losBijwCnt = q.find(losBijw).size();
+
+  // Finite verbs
+  ts.smainCnt = getNodesByCat(q, "smain").size();
+  ts.ssubCnt = getNodesByCat(q, "ssub").size();
+  ts.sv1Cnt = getNodesByCat(q, "sv1").size();
+
+  // Conjunctions
+  ts.smainCnjCnt = getNodesByRelCat(q, "cnj", "smain").size();
+  // For cnj-ssub, also allow that the cnj node dominates the ssub node
+  ts.ssubCnjCnt = q.find(".//node[@rel='cnj'][descendant-or-self::node[@cat='ssub']]").size();
+  ts.sv1CnjCnt = getNodesByRelCat(q, "cnj", "sv1").size();
+
+  // Small conjunctions have 'cnj' as relation and do not form a "bigger" sentence
+  string cats = "|smain|ssub|sv1|rel|whrel|cp|oti|ti|whsub|";
+  string smallCnjPath = ".//node[@rel='cnj' and not(contains('" + cats + "', concat('|', @cat, '|')))]";
+  ts.smallCnjCnt = q.find(smallCnjPath).size();
+
+  // smallCnjExtraCnt count elements that have 'conj' as a category and do not govern a "bigger" sentence
+  // This amount is then substracted from the number of small conjunctions.
+  string smallCnjExtraPath = ".//node[@cat='conj' and not(descendant::node[contains('" + cats + "', concat('|', @cat, '|'))])]";
+  ts.smallCnjExtraCnt = ts.smallCnjCnt - q.find(smallCnjExtraPath).size();
+  return ts;
+}
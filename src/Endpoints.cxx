@@ -0,0 +1,171 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include "ticcutils/StringOps.h"
+#include "tscan/Endpoints.h"
+
+using namespace std;
+
+Endpoints::Endpoints( const string& host, const string& port, int limit ):
+  cooldown( 30 )
+{
+  servers.push_back( Server( host, port, limit ) );
+}
+
+Endpoints::Endpoints( const TiCC::Configuration& cf, const string& section,
+		      const string& suffix, int limit ):
+  cooldown( 30 )
+{
+  string val = cf.lookUp( "servers" + suffix, section );
+  if ( val.empty() ){
+    servers.push_back( Server( cf.lookUp( "host" + suffix, section ),
+			       cf.lookUp( "port" + suffix, section ),
+			       limit ) );
+  }
+  else {
+    vector<string> parts;
+    TiCC::split_at( val, parts, "," );
+    for ( const auto& part : parts ){
+      vector<string> fields;
+      size_t n = TiCC::split_at( TiCC::trim( part ), fields, ":" );
+      int server_limit = limit;
+      if ( n < 2 || n > 3
+	   || ( n == 3 && ( !TiCC::stringTo( fields[2], server_limit )
+			    || server_limit < 0 ) ) ){
+	cerr << "invalid value for 'servers" << suffix
+	     << "' in config file" << endl;
+	exit( EXIT_FAILURE );
+      }
+      servers.push_back( Server( fields[0], fields[1], server_limit ) );
+    }
+  }
+  val = cf.lookUp( "cooldown", section );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, cooldown ) ){
+      cerr << "invalid value for 'cooldown' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+}
+
+int Endpoints::capacity() const {
+  int result = 0;
+  for ( const auto& s : servers ){
+    if ( s.limit == 0 ){
+      return 0;
+    }
+    result += s.limit;
+  }
+  return result;
+}
+
+double Endpoints::mean_rate() const {
+  // called with the lock held. 0 when no rate is learned yet
+  double sum = 0;
+  int learned = 0;
+  for ( const auto& s : servers ){
+    if ( s.rate > 0 ){
+      sum += s.rate;
+      ++learned;
+    }
+  }
+  return learned == 0 ? 0 : sum / learned;
+}
+
+int Endpoints::pick() const {
+  // called with the lock held. returns -1 when no server has room.
+  // Of the others the one that is expected to finish a new request first:
+  // its outstanding requests plus the new one, times its rate. A server
+  // without a learned rate is taken to be as fast as the average.
+  auto now = chrono::steady_clock::now();
+  bool all_out = all_of( servers.begin(), servers.end(),
+			 [now]( const Server& s ){ return now < s.retry_at; } );
+  double mean = mean_rate();
+  int best = -1;
+  double best_load = 0;
+  for ( size_t i=0; i < servers.size(); ++i ){
+    const Server& s = servers[i];
+    if ( ( s.limit > 0 && s.outstanding >= s.limit )
+	 || ( !all_out && now < s.retry_at ) ){
+      continue;
+    }
+    double rate = s.rate > 0 ? s.rate : ( mean > 0 ? mean : 1 );
+    double load = ( s.outstanding + 1 ) * rate;
+    if ( best < 0 || load < best_load ){
+      best = i;
+      best_load = load;
+    }
+  }
+  return best;
+}
+
+int Endpoints::acquire(){
+  unique_lock<mutex> l( lock );
+  int i;
+  while ( ( i = pick() ) < 0 ){
+    // a server may also come back when its cooldown ends
+    released.wait_for( l, chrono::seconds( 1 ) );
+  }
+  ++servers[i].outstanding;
+  return i;
+}
+
+void Endpoints::release( int i, bool ok ){
+  {
+    lock_guard<mutex> l( lock );
+    Server& s = servers[i];
+    --s.outstanding;
+    if ( ok ){
+      s.retry_at = chrono::steady_clock::time_point();
+    }
+    else if ( servers.size() > 1 ){
+      cerr << "server " << name( i ) << " failed, it is not used for "
+	   << cooldown << " seconds" << endl;
+      s.retry_at = chrono::steady_clock::now() + chrono::seconds( cooldown );
+    }
+  }
+  released.notify_all();
+}
+
+void Endpoints::learn( int i, size_t units, double seconds ){
+  // a moving average, so the rate follows a server that gets busier
+  if ( units == 0 ){
+    return;
+  }
+  lock_guard<mutex> l( lock );
+  Server& s = servers[i];
+  double per_unit = seconds / units;
+  if ( s.rate == 0 ){
+    s.rate = per_unit;
+  }
+  else {
+    s.rate = 0.8 * s.rate + 0.2 * per_unit;
+  }
+}
+
+double Endpoints::estimate( size_t units ){
+  lock_guard<mutex> l( lock );
+  return units * mean_rate();
+}
@@ -0,0 +1,402 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "ticcutils/StringOps.h"
+#include "ticcutils/Unicode.h"
+#include "ticcutils/XMLtools.h"
+#include "tscan/FrogTree.h"
+
+using namespace std;
+
+const string frog_dep_set = "http://ilk.uvt.nl/folia/sets/frog-depparse-nl";
+
+struct DepWord {
+  DepWord(): head(-1) {};
+  bool has( const string& feat ) const {
+    return find( feats.begin(), feats.end(), feat ) != feats.end();
+  }
+  string word;
+  string lemma;
+  string tag;           // the CGN head, like 'WW'
+  vector<string> feats; // the CGN features, like 'pv' and 'tgw'
+  int head;             // -1 for a root
+  string rel;
+  vector<int> deps;
+};
+
+static void set_att( xmlNode *node, const string& att, const string& val ){
+  xmlSetProp( node, (const xmlChar*)att.c_str(), (const xmlChar*)val.c_str() );
+}
+
+static string alpino_pos( const DepWord& w, const string& rel ){
+  // the Alpino 'pos' that comes closest to a CGN tag
+  if ( w.tag == "N" ){
+    return w.has( "eigen" ) ? "name" : "noun";
+  }
+  if ( w.tag == "SPEC" ){
+    return w.has( "deeleigen" ) ? "name" : "noun";
+  }
+  if ( w.tag == "VZ" ){
+    return rel == "svp" ? "part" : "prep";
+  }
+  if ( w.tag == "VG" ){
+    return w.has( "onder" ) ? "comp" : "vg";
+  }
+  static const map<string,string> pos = {
+    { "ADJ", "adj" }, { "BW", "adv" }, { "LET", "punct" }, { "LID", "det" },
+    { "TSW", "tag" }, { "TW", "num" }, { "VNW", "pron" }, { "WW", "verb" } };
+  auto it = pos.find( w.tag );
+  if ( it != pos.end() ){
+    return it->second;
+  }
+  return "";
+}
+
+static string leaf_lcat( const DepWord& w, const string& pos ){
+  // the category of a phrase of this word alone
+  if ( pos == "noun" || pos == "name" || pos == "pron" ){
+    return "np";
+  }
+  if ( pos == "adj" ){
+    return "ap";
+  }
+  if ( pos == "adv" ){
+    return "advp";
+  }
+  if ( pos == "part" ){
+    return "part";
+  }
+  if ( pos == "prep" ){
+    return "pp";
+  }
+  if ( pos == "verb" ){
+    if ( w.has( "vd" ) ){
+      return "ppart";
+    }
+    if ( w.has( "inf" ) ){
+      return "inf";
+    }
+    return "smain";
+  }
+  return "";
+}
+
+class FrogTreeBuilder {
+public:
+  explicit FrogTreeBuilder( const vector<DepWord>& w ):
+    words( w ), done( w.size(), false ) {};
+  void phrase( xmlNode *, int, const string&, bool );
+  void leaf( xmlNode *, int, const string& );
+  bool placed( int i ) const { return done[i]; };
+private:
+  xmlNode *node( xmlNode *, const string&, const string& );
+  void dependents( xmlNode *, int, const string&, bool, vector<int> );
+  string category( int, bool, const vector<int>& ) const;
+  const vector<DepWord>& words;
+  vector<bool> done;
+};
+
+xmlNode *FrogTreeBuilder::node( xmlNode *parent, const string& rel,
+				const string& cat ){
+  xmlNode *result = xmlNewChild( parent, 0, (const xmlChar*)"node", 0 );
+  set_att( result, "rel", rel );
+  if ( !cat.empty() ){
+    set_att( result, "cat", cat );
+  }
+  return result;
+}
+
+void FrogTreeBuilder::leaf( xmlNode *parent, int i, const string& rel ){
+  const DepWord& w = words[i];
+  done[i] = true;
+  xmlNode *n = node( parent, rel, "" );
+  string pos = alpino_pos( w, rel );
+  set_att( n, "begin", TiCC::toString( i ) );
+  set_att( n, "end", TiCC::toString( i+1 ) );
+  set_att( n, "word", w.word );
+  set_att( n, "lemma", w.lemma );
+  set_att( n, "root", w.lemma );
+  set_att( n, "pt", TiCC::lowercase( w.tag ) );
+  if ( !pos.empty() ){
+    set_att( n, "pos", pos );
+    string lcat = leaf_lcat( w, pos );
+    if ( !lcat.empty() ){
+      set_att( n, "lcat", lcat );
+    }
+  }
+  if ( w.lemma == "worden" ){
+    // a passive, when it governs a past participle
+    for ( const auto& d : w.deps ){
+      if ( words[d].rel == "vc" && words[d].tag == "WW"
+	   && words[d].has( "vd" ) ){
+	set_att( n, "sc", "passive" );
+      }
+    }
+  }
+}
+
+string FrogTreeBuilder::category( int i, bool main,
+				  const vector<int>& deps ) const {
+  const DepWord& w = words[i];
+  if ( w.tag == "WW" ){
+    if ( w.has( "vd" ) ){
+      return "ppart";
+    }
+    if ( w.has( "inf" ) ){
+      return "inf";
+    }
+    if ( !main ){
+      return "ssub";
+    }
+    // a finite verb in front: a question or an imperative
+    if ( all_of( deps.begin(), deps.end(), [i]( int d ){ return d > i; } ) ){
+      return "sv1";
+    }
+    return "smain";
+  }
+  if ( w.tag == "VG" ){
+    return w.has( "onder" ) ? "cp" : "conj";
+  }
+  if ( w.tag == "N" || w.tag == "VNW" || w.tag == "SPEC"
+       || w.tag == "LID" || w.tag == "TW" ){
+    return "np";
+  }
+  if ( w.tag == "ADJ" ){
+    return "ap";
+  }
+  if ( w.tag == "BW" ){
+    return "advp";
+  }
+  if ( w.tag == "VZ" ){
+    return "pp";
+  }
+  return "du";
+}
+
+void FrogTreeBuilder::phrase( xmlNode *parent, int i, const string& rel,
+			      bool main ){
+  // the phrase headed by word i
+  if ( done[i] ){
+    return;
+  }
+  const DepWord& w = words[i];
+  vector<int> conj;
+  vector<int> rest;
+  for ( const auto& d : w.deps ){
+    if ( words[d].rel == "cnj" || words[d].rel == "crd" ){
+      conj.push_back( d );
+    }
+    else {
+      rest.push_back( d );
+    }
+  }
+  if ( !conj.empty() && w.tag != "VG" ){
+    // Frog makes the first conjunct the head of the others. Alpino puts
+    // all of them below one conj node.
+    xmlNode *c = node( parent, rel, "conj" );
+    dependents( c, i, "cnj", main, rest );
+    for ( const auto& d : conj ){
+      phrase( c, d, words[d].rel, main );
+    }
+    return;
+  }
+  dependents( parent, i, rel, main, w.deps );
+}
+
+void FrogTreeBuilder::dependents( xmlNode *parent, int i, const string& rel,
+				  bool main, vector<int> deps ){
+  // word i with the given dependents
+  const DepWord& w = words[i];
+  if ( deps.empty() ){
+    leaf( parent, i, rel );
+    return;
+  }
+  if ( w.tag == "WW" ){
+    // a complementizer below the verb: Alpino puts it above the clause
+    auto cmp = find_if( deps.begin(), deps.end(),
+			[this]( int d ){ return words[d].rel == "cmp"; } );
+    if ( cmp != deps.end() ){
+      int c = *cmp;
+      deps.erase( cmp );
+      xmlNode *n = node( parent, rel, w.has( "inf" ) ? "ti" : "cp" );
+      phrase( n, c, "cmp", false );
+      dependents( n, i, "body", false, deps );
+      return;
+    }
+    if ( !main && rel == "mod" && w.has( "pv" ) ){
+      // a relative clause, when it starts with a relative pronoun
+      auto rhd = find_if( deps.begin(), deps.end(),
+			  [this,i]( int d ){
+			    return d < i && words[d].tag == "VNW"
+			      && words[d].has( "betr" ); } );
+      if ( rhd != deps.end() ){
+	int r = *rhd;
+	deps.erase( rhd );
+	xmlNode *n = node( parent, rel, "rel" );
+	phrase( n, r, "rhd", false );
+	dependents( n, i, "body", false, deps );
+	return;
+      }
+    }
+  }
+  done[i] = true;
+  xmlNode *n = node( parent, rel, category( i, main, deps ) );
+  string head_rel = "hd";
+  if ( w.tag == "VG" ){
+    head_rel = w.has( "onder" ) ? "cmp" : "crd";
+  }
+  vector<int> children = deps;
+  children.push_back( i );
+  sort( children.begin(), children.end() );
+  for ( const auto& c : children ){
+    if ( c == i ){
+      leaf( n, i, head_rel );
+    }
+    else {
+      // only the conjuncts of a main clause are main clauses
+      phrase( n, c, words[c].rel, main && words[c].rel == "cnj" );
+    }
+  }
+}
+
+static void finish( xmlNode *node, int& id, int& begin, int& end ){
+  // number the nodes in document order, and give every phrase the span
+  // of its words
+  set_att( node, "id", TiCC::toString( id++ ) );
+  string b = TiCC::getAttribute( node, "begin" );
+  if ( !b.empty() ){
+    begin = TiCC::stringTo<int>( b );
+    end = TiCC::stringTo<int>( TiCC::getAttribute( node, "end" ) );
+    return;
+  }
+  begin = -1;
+  end = -1;
+  for ( xmlNode *c = node->children; c; c = c->next ){
+    int b;
+    int e;
+    finish( c, id, b, e );
+    if ( begin < 0 || b < begin ){
+      begin = b;
+    }
+    end = max( end, e );
+  }
+  set_att( node, "begin", TiCC::toString( begin ) );
+  set_att( node, "end", TiCC::toString( end ) );
+}
+
+xmlDoc *frogDependencyTree( const folia::Sentence *s, const string& pos_set,
+			    const string& lemma_set ){
+  vector<folia::Dependency*> deps = s->select<folia::Dependency>( frog_dep_set );
+  if ( deps.empty() ){
+    return 0;
+  }
+  vector<folia::Word*> wv = s->words();
+  vector<DepWord> words( wv.size() );
+  map<const folia::FoliaElement*,int> position;
+  for ( size_t i=0; i < wv.size(); ++i ){
+    position[wv[i]] = i;
+    words[i].word = TiCC::UnicodeToUTF8( wv[i]->text() );
+    words[i].lemma = wv[i]->lemma( lemma_set );
+    vector<folia::PosAnnotation*> posV = wv[i]->select<folia::PosAnnotation>( pos_set );
+    if ( posV.size() == 1 ){
+      words[i].tag = posV[0]->feat( "head" );
+      string cls = posV[0]->cls();
+      string::size_type open = cls.find( '(' );
+      string::size_type close = cls.rfind( ')' );
+      if ( open != string::npos && close != string::npos && close > open ){
+	TiCC::split_at( cls.substr( open+1, close-open-1 ),
+			words[i].feats, "," );
+      }
+    }
+  }
+  for ( const auto& dep : deps ){
+    vector<folia::Headspan*> hv = dep->select<folia::Headspan>();
+    vector<folia::DependencyDependent*> dv
+      = dep->select<folia::DependencyDependent>();
+    if ( hv.size() != 1 || dv.size() != 1 ){
+      continue;
+    }
+    vector<folia::FoliaElement*> hw = hv[0]->wrefs();
+    vector<folia::FoliaElement*> dw = dv[0]->wrefs();
+    if ( hw.empty() || dw.empty()
+	 || position.find( hw[0] ) == position.end()
+	 || position.find( dw[0] ) == position.end() ){
+      continue;
+    }
+    int d = position[dw[0]];
+    words[d].head = position[hw[0]];
+    words[d].rel = TiCC::lowercase( dep->cls() );
+  }
+  for ( size_t i=0; i < words.size(); ++i ){
+    // Alpino puts the punctuation directly below the top
+    int h = words[i].head;
+    if ( h >= 0 && h != (int)i
+	 && words[i].tag != "LET" && words[h].tag != "LET" ){
+      words[h].deps.push_back( i );
+    }
+    else {
+      words[i].head = -1;
+    }
+  }
+  xmlDoc *doc = xmlNewDoc( (const xmlChar*)"1.0" );
+  xmlNode *root = xmlNewDocNode( doc, 0, (const xmlChar*)"alpino_ds", 0 );
+  xmlDocSetRootElement( doc, root );
+  set_att( root, "version", "1.3" );
+  set_att( root, "syntax", "frog" );
+  xmlNode *top = xmlNewChild( root, 0, (const xmlChar*)"node", 0 );
+  set_att( top, "cat", "top" );
+  set_att( top, "rel", "top" );
+  FrogTreeBuilder builder( words );
+  for ( size_t i=0; i < words.size(); ++i ){
+    if ( words[i].head < 0 ){
+      if ( words[i].tag == "LET" ){
+	builder.leaf( top, i, "--" );
+      }
+      else {
+	builder.phrase( top, i, "--", true );
+      }
+    }
+  }
+  for ( size_t i=0; i < words.size(); ++i ){
+    // not reached from a root, when the heads form a cycle
+    if ( !builder.placed( i ) ){
+      builder.phrase( top, i, "--", true );
+    }
+  }
+  if ( !top->children ){
+    xmlFreeDoc( doc );
+    return 0;
+  }
+  int id = 0;
+  int begin;
+  int end;
+  finish( top, id, begin, end );
+  set_att( top, "begin", "0" );
+  set_att( top, "end", TiCC::toString( words.size() ) );
+  xmlNewTextChild( root, 0, (const xmlChar*)"sentence",
+		   (const xmlChar*)TiCC::UnicodeToUTF8( s->toktext() ).c_str() );
+  return doc;
+}
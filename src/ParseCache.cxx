@@ -0,0 +1,248 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "libxml/parser.h"
+#include "ticcutils/FileUtils.h"
+#include "tscan/ParseCache.h"
+
+using namespace std;
+
+//#define DEBUG_CACHE
+
+static uint64_t fnv( const string& s, uint64_t h ){
+  // FNV-1a, with a caller supplied offset basis
+  for ( const auto& c : s ){
+    h ^= (unsigned char)c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+ParseCache::ParseCache( const string& d, const string& id, uint64_t size ):
+  dir( d ),
+  identity( id ),
+  max_size( size ),
+  added( 0 ),
+  _hits( 0 ),
+  _misses( 0 )
+{
+  if ( dir.empty() || dir[dir.length()-1] != '/' ){
+    dir += "/";
+  }
+  if ( !TiCC::createPath( dir ) ){
+    cerr << "unable to create the parse cache in " << dir << endl;
+    exit( EXIT_FAILURE );
+  }
+}
+
+string ParseCache::filename( const string& sentence ) const {
+  string key = identity + "\n" + sentence;
+  ostringstream os;
+  os << hex << setfill('0')
+     << setw(16) << fnv( key, 14695981039346656037ULL )
+     << setw(16) << fnv( key, 0x6c62272e07bb0142ULL );
+  string h = os.str();
+  // spread the files over 256 directories
+  return dir + h.substr( 0, 2 ) + "/" + h + ".xml.gz";
+}
+
+static string tokens( const string& s ){
+  // the tokens of a sentence, separated by one space
+  istringstream is( s );
+  string result;
+  string token;
+  while ( is >> token ){
+    if ( !result.empty() ){
+      result += " ";
+    }
+    result += token;
+  }
+  return result;
+}
+
+static string parsed_sentence( xmlDoc *doc ){
+  // the text of the <sentence> element of an Alpino parse
+  xmlNode *root = xmlDocGetRootElement( doc );
+  for ( xmlNode *pnt = root ? root->children : 0; pnt; pnt = pnt->next ){
+    if ( pnt->type == XML_ELEMENT_NODE
+	 && xmlStrEqual( pnt->name, (const xmlChar*)"sentence" ) ){
+      xmlChar *content = xmlNodeGetContent( pnt );
+      string result = content ? (const char*)content : "";
+      xmlFree( content );
+      return result;
+    }
+  }
+  return "";
+}
+
+xmlDoc *ParseCache::lookup( const string& sentence ){
+  string file = filename( sentence );
+  if ( access( file.c_str(), R_OK ) != 0 ){
+    ++_misses;
+    return 0;
+  }
+  xmlDoc *doc = xmlReadFile( file.c_str(), 0, XML_PARSE_NOBLANKS );
+  if ( !doc ){
+    // damaged. parse again
+    remove( file.c_str() );
+    ++_misses;
+    return 0;
+  }
+  if ( tokens( parsed_sentence( doc ) ) != tokens( sentence ) ){
+    // the parse of another sentence with the same hash
+#ifdef DEBUG_CACHE
+    cerr << "parse cache collision: " << file << endl;
+#endif
+    xmlFreeDoc( doc );
+    ++_misses;
+    return 0;
+  }
+  // mark as recently used
+  utime( file.c_str(), 0 );
+  ++_hits;
+#ifdef DEBUG_CACHE
+  cerr << "parse cache hit: " << file << endl;
+#endif
+  return doc;
+}
+
+void ParseCache::store( const string& sentence, xmlDoc *doc ){
+  if ( !doc ){
+    return;
+  }
+  string file = filename( sentence );
+  string subdir = file.substr( 0, file.rfind( '/' ) + 1 );
+  if ( !TiCC::isDir( subdir ) && !TiCC::createPath( subdir ) ){
+    cerr << "parse cache: unable to create " << subdir << endl;
+    return;
+  }
+  ostringstream tmp;
+  tmp << file << ".tmp." << getpid() << "." << this_thread::get_id();
+  int mode = xmlGetDocCompressMode( doc );
+  xmlSetDocCompressMode( doc, 9 );
+  int res = xmlSaveFile( tmp.str().c_str(), doc );
+  xmlSetDocCompressMode( doc, mode );
+  if ( res < 0 || rename( tmp.str().c_str(), file.c_str() ) != 0 ){
+    remove( tmp.str().c_str() );
+    return;
+  }
+  struct stat sbuf;
+  if ( stat( file.c_str(), &sbuf ) == 0 ){
+    added += sbuf.st_size;
+  }
+  if ( added > max_size / 10 ){
+    evict();
+  }
+}
+
+struct cache_file {
+  string name;
+  time_t used;
+  off_t size;
+};
+
+void ParseCache::evict(){
+  // only one thread per process, and one process per cache, at a time
+  unique_lock<mutex> lock( evict_lock, try_to_lock );
+  if ( !lock.owns_lock() ){
+    return;
+  }
+  string lockfile = dir + "evict.lock";
+  int fd = open( lockfile.c_str(), O_CREAT|O_RDWR, 0666 );
+  if ( fd < 0 ){
+    return;
+  }
+  if ( flock( fd, LOCK_EX|LOCK_NB ) != 0 ){
+    close( fd );
+    return;
+  }
+  added = 0;
+  vector<cache_file> files;
+  uint64_t total = 0;
+  DIR *top = opendir( dir.c_str() );
+  struct dirent *sub;
+  while ( top && ( sub = readdir( top ) ) ){
+    if ( sub->d_name[0] == '.' ){
+      continue;
+    }
+    string subdir = dir + sub->d_name + "/";
+    DIR *d = opendir( subdir.c_str() );
+    struct dirent *entry;
+    while ( d && ( entry = readdir( d ) ) ){
+      cache_file cf;
+      cf.name = subdir + entry->d_name;
+      if ( entry->d_name[0] == '.'
+	   || cf.name.find( ".tmp." ) != string::npos ){
+	// files that are being written are left alone
+	continue;
+      }
+      struct stat sbuf;
+      if ( stat( cf.name.c_str(), &sbuf ) == 0 ){
+	cf.used = sbuf.st_mtime;
+	cf.size = sbuf.st_size;
+	total += cf.size;
+	files.push_back( cf );
+      }
+    }
+    if ( d ){
+      closedir( d );
+    }
+  }
+  if ( top ){
+    closedir( top );
+  }
+#ifdef DEBUG_CACHE
+  cerr << "parse cache: " << files.size() << " files, " << total
+       << " bytes" << endl;
+#endif
+  if ( total > max_size ){
+    // remove the least recently used files, until 90% of the limit
+    sort( files.begin(), files.end(),
+	  []( const cache_file& a, const cache_file& b ){
+	    return a.used < b.used; } );
+    uint64_t target = max_size / 10 * 9;
+    for ( const auto& cf : files ){
+      if ( total <= target ){
+	break;
+      }
+      if ( remove( cf.name.c_str() ) == 0 ){
+	total -= cf.size;
+      }
+    }
+  }
+  flock( fd, LOCK_UN );
+  close( fd );
+}
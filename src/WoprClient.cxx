@@ -0,0 +1,213 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <cmath>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include "ticcutils/StringOps.h"
+#include "ticcutils/SocketBasics.h"
+#include "libfolia/folia.h"
+#include "tscan/WoprClient.h"
+
+using namespace std;
+
+//#define DEBUG_WOPR
+
+WoprResult::WoprResult():
+  sent_prob( NAN ),
+  entropy( NAN ),
+  perplexity( NAN )
+{}
+
+WoprClient::WoprClient( Endpoints& e ):
+  servers( e )
+{}
+
+static void set_metric( const folia::Metric *m, double& val ){
+  string v = m->feat("value");
+  if ( v != "nan" ){
+    val = TiCC::stringTo<double>( v );
+  }
+}
+
+static bool exchange( Sockets::ClientSocket& client,
+		      const vector<string>& sents,
+		      vector<WoprResult>& results ){
+  cerr << "calling Wopr for " << sents.size() << " sentence(s)" << endl;
+  string txt;
+  for ( const auto& sent : sents ){
+    txt += sent + "\n";
+  }
+  client.write( txt + "\n" );
+  string result;
+  string s;
+  while ( client.read(s) ){
+    result += s + "\n";
+  }
+#ifdef DEBUG_WOPR
+  cerr << "received data [" << result << "]" << endl;
+#endif
+  if ( result.size() <= 10 ){
+    cerr << "No usable FoLia data retrieved from Wopr. Got '"
+	 << result << "'" << endl;
+    return false;
+  }
+  folia::Document doc;
+  try {
+    doc.readFromString( result );
+    vector<folia::Sentence*> sv = doc.sentences();
+    if ( sv.size() != sents.size() ){
+      cerr << "Wopr returned " << sv.size() << " sentences for "
+	   << sents.size() << " input sentences" << endl;
+      return false;
+    }
+    results.assign( sv.size(), WoprResult() );
+    for ( size_t i=0; i < sv.size(); ++i ){
+      vector<folia::Word*> wv = sv[i]->words();
+      results[i].word_probs.resize( wv.size(), NAN );
+      for ( size_t j=0; j < wv.size(); ++j ){
+	vector<folia::Metric*> mv = wv[j]->select<folia::Metric>();
+	for ( const auto& m : mv ){
+	  if ( m->cls() == "lprob10" ){
+	    results[i].word_probs[j] = TiCC::stringTo<double>( m->feat("value") );
+	  }
+	}
+      }
+      vector<folia::Metric*> mv = sv[i]->select<folia::Metric>();
+      for ( const auto& m : mv ){
+	if ( m->cls() == "avg_prob10" ){
+	  set_metric( m, results[i].sent_prob );
+	}
+	else if ( m->cls() == "entropy" ){
+	  set_metric( m, results[i].entropy );
+	}
+	else if ( m->cls() == "perplexity" ){
+	  set_metric( m, results[i].perplexity );
+	}
+      }
+    }
+  }
+  catch ( std::exception& e ){
+    cerr << "FoLiaParsing failed:" << endl
+	 << e.what() << endl;
+    return false;
+  }
+  cerr << "done with Wopr" << endl;
+  return true;
+}
+
+bool WoprClient::request( const vector<string>& sents,
+			  vector<WoprResult>& results ){
+  // when a server can't be reached or gives no usable answer, try the
+  // next one
+  for ( size_t attempt=0; attempt < servers.size(); ++attempt ){
+    int server = servers.acquire();
+    Sockets::ClientSocket client;
+    if ( !client.connect( servers.host( server ), servers.port( server ) ) ){
+      cerr << "failed to open Wopr connection: "<< servers.name( server )
+	   << endl;
+      cerr << "Reason: " << client.getMessage() << endl;
+      servers.release( server, false );
+      continue;
+    }
+    bool ok = exchange( client, sents, results );
+    servers.release( server, ok );
+    if ( ok ){
+      return true;
+    }
+  }
+  return false;
+}
+
+WoprBatch::WoprBatch( const TiCC::Configuration& cf,
+		      Endpoints& fwd_servers, Endpoints& bwd_servers,
+		      const vector<string>& sents ):
+  sentences( sents ),
+  chunk_size( sents.size() ),
+  fwd( sents.size() ),
+  bwd( sents.size() ),
+  done( sents.size(), 0 )
+{
+  string val = cf.lookUp( "batch", "wopr" );
+  if ( !val.empty() ){
+    size_t size = 0;
+    if ( !TiCC::stringTo( val, size ) ){
+      cerr << "invalid value for 'batch' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+    if ( size > 0 ){
+      chunk_size = size;
+    }
+  }
+  if ( sentences.empty() ){
+    return;
+  }
+  WoprClient fwd_client( fwd_servers );
+  WoprClient bwd_client( bwd_servers );
+  workers.push_back( thread( &WoprBatch::work, this,
+			     fwd_client, std::ref(fwd) ) );
+  workers.push_back( thread( &WoprBatch::work, this,
+			     bwd_client, std::ref(bwd) ) );
+}
+
+WoprBatch::~WoprBatch(){
+  for ( auto& w : workers ){
+    w.join();
+  }
+}
+
+void WoprBatch::work( WoprClient client, vector<WoprResult>& results ){
+  for ( size_t start=0; start < sentences.size(); start += chunk_size ){
+    size_t end = min( start + chunk_size, sentences.size() );
+    vector<string> chunk( sentences.begin() + start,
+			  sentences.begin() + end );
+    vector<WoprResult> res;
+    if ( !client.request( chunk, res ) ){
+      // fall back to one request per sentence
+      res.assign( chunk.size(), WoprResult() );
+      if ( chunk.size() > 1 ){
+	for ( size_t i=0; i < chunk.size(); ++i ){
+	  vector<WoprResult> one;
+	  if ( client.request( vector<string>( 1, chunk[i] ), one ) ){
+	    res[i] = one[0];
+	  }
+	}
+      }
+    }
+    {
+      lock_guard<mutex> l( lock );
+      for ( size_t i=start; i < end; ++i ){
+	results[i] = res[i-start];
+	++done[i];
+      }
+    }
+    ready.notify_all();
+  }
+}
+
+void WoprBatch::result( size_t i, WoprResult& f, WoprResult& b ){
+  unique_lock<mutex> l( lock );
+  ready.wait( l, [this,i]{ return done[i] == 2; } );
+  f = fwd[i];
+  b = bwd[i];
+}
@@ -21,78 +21,123 @@ double docStats::rarity( int level ) const {
  * CSV OUTPUT
  ************/
 
+const string csv_extension( csvKind what ){
+  switch ( what ){
+  case DOC_CSV:
+    return ".document.csv";
+  case PAR_CSV:
+    return ".paragraphs.csv";
+  case SENT_CSV:
+    return ".sentences.csv";
+  case WORD_CSV:
+    return ".words.csv";
+  }
+  return ".csv";
+}
+
+const string csv_label( csvKind what ){
+  switch ( what ){
+  case DOC_CSV:
+    return "document";
+  case PAR_CSV:
+    return "paragraph";
+  case SENT_CSV:
+    return "sentence";
+  case WORD_CSV:
+    return "word";
+  }
+  return "unknown";
+}
+
 void docStats::toCSV( const string& name, csvKind what ) const {
+  string fname = name + csv_extension( what );
+  ofstream out( fname.c_str() );
+  if ( out ){
+    toCSV( out, name, what );
+    cerr << "stored " << csv_label( what ) << " statistics in "
+	 << fname << endl;
+  }
+  else {
+    cerr << "storing " << csv_label( what ) << " statistics in "
+	 << fname << " FAILED!" << endl;
+  }
+}
+
+/**
+ * Writes the .csv-output of kind 'what' to a stream.
+ * @param out  the outputstream
+ * @param name the value of the 'Inputfile' column
+ * @param what which of the four tables to write
+ */
+void docStats::toCSV( ostream& out, const string& name, csvKind what ) const {
   if ( what == DOC_CSV ){
-    string fname = name + ".document.csv";
-    ofstream out( fname.c_str() );
-    if ( out ){
-      // 20141003: New features: paragraphs/sentences/words per document
-      CSVheader( out, "Inputfile,Par_per_doc,Zin_per_doc,Word_per_doc" );
-      out << name << "," << sv.size() << ",";
-      structStats::toCSV( out );
-      cerr << "stored document statistics in " << fname << endl;
-    }
-    else {
-      cerr << "storing document statistics in " << fname << " FAILED!" << endl;
-    }
+    // 20141003: New features: paragraphs/sentences/words per document
+    CSVheader( out, "Inputfile,Par_per_doc,Zin_per_doc,Word_per_doc" );
+    out << name << "," << sv.size() << ",";
+    structStats::toCSV( out );
   }
   else if ( what == PAR_CSV ){
-    string fname = name + ".paragraphs.csv";
-    ofstream out( fname.c_str() );
-    if ( out ){
-      for ( size_t par=0; par < sv.size(); ++par ){
-	if ( par == 0 )
-    // 20141003: New features: sentences/words per paragraph
-	  sv[0]->CSVheader( out, "Inputfile,Segment,Zin_per_par,Wrd_per_par" );
-	out << name << "," << sv[par]->id << ",";
-	sv[par]->toCSV( out );
-    }
-      cerr << "stored paragraph statistics in " << fname << endl;
-    }
-    else {
-      cerr << "storing paragraph statistics in " << fname << " FAILED!" << endl;
+    for ( size_t par=0; par < sv.size(); ++par ){
+      if ( par == 0 )
+	// 20141003: New features: sentences/words per paragraph
+	sv[0]->CSVheader( out, "Inputfile,Segment,Zin_per_par,Wrd_per_par" );
+      out << name << "," << sv[par]->id << ",";
+      sv[par]->toCSV( out );
     }
   }
   else if ( what == SENT_CSV ){
-    string fname = name + ".sentences.csv";
-    ofstream out( fname.c_str() );
-    if ( out ){
-      for ( size_t par=0; par < sv.size(); ++par ){
-	for ( size_t sent=0; sent < sv[par]->sv.size(); ++sent ){
-	  if ( par == 0 && sent == 0 )
-	    sv[0]->sv[0]->CSVheader( out, "Inputfile,Segment,Getokeniseerde_zin" );
-	  out << name << "," << sv[par]->sv[sent]->id << ",";
-	  sv[par]->sv[sent]->toCSV( out );
-	}
+    for ( size_t par=0; par < sv.size(); ++par ){
+      for ( size_t sent=0; sent < sv[par]->sv.size(); ++sent ){
+	if ( par == 0 && sent == 0 )
+	  sv[0]->sv[0]->CSVheader( out, "Inputfile,Segment,Getokeniseerde_zin" );
+	out << name << "," << sv[par]->sv[sent]->id << ",";
+	sv[par]->sv[sent]->toCSV( out );
       }
-      cerr << "stored sentence statistics in " << fname << endl;
-    }
-    else {
-      cerr << "storing sentence statistics in " << fname << " FAILED!" << endl;
     }
   }
   else if ( what == WORD_CSV ){
-    string fname = name + ".words.csv";
-    ofstream out( fname.c_str() );
-    if ( out ){
-      for ( size_t par=0; par < sv.size(); ++par ){
-	for ( size_t sent=0; sent < sv[par]->sv.size(); ++sent ){
-	  for ( size_t word=0; word < sv[par]->sv[sent]->sv.size(); ++word ){
-	    if ( par == 0 && sent == 0 && word == 0 )
-	      sv[0]->sv[0]->sv[0]->CSVheader( out );
-	    out << name << ",";
-	    sv[par]->sv[sent]->sv[word]->toCSV( out );
-	  }
+    for ( size_t par=0; par < sv.size(); ++par ){
+      for ( size_t sent=0; sent < sv[par]->sv.size(); ++sent ){
+	for ( size_t word=0; word < sv[par]->sv[sent]->sv.size(); ++word ){
+	  if ( par == 0 && sent == 0 && word == 0 )
+	    sv[0]->sv[0]->sv[0]->CSVheader( out );
+	  out << name << ",";
+	  sv[par]->sv[sent]->sv[word]->toCSV( out );
 	}
       }
-      cerr << "stored word statistics in " << fname << endl;
-    }
-    else {
-      cerr << "storing word statistics in " << fname << " FAILED!" << endl;
     }
   }
 }
 
+/**
+ * The columns of the document .csv-output on how the parses of the
+ * Alpino servers were scheduled (see AlpinoSchedule). They are NA when
+ * the sentences weren't sent to Alpino servers, so every document .csv
+ * has the same columns.
+ * @param os the current outputstream
+ */
+void docStats::scheduleHeader( ostream& os ) const {
+  os << ",Alpino_parses,Alpino_connections,Alpino_makespan,Alpino_busy,";
+  os << "Alpino_estimate,Alpino_longest,Alpino_longest_tokens,";
+  os << "Alpino_longest_end";
+}
+
+void docStats::scheduleToCSV( ostream& os ) const {
+  if ( alpino_scheduled ){
+    os << "," << alpino_schedule.requests;
+    os << "," << alpino_schedule.connections;
+    os << "," << alpino_schedule.makespan;
+    os << "," << alpino_schedule.busy;
+    os << "," << alpino_schedule.estimate;
+    os << "," << alpino_schedule.longest;
+    os << "," << alpino_schedule.longest_tokens;
+    os << "," << alpino_schedule.longest_end;
+  }
+  else {
+    os << ",NA,NA,NA,NA,NA,NA,NA,NA";
+  }
+}
+
 /**************
  * FOLIA OUTPUT
  **************/
@@ -0,0 +1,80 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <sstream>
+#include "tscan/features.h"
+
+using namespace std;
+
+FeatureMemo::FeatureMemo( size_t max ):
+  max_per_shard( ( max + SHARDS - 1 ) / SHARDS ),
+  lookups( 0 ),
+  hits( 0 )
+{}
+
+FeatureMemo::shard& FeatureMemo::shard_of( const string& key ) const {
+  return shards[hash<string>()( key ) % SHARDS];
+}
+
+bool FeatureMemo::find( const string& key, word_features& result ) const {
+  if ( max_per_shard == 0 ){
+    return false;
+  }
+  ++lookups;
+  shard& s = shard_of( key );
+  lock_guard<mutex> guard( s.lock );
+  auto it = s.types.find( key );
+  if ( it == s.types.end() ){
+    return false;
+  }
+  ++hits;
+  result = it->second;
+  return true;
+}
+
+void FeatureMemo::add( const string& key, const word_features& features ){
+  shard& s = shard_of( key );
+  lock_guard<mutex> guard( s.lock );
+  if ( s.types.size() < max_per_shard ){
+    s.types.insert( make_pair( key, features ) );
+  }
+}
+
+string FeatureMemo::stats() const {
+  if ( max_per_shard == 0 ){
+    return "not used";
+  }
+  size_t types = 0;
+  for ( auto& s : shards ){
+    lock_guard<mutex> guard( s.lock );
+    types += s.types.size();
+  }
+  size_t n = lookups;
+  size_t h = hits;
+  ostringstream os;
+  os << types << " types, " << h << " of " << n << " words found";
+  if ( n > 0 ){
+    os << " (" << ( 100 * h ) / n << "%)";
+  }
+  return os.str();
+}
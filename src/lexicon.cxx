@@ -0,0 +1,457 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tscan/lexicon.h"
+
+using namespace std;
+
+namespace Lexicon {
+
+  // FNV-1a, followed by a final mix to spread the bits
+  inline uint64_t mix( uint64_t h ){
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  uint64_t hash( const string& s ){
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for ( const auto c : s ){
+      h ^= (unsigned char)c;
+      h *= 0x100000001b3ULL;
+    }
+    return mix( h );
+  }
+
+  inline uint64_t rehash( uint64_t h, uint64_t seed ){
+    return mix( h + seed * 0x9e3779b97f4a7c15ULL );
+  }
+
+  sourceInfo::sourceInfo( const string& name, double p ):
+    file(name), size(0), mtime(0), param(p), total(0)
+  {
+    struct stat sbuf;
+    if ( stat( name.c_str(), &sbuf ) == 0 ){
+      size = sbuf.st_size;
+      mtime = sbuf.st_mtime;
+    }
+  }
+
+  bool sourceInfo::matches( const tableEntry& e, const char *pool ) const {
+    return file == pool + e.source
+      && size == e.source_size
+      && mtime == e.source_mtime
+      && param == e.param;
+  }
+
+  rawTable::rawTable( const char *base, const tableEntry& e ):
+    _count( e.count ),
+    _buckets( e.buckets ),
+    _record_size( e.record_size ),
+    seeds( reinterpret_cast<const int32_t*>( base + e.seeds ) ),
+    slots( reinterpret_cast<const slot*>( base + e.slots ) ),
+    records( base + e.records ),
+    pool( base + reinterpret_cast<const imageHeader*>(base)->pool ),
+    pool_size( reinterpret_cast<const imageHeader*>(base)->pool_size )
+  {}
+
+  const void *rawTable::find( const string& key ) const {
+    if ( _count == 0 ){
+      return 0;
+    }
+    uint64_t h = hash( key );
+    int32_t seed = seeds[h % _buckets];
+    if ( seed == 0 ){
+      return 0;
+    }
+    uint64_t pos;
+    if ( seed < 0 ){
+      // a bucket with only one key, stored directly
+      pos = -( seed + 1 );
+    }
+    else {
+      pos = rehash( h, seed ) % _count;
+    }
+    if ( pos >= _count ){
+      return 0;
+    }
+    const slot& s = slots[pos];
+    if ( s.length != key.size()
+	 || !in_pool( s )
+	 || memcmp( pool + s.key, key.data(), s.length ) != 0 ){
+      return 0;
+    }
+    return records + pos * _record_size;
+  }
+
+  Builder::Builder(){
+    // offset 0 is the empty string
+    pool.push_back( '\0' );
+    pooled[""] = 0;
+  }
+
+  uint32_t Builder::add_string( const string& s ){
+    auto it = pooled.find( s );
+    if ( it != pooled.end() ){
+      return it->second;
+    }
+    if ( pool.size() + s.size() + 1 > UINT32_MAX ){
+      throw runtime_error( "lexicon string pool overflow" );
+    }
+    uint32_t off = pool.size();
+    pool.append( s );
+    pool.push_back( '\0' );
+    pooled[s] = off;
+    return off;
+  }
+
+  void Builder::add_set( const string& name,
+			 const set<string>& s,
+			 const sourceInfo& src ){
+    map<string,uint8_t> m;
+    for ( const auto& key : s ){
+      m[key] = 1;
+    }
+    add_table( name, m, src );
+  }
+
+  void Builder::add_raw( const string& name,
+			 const vector<string>& keys,
+			 const vector<char>& recs,
+			 size_t record_size,
+			 const sourceInfo& src ){
+    table t;
+    tableEntry& e = t.entry;
+    memset( &e, 0, sizeof(e) );
+    e.name = add_string( name );
+    e.source = add_string( src.file );
+    e.source_size = src.size;
+    e.source_mtime = src.mtime;
+    e.param = src.param;
+    e.total = src.total;
+    e.count = keys.size();
+    e.record_size = record_size;
+    // about 2 keys per bucket. Bigger buckets are placed first, while
+    // there is still plenty of room. Buckets holding one key are placed
+    // directly in the remaining free slots.
+    e.buckets = max<uint64_t>( 1, keys.size() / 2 );
+    vector<uint64_t> hashes( keys.size() );
+    vector<vector<uint32_t>> buckets( e.buckets );
+    for ( size_t i=0; i < keys.size(); ++i ){
+      hashes[i] = hash( keys[i] );
+      buckets[hashes[i] % e.buckets].push_back( i );
+    }
+    vector<uint32_t> order( e.buckets );
+    for ( size_t b=0; b < order.size(); ++b ){
+      order[b] = b;
+    }
+    stable_sort( order.begin(), order.end(),
+		 [&buckets]( uint32_t a, uint32_t b ){
+		   return buckets[a].size() > buckets[b].size(); } );
+    t.seeds.assign( e.buckets, 0 );
+    vector<int64_t> position( keys.size(), -1 );
+    vector<bool> taken( keys.size(), false );
+    size_t free_pos = 0;
+    for ( const auto b : order ){
+      const vector<uint32_t>& bucket = buckets[b];
+      if ( bucket.empty() ){
+	break;
+      }
+      if ( bucket.size() == 1 ){
+	while ( taken[free_pos] ){
+	  ++free_pos;
+	}
+	taken[free_pos] = true;
+	position[bucket[0]] = free_pos;
+	t.seeds[b] = -int32_t( free_pos + 1 );
+	continue;
+      }
+      vector<uint64_t> tried;
+      bool placed = false;
+      for ( int32_t seed = 1; seed < INT32_MAX && !placed; ++seed ){
+	tried.clear();
+	for ( const auto k : bucket ){
+	  uint64_t pos = rehash( hashes[k], seed ) % e.count;
+	  if ( taken[pos]
+	       || find( tried.begin(), tried.end(), pos ) != tried.end() ){
+	    break;
+	  }
+	  tried.push_back( pos );
+	}
+	if ( tried.size() == bucket.size() ){
+	  for ( size_t i=0; i < bucket.size(); ++i ){
+	    taken[tried[i]] = true;
+	    position[bucket[i]] = tried[i];
+	  }
+	  t.seeds[b] = seed;
+	  placed = true;
+	}
+	else if ( seed > 10000000 ){
+	  throw runtime_error( "unable to build a perfect hash for table '"
+			       + name + "'" );
+	}
+      }
+    }
+    t.slots.resize( keys.size() );
+    t.records.resize( recs.size() );
+    for ( size_t i=0; i < keys.size(); ++i ){
+      slot& s = t.slots[position[i]];
+      s.key = add_string( keys[i] );
+      s.length = keys[i].size();
+      memcpy( &t.records[position[i]*record_size],
+	      &recs[i*record_size],
+	      record_size );
+    }
+    tables.push_back( t );
+  }
+
+  inline uint64_t align( uint64_t off ){
+    return ( off + 7 ) & ~uint64_t(7);
+  }
+
+  void Builder::image( vector<uint64_t>& out ) const {
+    // layout: header, string pool, tables, directory
+    uint64_t off = align( sizeof(imageHeader) );
+    uint64_t pool_off = off;
+    off = align( off + pool.size() );
+    vector<tableEntry> directory;
+    for ( const auto& t : tables ){
+      tableEntry e = t.entry;
+      e.seeds = off;
+      off = align( off + t.seeds.size() * sizeof(int32_t) );
+      e.slots = off;
+      off = align( off + t.slots.size() * sizeof(slot) );
+      e.records = off;
+      off = align( off + t.records.size() );
+      directory.push_back( e );
+    }
+    uint64_t dir_off = off;
+    off = align( off + directory.size() * sizeof(tableEntry) );
+    out.assign( off / sizeof(uint64_t), 0 );
+    char *base = reinterpret_cast<char*>( &out[0] );
+    imageHeader *h = reinterpret_cast<imageHeader*>( base );
+    memcpy( h->magic, magic, sizeof(h->magic) );
+    h->version = version;
+    h->tables = directory.size();
+    h->size = off;
+    h->pool = pool_off;
+    h->pool_size = pool.size();
+    h->directory = dir_off;
+    memcpy( base + pool_off, pool.data(), pool.size() );
+    for ( size_t i=0; i < tables.size(); ++i ){
+      const table& t = tables[i];
+      const tableEntry& e = directory[i];
+      if ( !t.seeds.empty() ){
+	memcpy( base + e.seeds, &t.seeds[0],
+		t.seeds.size() * sizeof(int32_t) );
+      }
+      if ( !t.slots.empty() ){
+	memcpy( base + e.slots, &t.slots[0], t.slots.size() * sizeof(slot) );
+      }
+      if ( !t.records.empty() ){
+	memcpy( base + e.records, &t.records[0], t.records.size() );
+      }
+    }
+    if ( !directory.empty() ){
+      memcpy( base + dir_off, &directory[0],
+	      directory.size() * sizeof(tableEntry) );
+    }
+  }
+
+  Image::Image(): base(0), _size(0), mapped(false) {}
+
+  Image::~Image(){
+    clear();
+  }
+
+  void Image::clear(){
+    if ( mapped ){
+      munmap( const_cast<char*>(base), _size );
+    }
+    heap.clear();
+    base = 0;
+    _size = 0;
+    mapped = false;
+  }
+
+  bool Image::load( const string& filename, string& error ){
+    clear();
+    int fd = open( filename.c_str(), O_RDONLY );
+    if ( fd < 0 ){
+      error = "couldn't open file: " + filename;
+      return false;
+    }
+    struct stat sbuf;
+    if ( fstat( fd, &sbuf ) != 0
+	 || size_t(sbuf.st_size) < sizeof(imageHeader) ){
+      close( fd );
+      error = "not a lexicon file: " + filename;
+      return false;
+    }
+    void *p = mmap( 0, sbuf.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( p == MAP_FAILED ){
+      error = "unable to map file: " + filename;
+      return false;
+    }
+    base = static_cast<const char*>( p );
+    _size = sbuf.st_size;
+    mapped = true;
+    const imageHeader *h = reinterpret_cast<const imageHeader*>( base );
+    if ( memcmp( h->magic, magic, sizeof(magic) ) != 0 ){
+      error = "not a lexicon file: " + filename;
+    }
+    else if ( h->version != version ){
+      error = "lexicon file " + filename + " has version "
+	+ to_string( h->version ) + ", expected " + to_string( version )
+	+ ". Please recompile it with tscan-lexc";
+    }
+    else if ( h->size != _size || !valid() ){
+      error = "lexicon file " + filename + " is truncated or corrupt";
+    }
+    else {
+      return true;
+    }
+    clear();
+    return false;
+  }
+
+  inline bool fits( uint64_t off, uint64_t count, uint64_t size,
+		    uint64_t end ){
+    // does an array of 'count' elements of 'size' at 'off' end before 'end'
+    return off <= end
+      && ( size == 0 || count <= ( end - off ) / size );
+  }
+
+  bool Image::valid() const {
+    // everything the tables point at must lie inside the image, and
+    // the pool must end in a NUL. The keys are checked when they are
+    // used, so loading doesn't have to read every table
+    const imageHeader *h = reinterpret_cast<const imageHeader*>( base );
+    if ( !fits( h->directory, h->tables, sizeof(tableEntry), _size )
+	 || !fits( h->pool, h->pool_size, 1, _size )
+	 || h->pool_size == 0
+	 || base[h->pool + h->pool_size - 1] != '\0' ){
+      return false;
+    }
+    const tableEntry *dir
+      = reinterpret_cast<const tableEntry*>( base + h->directory );
+    for ( size_t i=0; i < h->tables; ++i ){
+      const tableEntry& e = dir[i];
+      if ( e.name >= h->pool_size
+	   || e.source >= h->pool_size
+	   || e.buckets == 0
+	   || !fits( e.seeds, e.buckets, sizeof(int32_t), _size )
+	   || !fits( e.slots, e.count, sizeof(slot), _size )
+	   || !fits( e.records, e.count, e.record_size, _size ) ){
+	return false;
+      }
+    }
+    return true;
+  }
+
+  void Image::assign( const Builder& b ){
+    clear();
+    b.image( heap );
+    base = reinterpret_cast<const char*>( &heap[0] );
+    _size = heap.size() * sizeof(uint64_t);
+  }
+
+  bool Image::save( const string& filename ) const {
+    if ( !base ){
+      return false;
+    }
+    // write to a temporary file first, so running processes that
+    // have mapped 'filename' are not disturbed. The name is unique, so
+    // processes that save the same lexicon don't write in each other's
+    // file
+    string tmp = filename + ".XXXXXX";
+    int fd = mkstemp( &tmp[0] );
+    if ( fd < 0 ){
+      return false;
+    }
+    fchmod( fd, 0644 );
+    size_t done = 0;
+    while ( done < _size ){
+      ssize_t n = write( fd, base + done, _size - done );
+      if ( n < 0 && errno == EINTR ){
+	continue;
+      }
+      if ( n <= 0 ){
+	break;
+      }
+      done += n;
+    }
+    if ( close( fd ) != 0 || done < _size
+	 || rename( tmp.c_str(), filename.c_str() ) != 0 ){
+      remove( tmp.c_str() );
+      return false;
+    }
+    return true;
+  }
+
+  const tableEntry *Image::entry( const string& name ) const {
+    if ( !base ){
+      return 0;
+    }
+    const imageHeader *h = reinterpret_cast<const imageHeader*>( base );
+    const tableEntry *dir
+      = reinterpret_cast<const tableEntry*>( base + h->directory );
+    const char *pool = base + h->pool;
+    for ( size_t i=0; i < h->tables; ++i ){
+      if ( name == pool + dir[i].name ){
+	return &dir[i];
+      }
+    }
+    return 0;
+  }
+
+  const char *Image::str( uint32_t off ) const {
+    const imageHeader *h = reinterpret_cast<const imageHeader*>( base );
+    if ( off >= h->pool_size ){
+      return base + h->pool;
+    }
+    return base + h->pool + off;
+  }
+
+  bool Image::is_current( const string& name, const sourceInfo& src ) const {
+    const tableEntry *e = entry( name );
+    if ( !e ){
+      return false;
+    }
+    const imageHeader *h = reinterpret_cast<const imageHeader*>( base );
+    return src.matches( *e, base + h->pool );
+  }
+
+}
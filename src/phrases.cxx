@@ -0,0 +1,170 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <vector>
+#include "tscan/phrases.h"
+
+using namespace std;
+
+Phrases::Phrases(){
+  clear();
+}
+
+void Phrases::clear(){
+  tokens.clear();
+  edges.clear();
+  nodes.assign( 1, node() );
+  phrases = 0;
+}
+
+size_t Phrases::heap_size() const {
+  // a hash node holds the value and a pointer to the next one
+  size_t bytes = nodes.capacity() * sizeof(node)
+    + edges.size() * ( sizeof(uint64_t) + sizeof(uint32_t) + sizeof(void*) );
+  for ( const auto& it : tokens ){
+    bytes += it.first.capacity() + sizeof(it) + sizeof(void*);
+  }
+  return bytes;
+}
+
+uint32_t Phrases::token( const string& word ) const {
+  auto it = tokens.find( word );
+  if ( it == tokens.end() ){
+    return NONE;
+  }
+  return it->second;
+}
+
+uint32_t Phrases::next( uint32_t from, uint32_t tok ) const {
+  auto it = edges.find( (uint64_t)from << 32 | tok );
+  if ( it == edges.end() ){
+    return NONE;
+  }
+  return it->second;
+}
+
+void Phrases::add( Form form, const string& phrase, uint32_t categories ){
+  // split on single spaces only: a lexicon key matches the words of a
+  // sentence joined with one space
+  vector<string> words;
+  size_t pos = 0;
+  for ( ;; ){
+    size_t sp = phrase.find( ' ', pos );
+    words.push_back( phrase.substr( pos, sp - pos ) );
+    if ( sp == string::npos ){
+      break;
+    }
+    pos = sp + 1;
+  }
+  if ( words.size() < 2 ){
+    return;
+  }
+  uint32_t cur = 0;
+  for ( const auto& w : words ){
+    auto tok = tokens.insert( make_pair( w, (uint32_t)tokens.size() ) );
+    uint64_t key = (uint64_t)cur << 32 | tok.first->second;
+    auto edge = edges.find( key );
+    if ( edge == edges.end() ){
+      edge = edges.insert( make_pair( key, (uint32_t)nodes.size() ) ).first;
+      nodes.push_back( node() );
+    }
+    cur = edge->second;
+  }
+  if ( nodes[cur].categories[form] == 0 ){
+    ++phrases;
+  }
+  nodes[cur].categories[form] |= categories;
+}
+
+void Phrases::match( const vector<string> (&words)[FORMS],
+		     PhraseMatches& result ) const {
+  size_t n = words[TEXT].size();
+  result.matches.clear();
+  result.first.assign( n + 1, 0 );
+  if ( phrases == 0 ){
+    return;
+  }
+  // number the words once, so the walks compare numbers only
+  vector<uint32_t> toks[FORMS];
+  for ( int f=0; f < FORMS; ++f ){
+    toks[f].resize( n );
+    for ( size_t i=0; i < n; ++i ){
+      toks[f][i] = token( words[f][i] );
+    }
+  }
+  for ( size_t i=0; i < n; ++i ){
+    result.first[i] = result.matches.size();
+    for ( int f=0; f < FORMS; ++f ){
+      uint32_t cur = 0;
+      for ( size_t j=i; j < n && toks[f][j] != NONE; ++j ){
+	cur = next( cur, toks[f][j] );
+	if ( cur == NONE ){
+	  break;
+	}
+	uint32_t cats = nodes[cur].categories[f];
+	if ( cats != 0 ){
+	  PhraseMatches::match m;
+	  m.length = j - i + 1;
+	  m.categories = cats;
+	  result.matches.push_back( m );
+	}
+      }
+    }
+  }
+  result.first[n] = result.matches.size();
+}
+
+uint32_t PhraseMatches::at( size_t start, size_t length ) const {
+  if ( start + 1 >= first.size() ){
+    return 0;
+  }
+  uint32_t result = 0;
+  for ( size_t k=first[start]; k < first[start+1]; ++k ){
+    if ( matches[k].length == length ){
+      result |= matches[k].categories;
+    }
+  }
+  return result;
+}
+
+void PhraseMatches::merge( const PhraseMatches& other ){
+  if ( other.matches.empty() ){
+    return;
+  }
+  if ( matches.empty() ){
+    *this = other;
+    return;
+  }
+  vector<match> merged;
+  vector<size_t> starts( first.size(), 0 );
+  for ( size_t i=0; i+1 < first.size(); ++i ){
+    starts[i] = merged.size();
+    merged.insert( merged.end(), matches.begin() + first[i],
+		   matches.begin() + first[i+1] );
+    merged.insert( merged.end(), other.matches.begin() + other.first[i],
+		   other.matches.begin() + other.first[i+1] );
+  }
+  starts.back() = merged.size();
+  matches.swap( merged );
+  first.swap( starts );
+}
@@ -1,4 +1,6 @@
 #include "tscan/stats.h"
+#include "tscan/settings.h"
+#include "tscan/AlpinoTree.h"
 
 using namespace std;
 
@@ -227,33 +229,28 @@ double sentStats::getHighestAL() const {
  * CONNECTIVES
  *************/
 
-void sentStats::resolveConnectives() {
-  const string neg_longA[] = { "afgezien van", "zomin als", "met uitzondering van"};
-  static set<string> negatives_long = set<string>( neg_longA, neg_longA + sizeof(neg_longA)/sizeof(string) );
-
-  if ( sv.size() > 1 ){
-    for ( size_t i=0; i < sv.size()-2; ++i ){
-      string word = sv[i]->ltext();
-      string multiword2 = word + " " + sv[i+1]->ltext();
-      if ( !checkAls( i ) ){
-	// "als" is speciaal als het matcht met eerdere woorden.
-	// (evenmin ... als) (zowel ... als ) etc.
-	// In dat geval niet meer zoeken naar "als ..."
-	//      cerr << "zoek op " << multiword2 << endl;
-	Conn::Type conn = checkMultiConnectives( multiword2 );
-	if ( conn != Conn::NOCONN ){
-	  sv[i]->setMultiConn();
-	  sv[i+1]->setMultiConn();
-	  sv[i]->setConnType( conn );
-	  sv[i+1]->setConnType( Conn::NOCONN );
-	}
-      }
-      if ( negatives_long.find( multiword2 ) != negatives_long.end() ){
-	propNegCnt++;
+void sentStats::resolveConnectives( const PhraseMatches& phrases ) {
+  for ( size_t i=0; i+1 < sv.size(); ++i ){
+    uint32_t cats = phrases.at( i, 2 );
+    // "als" is speciaal als het matcht met eerdere woorden.
+    // (evenmin ... als) (zowel ... als ) etc.
+    // In dat geval niet meer zoeken naar "als ..."
+    // (the last 2 words are never checked for this)
+    if ( i+2 == sv.size() || !checkAls( i ) ){
+      Conn::Type conn = checkMultiConnectives( cats );
+      if ( conn != Conn::NOCONN ){
+	sv[i]->setMultiConn();
+	sv[i+1]->setMultiConn();
+	sv[i]->setConnType( conn );
+	sv[i+1]->setConnType( Conn::NOCONN );
       }
-      string multiword3 = multiword2 + " " + sv[i+2]->ltext();
-      //      cerr << "zoek op " << multiword3 << endl;
-      Conn::Type conn = checkMultiConnectives( multiword3 );
+    }
+    if ( cats & NEG_LONG ){
+      propNegCnt++;
+    }
+    if ( i+2 < sv.size() ){
+      cats = phrases.at( i, 3 );
+      Conn::Type conn = checkMultiConnectives( cats );
       if ( conn != Conn::NOCONN ){
 	sv[i]->setMultiConn();
 	sv[i+1]->setMultiConn();
@@ -262,22 +259,9 @@ void sentStats::resolveConnectives() {
 	sv[i+1]->setConnType( Conn::NOCONN );
 	sv[i+2]->setConnType( Conn::NOCONN );
       }
-      if ( negatives_long.find( multiword3 ) != negatives_long.end() )
+      if ( cats & NEG_LONG ){
 	propNegCnt++;
-    }
-    // don't forget the last 2 words
-    string multiword2 = sv[sv.size()-2]->ltext() + " "
-      + sv[sv.size()-1]->ltext();
-    //    cerr << "zoek op " << multiword2 << endl;
-    Conn::Type conn = checkMultiConnectives( multiword2 );
-    if ( conn != Conn::NOCONN ){
-      sv[sv.size()-2]->setMultiConn();
-      sv[sv.size()-1]->setMultiConn();
-      sv[sv.size()-2]->setConnType( conn );
-      sv[sv.size()-1]->setConnType( Conn::NOCONN );
-    }
-    if ( negatives_long.find( multiword2 ) != negatives_long.end() ){
-      propNegCnt++;
+      }
     }
   }
   for ( size_t i=0; i < sv.size(); ++i ){
@@ -382,91 +366,38 @@ bool sentStats::checkAls( size_t index ) {
  * SITUATIONS
  ************/
 
-void sentStats::resolveSituations() {
+void sentStats::resolveSituations( const PhraseMatches& phrases ) {
+  // marks the 'len' words at 'start' when they are a situation
+  auto found = [&]( size_t start, size_t len ){
+    Situation::Type sit = checkMultiSituations( phrases.at( start, len ) );
+    if ( sit == Situation::NO_SIT ){
+      return false;
+    }
+    for ( size_t j=start; j+1 < start+len; ++j ){
+      sv[j]->setSitType( Situation::NO_SIT );
+    }
+    sv[start+len-1]->setSitType( sit );
+    return true;
+  };
   if ( sv.size() > 1 ){
     for ( size_t i=0; (i+3) < sv.size(); ++i ){
-      string word = sv[i]->Lemma();
-      string multiword2 = word + " " + sv[i+1]->Lemma();
-      string multiword3 = multiword2 + " " + sv[i+2]->Lemma();
-      string multiword4 = multiword3 + " " + sv[i+3]->Lemma();
-      //      cerr << "zoek 4 op '" << multiword4 << "'" << endl;
-      Situation::Type sit = checkMultiSituations( multiword4 );
-      if ( sit != Situation::NO_SIT ){
-	//	cerr << "found " << sit << "-situation: " << multiword4 << endl;
-	sv[i]->setSitType( Situation::NO_SIT );
-	sv[i+1]->setSitType( Situation::NO_SIT );
-	sv[i+2]->setSitType( Situation::NO_SIT );
-	sv[i+3]->setSitType( sit );
-	i += 3;
-      }
-      else {
-	//cerr << "zoek 3 op '" << multiword3 << "'" << endl;
-	sit = checkMultiSituations( multiword3 );
-	if ( sit != Situation::NO_SIT ){
-	  // cerr << "found " << sit << "-situation: " << multiword3 << endl;
-	  sv[i]->setSitType( Situation::NO_SIT );
-	  sv[i+1]->setSitType( Situation::NO_SIT );
-	  sv[i+2]->setSitType( sit );
-	  i += 2;
-	}
-	else {
-	  //cerr << "zoek 2 op '" << multiword2 << "'" << endl;
-	  sit = checkMultiSituations( multiword2 );
-	  if ( sit != Situation::NO_SIT ){
-	    //	    cerr << "found " << sit << "-situation: " << multiword2 << endl;
-	    sv[i]->setSitType( Situation::NO_SIT);
-	    sv[i+1]->setSitType( sit );
-	    i += 1;
-	  }
+      // the longest expression first
+      for ( size_t len=4; len > 1; --len ){
+	if ( found( i, len ) ){
+	  i += len-1;
+	  break;
 	}
       }
     }
     // don't forget the last 2 and 3 words
-    Situation::Type sit = Situation::NO_SIT;
-    if ( sv.size() > 2 ){
-      string multiword3 = sv[sv.size()-3]->Lemma() + " "
-	+ sv[sv.size()-2]->Lemma() + " " + sv[sv.size()-1]->Lemma();
-      //cerr << "zoek final 3 op '" << multiword3 << "'" << endl;
-      sit = checkMultiSituations( multiword3 );
-      if ( sit != Situation::NO_SIT ){
-	//	cerr << "found " << sit << "-situation: " << multiword3 << endl;
-	sv[sv.size()-3]->setSitType( Situation::NO_SIT );
-	sv[sv.size()-2]->setSitType( Situation::NO_SIT );
-	sv[sv.size()-1]->setSitType( sit );
-      }
-      else {
-	string multiword2 = sv[sv.size()-3]->Lemma() + " "
-	  + sv[sv.size()-2]->Lemma();
-	//cerr << "zoek first final 2 op '" << multiword2 << "'" << endl;
-	sit = checkMultiSituations( multiword2 );
-	if ( sit != Situation::NO_SIT ){
-	  //	  cerr << "found " << sit << "-situation: " << multiword2 << endl;
-	  sv[sv.size()-3]->setSitType( Situation::NO_SIT);
-	  sv[sv.size()-2]->setSitType( sit );
-	}
-	else {
-	  string multiword2 = sv[sv.size()-2]->Lemma() + " "
-	    + sv[sv.size()-1]->Lemma();
-	  //cerr << "zoek second final 2 op '" << multiword2 << "'" << endl;
-	  sit = checkMultiSituations( multiword2 );
-	  if ( sit != Situation::NO_SIT ){
-	    //	    cerr << "found " << sit << "-situation: " << multiword2 << endl;
-	    sv[sv.size()-2]->setSitType( Situation::NO_SIT);
-	    sv[sv.size()-1]->setSitType( sit );
-	  }
-	}
+    size_t n = sv.size();
+    if ( n > 2 ){
+      if ( !found( n-3, 3 ) && !found( n-3, 2 ) ){
+	found( n-2, 2 );
       }
     }
     else {
-      string multiword2 = sv[sv.size()-2]->Lemma() + " "
-	+ sv[sv.size()-1]->Lemma();
-      // cerr << "zoek second final 2 op '" << multiword2 << "'" << endl;
-      sit = checkMultiSituations( multiword2 );
-      if ( sit != Situation::NO_SIT ){
-	//	cerr << "found " << sit << "-situation: " << multiword2 << endl;
-	sv[sv.size()-2]->setSitType( Situation::NO_SIT);
-	sv[sv.size()-1]->setSitType( sit );
-      }
+      found( n-2, 2 );
     }
   }
   for ( size_t i=0; i < sv.size(); ++i ){
@@ -493,149 +424,34 @@ void sentStats::resolveSituations() {
   }
 }
 
-/******************
- * RELATIVE CLAUSES
- ******************/
-
-// Finds nodes of relative clauses and reports counts
-void sentStats::resolveRelativeClauses( xmlDoc *alpDoc ) {
-  string hasFiniteVerb = "//node[@cat='ssub']";
-  string hasDirectFiniteVerb = "/node[@cat='ssub']";
-  string hasFiniteVerbSv1 = "//node[@cat='ssub' or @cat='sv1']";
-  string hasDirectFiniteVerbSv1 = "/node[@cat='ssub' or @cat='sv1']";
-
-  // Betrekkelijke/bijvoeglijke bijzinnen (zonder/met nevenschikking)
-  list<xmlNode*> relNodes = getNodesByRelCat(alpDoc, "mod", "rel", hasFiniteVerb);
-  relNodes.merge(getNodesByRelCat(alpDoc, "mod", "whrel", hasFiniteVerb));
-  string relConjPath = ".//node[@rel='mod' and @cat='conj']//node[@rel='cnj' and (@cat='rel' or @cat='whrel')]" + hasDirectFiniteVerb;
-  relNodes.merge(TiCC::FindNodes(alpDoc, relConjPath));
-
-  // Bijwoordelijke bijzinnen (zonder/met nevenschikking + licht afwijkende bijzinnen)
-  list<xmlNode*> cpNodes = getNodesByRelCat(alpDoc, "mod", "cp", hasFiniteVerbSv1);
-  string cpConjPath = ".//node[@rel='mod' and @cat='conj']//node[@rel='cnj' and @cat='cp']" + hasDirectFiniteVerbSv1;
-  cpNodes.merge(TiCC::FindNodes(alpDoc, cpConjPath));
-  string cpNuclAExtra = "(@cat!='cp' or not(descendant::node[@rel='cnj' and @cat='ssub']))";
-  string nuclPath = "(following-sibling::node[@rel='nucl'] or preceding-sibling::node[@rel='nucl'])";
-  string cpNuclAPath = ".//node[(@cat='sv1' or @cat='cp') and " + nuclPath + " and " + cpNuclAExtra + "]";
-  cpNodes.merge(TiCC::FindNodes(alpDoc, cpNuclAPath));
-  string cpNuclBPath = ".//node[@rel='sat' and " + nuclPath + "]/node[@rel='cnj' and @cat='sv1']";
-  cpNodes.merge(TiCC::FindNodes(alpDoc, cpNuclBPath));
-  string cpNuclCPath = ".//node[@rel='sat' and " + nuclPath + "]//node[@rel='cnj' and @cat='ssub']";
-  cpNodes.merge(TiCC::FindNodes(alpDoc, cpNuclCPath));
-
-  // Finiete complementszinnen
-  // Check whether the previous node is not the top node to prevent clashes with loose clauses below
-  string notTop = ".//node[@cat!='top']";
-  string complWhsubPath = notTop + "/node[@cat='whsub']" + hasFiniteVerb;
-  string complWhrelPath = notTop + "/node[@cat='whrel']" + hasFiniteVerb;
-  string complCpPath = notTop + "/node[@rel!='sat' and @cat='cp']" + hasFiniteVerb;
-  list<xmlNode*> complNodes = TiCC::FindNodes(alpDoc, complWhsubPath);
-  complNodes.merge(complementNodes(TiCC::FindNodes(alpDoc, complWhrelPath), relNodes));
-  complNodes.merge(complementNodes(TiCC::FindNodes(alpDoc, complCpPath), cpNodes));
-
-  // Infinietcomplementen
-  list<xmlNode*> tiNodes = getNodesByCat(alpDoc, "ti");
-
-  // Save counts
-  betrCnt = relNodes.size();
-  bijwCnt = cpNodes.size();
-  complCnt = complNodes.size();
-  infinComplCnt = tiNodes.size();
-
-  // Checks for embedded finite clauses
-  list<xmlNode*> allRelNodes (relNodes);
-  allRelNodes.merge(cpNodes);
-  allRelNodes.merge(complNodes);
-  list<string> ids;
-  for (auto& node : allRelNodes) {
-    list<xmlNode*> embedRelNodes = getNodesByRelCat(node, "mod", "rel", hasFiniteVerb);
-    embedRelNodes.merge(getNodesByRelCat(node, "mod", "whrel", hasFiniteVerb));
-    embedRelNodes.merge(TiCC::FindNodes(node, relConjPath));
-    ids.merge(getNodeIds(embedRelNodes));
-
-    list<xmlNode*> embedCpNodes = getNodesByRelCat(node, "mod", "cp", hasFiniteVerbSv1);
-    embedCpNodes.merge(TiCC::FindNodes(node, cpConjPath));
-    embedCpNodes.merge(TiCC::FindNodes(node, cpNuclAPath));
-    embedCpNodes.merge(TiCC::FindNodes(node, cpNuclBPath));
-    embedCpNodes.merge(TiCC::FindNodes(node, cpNuclCPath));
-    ids.merge(getNodeIds(embedCpNodes));
-
-    ids.merge(getNodeIds(TiCC::FindNodes(node, complWhsubPath)));
-    ids.merge(getNodeIds(complementNodes(TiCC::FindNodes(node, complWhrelPath), embedRelNodes)));
-    ids.merge(getNodeIds(complementNodes(TiCC::FindNodes(node, complCpPath), embedCpNodes)));
-  }
-  set<string> mvFinEmbedIds(ids.begin(), ids.end());
-  mvFinInbedCnt = mvFinEmbedIds.size();
-
-  // Checks for all embedded clauses
-  allRelNodes.merge(tiNodes);
-  ids.clear();
-  for (auto& node : allRelNodes) {
-    list<xmlNode*> embedRelNodes = getNodesByRelCat(node, "mod", "rel", hasFiniteVerb);
-    embedRelNodes.merge(getNodesByRelCat(node, "mod", "whrel", hasFiniteVerb));
-    embedRelNodes.merge(TiCC::FindNodes(node, relConjPath));
-    ids.merge(getNodeIds(embedRelNodes));
-
-    list<xmlNode*> embedCpNodes = getNodesByRelCat(node, "mod", "cp", hasFiniteVerbSv1);
-    embedCpNodes.merge(TiCC::FindNodes(node, cpConjPath));
-    embedCpNodes.merge(TiCC::FindNodes(node, cpNuclAPath));
-    embedCpNodes.merge(TiCC::FindNodes(node, cpNuclBPath));
-    embedCpNodes.merge(TiCC::FindNodes(node, cpNuclCPath));
-    ids.merge(getNodeIds(embedCpNodes));
-
-    ids.merge(getNodeIds(TiCC::FindNodes(node, complWhsubPath)));
-    ids.merge(getNodeIds(complementNodes(TiCC::FindNodes(node, complWhrelPath), embedRelNodes)));
-    ids.merge(getNodeIds(complementNodes(TiCC::FindNodes(node, complCpPath), embedCpNodes)));
-
-    ids.merge(getNodeIds(getNodesByCat(node, "ti")));
-  }
-  set<string> mvInbedIds(ids.begin(), ids.end());
-  mvInbedCnt = mvInbedIds.size();
-
-  // Count 'loose' (directly under top node) relative clauses
-  string losBetr = "//node[@cat='top']/node[@cat='rel' or @cat='whrel']" + hasFiniteVerb;
-  losBetrCnt = TiCC::FindNodes(alpDoc, losBetr).size();
-  string losBijw = "//node[@cat='top']/node[@cat='cp']" + hasFiniteVerb;
-  losBijwCnt = TiCC::FindNodes(alpDoc, losBijw).size();
-}
-
-/**************
- * FINITE VERBS
- **************/
-
-// Finds nodes of finite verbs and reports counts
-void sentStats::resolveFiniteVerbs( xmlDoc *alpDoc ) {
-  smainCnt = getNodesByCat(alpDoc, "smain").size();
-  ssubCnt = getNodesByCat(alpDoc, "ssub").size();
-  sv1Cnt = getNodesByCat(alpDoc, "sv1").size();
+/*************
+ * ALPINO TREE
+ *************/
 
+// Takes over the clause, conjunction and adverbial counts of the Alpino tree
+void sentStats::resolveTreeStats( const AlpinoTreeStats& ts ) {
+  resolveAdverbials( ts );
+
+  betrCnt = ts.betrCnt;
+  bijwCnt = ts.bijwCnt;
+  complCnt = ts.complCnt;
+  infinComplCnt = ts.infinComplCnt;
+  mvFinInbedCnt = ts.mvFinInbedCnt;
+  mvInbedCnt = ts.mvInbedCnt;
+  losBetrCnt = ts.losBetrCnt;
+  losBijwCnt = ts.losBijwCnt;
+
+  smainCnt = ts.smainCnt;
+  ssubCnt = ts.ssubCnt;
+  sv1Cnt = ts.sv1Cnt;
   clauseCnt = smainCnt + ssubCnt + sv1Cnt;
   correctedClauseCnt = clauseCnt > 0 ? clauseCnt : 1; // Correct clause count to 1 if there are no verbs in the sentence
-}
-
-/**************
- * CONJUNCTIONS
- **************/
-
-// Finds nodes of coordinating conjunctions and reports counts
-void sentStats::resolveConjunctions( xmlDoc *alpDoc ) {
-  smainCnjCnt = getNodesByRelCat(alpDoc, "cnj", "smain").size();
-  // For cnj-ssub, also allow that the cnj node dominates the ssub node
-  ssubCnjCnt = TiCC::FindNodes(alpDoc, ".//node[@rel='cnj'][descendant-or-self::node[@cat='ssub']]").size();
-  sv1CnjCnt = getNodesByRelCat(alpDoc, "cnj", "sv1").size();
-}
-
-// Finds nodes of small conjunctions and reports counts
-void sentStats::resolveSmallConjunctions( xmlDoc *alpDoc ) {
-  // Small conjunctions have 'cnj' as relation and do not form a "bigger" sentence
-  string cats = "|smain|ssub|sv1|rel|whrel|cp|oti|ti|whsub|";
-  string smallCnjPath = ".//node[@rel='cnj' and not(contains('" + cats + "', concat('|', @cat, '|')))]";
-  smallCnjCnt = TiCC::FindNodes(alpDoc, smallCnjPath).size();
 
-  // smallCnjExtraCnt count elements that have 'conj' as a category and do not govern a "bigger" sentence
-  // This amount is then substracted from the number of small conjunctions.
-  string smallCnjExtraPath = ".//node[@cat='conj' and not(descendant::node[contains('" + cats + "', concat('|', @cat, '|'))])]";
-  smallCnjExtraCnt = smallCnjCnt - TiCC::FindNodes(alpDoc, smallCnjExtraPath).size();
+  smainCnjCnt = ts.smainCnjCnt;
+  ssubCnjCnt = ts.ssubCnjCnt;
+  sv1CnjCnt = ts.sv1CnjCnt;
+  smallCnjCnt = ts.smallCnjCnt;
+  smallCnjExtraCnt = ts.smallCnjExtraCnt;
 }
 
 /**************
@@ -652,4 +468,8 @@ void sentStats::addMetrics() const {
     addOneMetric( doc, el, "isQuestion", "true" );
   if ( impCnt > 0 )
     addOneMetric( doc, el, "isImperative", "true" );
+  if ( parseSplitCnt > 0 )
+    addOneMetric( doc, el, "isSplitParse", "true" );
+  if ( frogSyntaxCnt > 0 )
+    addOneMetric( doc, el, "approximateSyntax", "true" );
 }
@@ -0,0 +1,1583 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include "ticcutils/StringOps.h"
+#include "tscan/utils.h"
+#include "tscan/settings.h"
+
+using namespace std;
+
+// the text format of the lexicons is read into these structures, which are
+// then converted into lexicon tables
+
+struct noun {
+  noun(): type(SEM::NO_SEMTYPE),is_compound(false), compound_parts(0){};
+  SEM::Type type;
+  bool is_compound;
+  string head;
+  string satellite_clean;
+  int compound_parts;
+};
+
+struct tagged_classification {
+  CGN::Type tag;
+  string classification;
+};
+
+settingData settings;
+
+bool fillN( map<string,noun>& m, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    // Trim the lines
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+
+    // Split at a tab; the line should contain either 3 (non-compounds) or 6 (compounds) values
+    vector<string> parts;
+    int i = TiCC::split_at( line, parts, "\t" );
+    if (i != 3 && i != 6) {
+      cerr << "skip line: " << line << " (expected 3 or 6 values, got " << i << ")" << endl;
+      continue;
+    }
+
+    // Classify the noun, set the compound values and add the noun to the map
+    noun n;
+    n.type = SEM::classifyNoun(parts[1]);
+    n.is_compound = parts[2] == "1";
+    if (n.is_compound) {
+      n.head = parts[3];
+      n.satellite_clean = parts[4];
+      n.compound_parts = atoi(parts[5].c_str());
+    }
+    m[parts[0]] = n;
+  }
+  return true;
+}
+
+bool fillN( map<string,noun>& m, const string& filename ) {
+  ifstream is( filename.c_str() );
+  if (is) {
+    return fillN(m, is);
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fillWW( map<string,SEM::Type>& m, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    vector<string> parts;
+    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
+    if ( n != 3 ){
+      cerr << "skip line: " << line << " (expected 3 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    SEM::Type res = SEM::classifyWW( parts[1], parts[2] );
+    if ( res != SEM::UNFOUND_VERB ){
+      // no use to store undefined values
+      m[parts[0]] = res;
+    }
+  }
+  return true;
+}
+
+bool fillADJ( map<string,SEM::Type>& m, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    vector<string> parts;
+    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
+    if ( n <2 || n > 3 ){
+      cerr << "skip line: " << line << " (expected 2 or 3 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    SEM::Type res = SEM::UNFOUND_ADJ;
+    if ( n == 2 ){
+      res = SEM::classifyADJ( parts[1] );
+    }
+    else {
+      res = SEM::classifyADJ( parts[1], parts[2] );
+    }
+    string low = TiCC::lowercase( parts[0] );
+    if ( m.find(low) != m.end() ){
+      cerr << "Information: multiple entry '" << low << "' in ADJ lex" << endl;
+    }
+    if ( res != SEM::UNFOUND_ADJ ){
+      // no use to store undefined values
+      m[low] = res;
+    }
+  }
+  return true;
+}
+
+bool fill( CGN::Type tag, map<string,SEM::Type>& m, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    if ( tag == CGN::WW )
+      return fillWW( m, is );
+    else if ( tag == CGN::ADJ )
+      return fillADJ( m, is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_intensify(map<string,Intensify::Type>& m, istream& is){
+  string line;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    vector<string> parts;
+    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
+    if ( n < 2 || n > 2 ){
+      cerr << "skip line: " << line << " (expected 2 values, got "
+       << n << ")" << endl;
+      continue;
+    }
+    string low = TiCC::trim(TiCC::lowercase( parts[0] ));
+    Intensify::Type res = Intensify::classify(TiCC::lowercase(parts[1]));
+    if ( m.find(low) != m.end() ){
+      cerr << "Information: multiple entry '" << low << "' in Intensify lex" << endl;
+    }
+    if ( res != Intensify::NO_INTENSIFY ){
+      // no use to store undefined values
+      m[low] = res;
+    }
+  }
+  return true;
+}
+
+bool fill_intensify(map<string,Intensify::Type>& m, const string& filename) {
+  ifstream is( filename.c_str() );
+  if (is) {
+    return fill_intensify(m, is);
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_general(map<string,General::Type>& m, istream& is){
+  string line;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    vector<string> parts;
+    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
+    if ( n < 2 || n > 2 ){
+      cerr << "skip line: " << line << " (expected 2 values, got "
+       << n << ")" << endl;
+      continue;
+    }
+    string low = TiCC::trim(TiCC::lowercase( parts[0] ));
+    General::Type res = General::classify(TiCC::lowercase(parts[1]));
+    if ( m.find(low) != m.end() ){
+      cerr << "Information: multiple entry '" << low << "' in general lex" << endl;
+    }
+    if ( res != General::NO_GENERAL ){
+      // no use to store undefined values
+      m[low] = res;
+    }
+  }
+  return true;
+}
+
+bool fill_general(map<string,General::Type>& m, const string& filename) {
+  ifstream is( filename.c_str() );
+  if (is) {
+    return fill_general(m, is);
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_adverbs(map<string,Adverb::adverb>& m, istream& is){
+  string line;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    vector<string> parts;
+    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
+    if ( n != 3 ){
+      cerr << "skip line: " << line << " (expected 3 values, got "
+       << n << ")" << endl;
+      continue;
+    }
+    string low = TiCC::trim(TiCC::lowercase(parts[0]));
+    Adverb::adverb a;
+    a.type = Adverb::classifyType(TiCC::lowercase(parts[1]));
+    a.subtype = Adverb::classifySubType(TiCC::lowercase(parts[2]));
+    if ( m.find(low) != m.end() ){
+      cerr << "Information: multiple entry '" << low << "' in adverbs lex" << endl;
+    }
+    if ( a.type != Adverb::NO_ADVERB ){
+      // no use to store undefined values
+      m[low] = a;
+    }
+  }
+  return true;
+}
+
+bool fill_adverbs(map<string,Adverb::adverb>& m, const string& filename) {
+  ifstream is( filename.c_str() );
+  if (is) {
+    return fill_adverbs(m, is);
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_freqlex( map<string,cf_data>& m, long int& total,
+		   double clip, istream& is ){
+  total = 0;
+  string line;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    vector<string> parts;
+    size_t n = TiCC::split_at( line, parts, "\t" ); // split at tabs
+    if ( n != 4 ){
+      cerr << "skip line: " << line << " (expected 4 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    cf_data data;
+    data.count = TiCC::stringTo<long int>( parts[1] );
+    data.freq = TiCC::stringTo<double>( parts[3] );
+    if ( data.count == 1 ){
+      // we are done. Skip all singleton stuff
+      return true;
+    }
+    if ( clip > 0 ){
+      // skip low frequent word, when desired
+      if ( data.freq > clip ){
+	return true;
+      }
+    }
+    total += data.count;
+    m[parts[0]] = data;
+  }
+  return true;
+}
+
+bool fill_freqlex( map<string,cf_data>& m, long int& total,
+		   double clip, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    fill_freqlex( m, total, clip, is );
+    return true;
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_topvals( map<string,top_val>& m, istream& is ){
+  string line;
+  int line_count = 0;
+  top_val val = top2000;
+  while( safe_getline( is, line ) ){
+    line = TiCC::trim( line );
+    if ( line.empty() )
+      continue;
+    ++line_count;
+    if ( line_count > 10000 )
+      val = top20000;
+    else if ( line_count > 5000 )
+      val = top10000;
+    else if ( line_count > 3000 )
+      val = top5000;
+    else if ( line_count > 2000 )
+      val = top3000;
+    else if ( line_count > 1000 )
+      val = top2000;
+    else
+      val = top1000;
+    vector<string> parts;
+    size_t n = TiCC::split_at( line, parts, "\t" ); // split at tabs
+    if ( n != 4 ){
+      cerr << "skip line: " << line << " (expected 2 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    m[parts[0]] = val;
+  }
+  return true;
+}
+
+bool fill_topvals( map<string,top_val>& m, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill_topvals( m, is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_connectors( map<CGN::Type,set<string> >& c1,
+		      set<string>& cM,
+		      istream& is ){
+  cM.clear();
+  string line;
+  while( safe_getline( is, line ) ){
+    // a line is supposed to be :
+    // a comment, starting with '#'
+    // like: '# comment'
+    // OR an entry of 1 to 4 words seperated by a single space
+    // like: 'dus' OR 'de facto'
+    // OR the 1 word followed by a TAB ('\t') and a CGN tag
+    // like: 'maar   VG'
+    line = TiCC::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    vector<string> vec;
+    int n = TiCC::split_at( line, vec, "\t" );
+    if ( n == 0 || n > 2 ){
+      cerr << "skip line: " << line << " (expected 1 or 2 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    CGN::Type tag = CGN::UNASS;
+    if ( n == 2 ){
+      tag = CGN::toCGN( vec[1] );
+    }
+    vector<string> dum;
+    n = TiCC::split_at( vec[0], dum, " " );
+    if ( n < 1 || n > 4 ){
+      cerr << "skip line: " << line
+	   << " (expected 1, to 4 values in the first part: " << vec[0]
+	   << ", got " << n << ")" << endl;
+      continue;
+    }
+    if ( n == 1 ){
+      c1[tag].insert( vec[0] );
+    }
+    else if ( n > 1 && tag != CGN::UNASS ){
+      cerr << "skip line: " << line
+	   << " (no GCN tag info allowed for multiword entries) " << endl;
+      continue;
+    }
+    else {
+      cM.insert( vec[0] );
+    }
+  }
+  return true;
+}
+
+bool fill_connectors( map<CGN::Type, set<string> >& c1,
+		      set<string>& cM,
+		      const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill_connectors( c1, cM, is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_vzexpr( set<string>& vz2, set<string>& vz3, set<string>& vz4,
+		  istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    // a line is supposed to be :
+    // a comment, starting with '#'
+    // like: '# comment'
+    // OR an entry of 2, 3 or 4 words seperated by whitespace
+    line = TiCC::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    vector<string> vec;
+    int n = TiCC::split_at_first_of( line, vec, " \t" );
+    if ( n == 0 || n > 4 ){
+      cerr << "skip line: " << line << " (expected 2, 3 or 4 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    switch ( n ){
+    case 2: {
+      string line = vec[0] + " " + vec[1];
+      vz2.insert( line );
+    }
+      break;
+    case 3: {
+      string line = vec[0] + " " + vec[1] + " " + vec[2];
+      vz3.insert( line );
+    }
+      break;
+    case 4: {
+      string line = vec[0] + " " + vec[1] + " " + vec[2] + " " + vec[3];
+      vz4.insert( line );
+    }
+      break;
+    default:
+      throw logic_error( "switch out of range" );
+    }
+  }
+  return true;
+}
+
+bool fill_vzexpr( set<string>& vz2, set<string>& vz3, set<string>& vz4,
+		  const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill_vzexpr( vz2, vz3, vz4 , is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill( map<string,Afk::Type>& afkos, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    // a line is supposed to be :
+    // a comment, starting with '#'
+    // like: '# comment'
+    // OR an entry of 2 words seperated by whitespace
+    line = TiCC::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    vector<string> vec;
+    int n = TiCC::split_at_first_of( line, vec, " \t" );
+    if ( n < 2 ){
+      cerr << "skip line: " << line << " (expected at least 2 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+    if ( n == 2 ){
+      Afk::Type at = Afk::classify( vec[1] );
+      if ( at != Afk::NO_A )
+	afkos[vec[0]] = at;
+    }
+    else if ( n == 3 ){
+      Afk::Type at = Afk::classify( vec[2] );
+      if ( at != Afk::NO_A ){
+	string s = vec[0] + " " + vec[1];
+	afkos[s] = at;
+      }
+    }
+    else if ( n == 4 ){
+      Afk::Type at = Afk::classify( vec[3] );
+      if ( at != Afk::NO_A ){
+	string s = vec[0] + " " + vec[1] + " " + vec[2];
+	afkos[s] = at;
+      }
+    }
+    else {
+      cerr << "skip line: " << line << " (expected at most 4 values, got "
+	   << n << ")" << endl;
+      continue;
+    }
+  }
+  return true;
+}
+
+bool fill( map<string,Afk::Type>& afks, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill( afks , is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_prevalences( map<string, prevalence>& prevalences, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    // a line is supposed to be :
+    // a comment, starting with '#'
+    // like: '# comment'
+    // OR: a lemma with prevalence values in columns 2 and 3
+    line = TiCC::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    vector<string> vec;
+    int n = TiCC::split_at_first_of( line, vec, " \t" );
+    if ( n != 6 ) {
+      cerr << "skip line: " << line << " (expected 6 values, got " << n << ")" << endl;
+      continue;
+    }
+    else {
+      prevalence p;
+      p.percentage = TiCC::stringTo<double>(vec[2]);
+      p.zscore = TiCC::stringTo<double>(vec[3]);
+      prevalences[vec[0]] = p;
+    }
+  }
+  return true;
+}
+
+bool fill_prevalences( map<string, prevalence>& prevalences, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill_prevalences( prevalences, is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill_stop_lemmata( map<CGN::Type, set<string> >& stop_lemmata, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    // a line is supposed to be :
+    // a comment, starting with '#'
+    // like: '# comment'
+    // OR: a lemma followed by an optional CGN tag
+    line = TiCC::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    vector<string> vec;
+    int n = TiCC::split_at_first_of( line, vec, " \t" );
+    if ( n == 0 || n > 2 ) {
+      cerr << "skip line: " << line << " (expected 1 or 2 values, got "
+     << n << ")" << endl;
+      continue;
+    }
+    CGN::Type tag = CGN::UNASS;
+    if ( n == 2 ){
+      tag = CGN::toCGN(vec[1]);
+    }
+    stop_lemmata[tag].insert(vec[0]);
+  }
+  return true;
+}
+
+bool fill_stop_lemmata( map<CGN::Type, set<string> >& stop_lemmata, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill_stop_lemmata( stop_lemmata, is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+bool fill( map<string,tagged_classification>& my_classification, istream& is ){
+  string line;
+  while( safe_getline( is, line ) ){
+    // a line is supposed to be :
+    // a comment, starting with '#'
+    // like: '# comment'
+    // OR: a lemma with an optional pos-tag, followed by a categorization
+    line = TiCC::trim( line );
+    if ( line.empty() || line[0] == '#' )
+      continue;
+    vector<string> vec;
+    int n = TiCC::split_at_first_of( line, vec, " \t" );
+    if ( n < 2 ) {
+      cerr << "skip line: " << line << " (expected at least 2 values, got " << n << ")" << endl;
+      continue;
+    }
+    if ( n == 2 ) {
+      tagged_classification tc;
+      tc.tag = CGN::UNASS;
+      tc.classification = vec[1];
+      my_classification[vec[0]] = tc;
+    }
+    else if ( n == 3 ) {
+      tagged_classification tc;
+      tc.tag = CGN::toCGN( vec[1] );
+      tc.classification = vec[2];
+      my_classification[vec[0]] = tc;
+    }
+    else {
+      cerr << "skip line: " << line << " (expected at most 3 values, got " << n << ")" << endl;
+      continue;
+    }
+  }
+  return true;
+}
+
+bool fill( map<string,tagged_classification>& my_classification, const string& filename ){
+  ifstream is( filename.c_str() );
+  if ( is ){
+    return fill( my_classification , is );
+  }
+  else {
+    cerr << "couldn't open file: " << filename << endl;
+  }
+  return false;
+}
+
+map<string,tag_mask> tag_masks( const map<CGN::Type, set<string> >& m ){
+  map<string,tag_mask> result;
+  for ( const auto& it : m ){
+    for ( const auto& key : it.second ){
+      result[key] |= tag_bit( it.first );
+    }
+  }
+  return result;
+}
+
+map<string,noun_entry> noun_entries( const map<string,noun>& m,
+				     Lexicon::Builder& builder ){
+  map<string,noun_entry> result;
+  for ( const auto& it : m ){
+    noun_entry e;
+    e.type = it.second.type;
+    e.is_compound = it.second.is_compound;
+    e.compound_parts = it.second.compound_parts;
+    e.head = builder.add_string( it.second.head );
+    e.satellite_clean = builder.add_string( it.second.satellite_clean );
+    result[it.first] = e;
+  }
+  return result;
+}
+
+map<string,classification_entry> classification_entries( const map<string,tagged_classification>& m,
+							 Lexicon::Builder& builder ){
+  map<string,classification_entry> result;
+  for ( const auto& it : m ){
+    classification_entry e;
+    e.tag = it.second.tag;
+    e.classification = builder.add_string( it.second.classification );
+    result[it.first] = e;
+  }
+  return result;
+}
+
+bool tagged_lookup( const Lexicon::Table<tag_mask>& t,
+		    CGN::Type tag,
+		    const string& key ){
+  // the key is found when it is listed for 'tag' or without a tag
+  const tag_mask *mask = t.find( key );
+  return mask
+    && ( *mask & ( tag_bit( tag ) | tag_bit( CGN::UNASS ) ) ) != 0;
+}
+
+string config_file( const TiCC::Configuration& cf, const string& key ){
+  // most lexicons are searched relative to the configDir
+  string val = cf.lookUp( key );
+  if ( val.empty() ){
+    return val;
+  }
+  return cf.configDir() + "/" + val;
+}
+
+// One text lexicon: 'read' parses the file, 'add' stores the result in
+// the lexicon builder and returns the number of entries.
+struct lexicon_job {
+  string name;
+  function<bool()> read;
+  function<size_t( Lexicon::Builder& )> add;
+  bool ok;
+  long int msecs;
+};
+
+template <typename M>
+static void queue_lexicon( vector<lexicon_job>& jobs,
+		   const string& name,
+		   const function<bool( M& )>& read,
+		   const function<size_t( Lexicon::Builder&, const M& )>& add ){
+  auto m = make_shared<M>();
+  lexicon_job job;
+  job.name = name;
+  job.read = [=]{ return read( *m ); };
+  job.add = [=]( Lexicon::Builder& b ){ return add( b, *m ); };
+  job.ok = false;
+  job.msecs = 0;
+  jobs.push_back( job );
+}
+
+// Reads the files of all jobs side by side, and adds them to the builder in
+// order, as the builder isn't thread safe. false when a file can't be read.
+static bool read_lexicons( vector<lexicon_job>& jobs,
+			   Lexicon::Builder& builder ){
+#pragma omp parallel for schedule(dynamic)
+  for ( long int i=0; i < (long int)jobs.size(); ++i ){
+    auto start = chrono::steady_clock::now();
+    jobs[i].ok = jobs[i].read();
+    jobs[i].msecs = chrono::duration_cast<chrono::milliseconds>
+      ( chrono::steady_clock::now() - start ).count();
+  }
+  bool failed = false;
+  for ( auto& job : jobs ){
+    if ( !job.ok ){
+      failed = true;
+      continue;
+    }
+    size_t entries = job.add( builder );
+    cerr << "read lexicon " << job.name << ": " << entries
+	 << " entries in " << job.msecs << " ms" << endl;
+    // the parsed text isn't needed anymore
+    job.read = nullptr;
+    job.add = nullptr;
+  }
+  return !failed;
+}
+
+void settingData::init( const TiCC::Configuration& cf, bool use_bundle ){
+  doXfiles = true;
+  doAlpino = false;
+  doAlpinoServer = false;
+  doFrogSyntax = false;
+  string val = cf.lookUp( "useAlpinoServer" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, doAlpinoServer ) ){
+      cerr << "invalid value for 'useAlpinoServer' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  if ( !doAlpinoServer ){
+    val = cf.lookUp( "useAlpino" );
+    if( !TiCC::stringTo( val, doAlpino ) ){
+      cerr << "invalid value for 'useAlpino' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  alpinoSplit = 0;
+  val = cf.lookUp( "split", "alpino" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, alpinoSplit ) ){
+      cerr << "invalid value for 'split' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  alpinoDump = cf.lookUp( "dump", "alpino" );
+  if ( !alpinoDump.empty() ){
+    if ( alpinoDump[0] != '/' ){
+      alpinoDump = cf.configDir() + "/" + alpinoDump;
+    }
+    alpinoDump += "/";
+  }
+  doWopr = false;
+  val = cf.lookUp( "useWopr" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, doWopr ) ){
+      cerr << "invalid value for 'useWopr' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  showProblems = true;
+  val = cf.lookUp( "logProblems" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, showProblems ) ){
+      cerr << "invalid value for 'showProblems' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  sentencePerLine = false;
+  val = cf.lookUp( "sentencePerLine" );
+  if ( !val.empty() ){
+    if ( !TiCC::stringTo( val, sentencePerLine ) ){
+      cerr << "invalid value for 'sentencePerLine' in config file" << endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+  val = cf.lookUp( "styleSheet" );
+  if( !val.empty() ){
+    style = val;
+  }
+  val = cf.lookUp( "rarityLevel" );
+  if ( val.empty() ){
+    rarityLevel = 10;
+  }
+  else if ( !TiCC::stringTo( val, rarityLevel ) ){
+    cerr << "invalid value for 'rarityLevel' in config file" << endl;
+  }
+  val = cf.lookUp( "overlapSize" );
+  if ( val.empty() ){
+    overlapSize = 50;
+  }
+  else if ( !TiCC::stringTo( val, overlapSize ) ){
+    cerr << "invalid value for 'overlapSize' in config file" << endl;
+    exit( EXIT_FAILURE );
+  }
+  val = cf.lookUp( "featureMemo" );
+  if ( val.empty() ){
+    featureMemo = 100000;
+  }
+  else if ( !TiCC::stringTo( val, featureMemo ) ){
+    cerr << "invalid value for 'featureMemo' in config file" << endl;
+    exit( EXIT_FAILURE );
+  }
+  val = cf.lookUp( "frequencyClip" );
+  if ( val.empty() ){
+    freq_clip = 90;
+  }
+  else if ( !TiCC::stringTo( val, freq_clip )
+	    || (freq_clip < 0) || (freq_clip > 100) ){
+    cerr << "invalid value for 'frequencyClip' in config file" << endl;
+    exit( EXIT_FAILURE );
+  }
+  val = cf.lookUp( "mtldThreshold" );
+  if ( val.empty() ){
+    mtld_threshold = 0.720;
+  }
+  else if ( !TiCC::stringTo( val, mtld_threshold )
+	    || (mtld_threshold < 0) || (mtld_threshold > 1.0) ){
+    cerr << "invalid value for 'frequencyClip' in config file" << endl;
+    exit( EXIT_FAILURE );
+  }
+  if ( !load_lexicons( cf, use_bundle ) ){
+    exit( EXIT_FAILURE );
+  }
+}
+
+bool settingData::load_lexicons( const TiCC::Configuration& cf,
+				 bool use_bundle ){
+  Lexicon::Builder builder;
+  string val;
+  if ( use_bundle ){
+    val = cf.lookUp( "lexicon_bundle" );
+    if ( !val.empty() ){
+      string file = val;
+      if ( file[0] != '/' ){
+	file = cf.configDir() + "/" + val;
+      }
+      string error;
+      if ( !compiled.load( file, error ) ){
+	cerr << error << endl;
+	return false;
+      }
+      cerr << "using lexicon bundle " << file << endl;
+    }
+  }
+  // the text lexicons that aren't taken from the bundle are read side by
+  // side, then added to the builder one by one, in this order
+  vector<lexicon_job> jobs;
+  string file = cf.lookUp( "adj_semtypes" );
+  if ( !file.empty() ){
+    // 20150316: Full path necessary to allow custom input
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "adj_semtypes" }, src ) ){
+      typedef map<string,SEM::Type> M;
+      queue_lexicon<M>( jobs, "adj_semtypes",
+			[=]( M& m ){ return fill( CGN::ADJ, m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "adj_semtypes", m, src );
+			  return m.size(); } );
+    }
+  }
+  file = cf.lookUp( "noun_semtypes" );
+  if ( !file.empty() ){
+    // 20141121: Full path necessary to allow custom input
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "noun_semtypes" }, src ) ){
+      typedef map<string,noun> M;
+      queue_lexicon<M>( jobs, "noun_semtypes",
+			[=]( M& m ){ return fillN( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "noun_semtypes", noun_entries( m, b ), src );
+			  return m.size(); } );
+    }
+  }
+  file = config_file( cf, "verb_semtypes" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "verb_semtypes" }, src ) ){
+      typedef map<string,SEM::Type> M;
+      queue_lexicon<M>( jobs, "verb_semtypes",
+			[=]( M& m ){ return fill( CGN::WW, m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "verb_semtypes", m, src );
+			  return m.size(); } );
+    }
+  }
+  file = cf.lookUp( "intensify" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "intensify" }, src ) ){
+      typedef map<string,Intensify::Type> M;
+      queue_lexicon<M>( jobs, "intensify",
+			[=]( M& m ){ return fill_intensify( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "intensify", m, src );
+			  return m.size(); } );
+    }
+  }
+  const string general_keys[] = { "general_nouns", "general_verbs" };
+  for ( const auto& key : general_keys ){
+    file = config_file( cf, key );
+    if ( !file.empty() ){
+      Lexicon::sourceInfo src( file );
+      if ( !use_compiled( { key }, src ) ){
+	typedef map<string,General::Type> M;
+	queue_lexicon<M>( jobs, key,
+			  [=]( M& m ){ return fill_general( m, file ); },
+			  [=]( Lexicon::Builder& b, const M& m ){
+			    b.add_table( key, m, src );
+			    return m.size(); } );
+      }
+    }
+  }
+  file = config_file( cf, "adverbs" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "adverbs" }, src ) ){
+      typedef map<string,Adverb::adverb> M;
+      queue_lexicon<M>( jobs, "adverbs",
+			[=]( M& m ){ return fill_adverbs( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "adverbs", m, src );
+			  return m.size(); } );
+    }
+  }
+  const string freq_keys[] = { "staph_word_freq_lex",
+			       "word_freq_lex",
+			       "lemma_freq_lex" };
+  for ( const auto& key : freq_keys ){
+    file = config_file( cf, key );
+    if ( !file.empty() ){
+      // the frequencyClip determines which entries are stored
+      Lexicon::sourceInfo src( file, freq_clip );
+      if ( !use_compiled( { key }, src ) ){
+	typedef pair<map<string,cf_data>,long int> M; // entries and total
+	double clip = freq_clip;
+	queue_lexicon<M>( jobs, key,
+			  [=]( M& m ){
+			    m.second = 0;
+			    return fill_freqlex( m.first, m.second, clip, file ); },
+			  [=]( Lexicon::Builder& b, const M& m ){
+			    Lexicon::sourceInfo totalled = src;
+			    totalled.total = m.second;
+			    b.add_table( key, m.first, totalled );
+			    return m.first.size(); } );
+      }
+    }
+  }
+  file = config_file( cf, "top_freq_lex" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "top_freq_lex" }, src ) ){
+      typedef map<string,top_val> M;
+      queue_lexicon<M>( jobs, "top_freq_lex",
+			[=]( M& m ){ return fill_topvals( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "top_freq_lex", m, src );
+			  return m.size(); } );
+    }
+  }
+  const string connector_keys[] = { "temporals",
+				    "opsom_connectors_wg",
+				    "opsom_connectors_zin",
+				    "contrast",
+				    "compars",
+				    "causals",
+				    "causal_situation",
+				    "space_situation",
+				    "time_situation",
+				    "emotion_situation" };
+  for ( const auto& key : connector_keys ){
+    file = config_file( cf, key );
+    if ( !file.empty() ){
+      Lexicon::sourceInfo src( file );
+      if ( !use_compiled( { key, key + ".multi" }, src ) ){
+	// single words per tag, and multi-word connectors
+	typedef pair<map<CGN::Type, set<string> >,set<string> > M;
+	queue_lexicon<M>( jobs, key,
+			  [=]( M& m ){
+			    return fill_connectors( m.first, m.second, file ); },
+			  [=]( Lexicon::Builder& b, const M& m ){
+			    map<string,tag_mask> c1 = tag_masks( m.first );
+			    b.add_table( key, c1, src );
+			    b.add_set( key + ".multi", m.second, src );
+			    return c1.size() + m.second.size(); } );
+      }
+    }
+  }
+  file = config_file( cf, "voorzetselexpr" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "voorzetselexpr.2",
+			  "voorzetselexpr.3",
+			  "voorzetselexpr.4" }, src ) ){
+      typedef vector<set<string> > M; // expressions of 2, 3 and 4 words
+      queue_lexicon<M>( jobs, "voorzetselexpr",
+			[=]( M& m ){
+			  m.resize( 3 );
+			  return fill_vzexpr( m[0], m[1], m[2], file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_set( "voorzetselexpr.2", m[0], src );
+			  b.add_set( "voorzetselexpr.3", m[1], src );
+			  b.add_set( "voorzetselexpr.4", m[2], src );
+			  return m[0].size() + m[1].size() + m[2].size(); } );
+    }
+  }
+  file = config_file( cf, "afkortingen" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "afkortingen" }, src ) ){
+      typedef map<string,Afk::Type> M;
+      queue_lexicon<M>( jobs, "afkortingen",
+			[=]( M& m ){ return fill( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "afkortingen", m, src );
+			  return m.size(); } );
+    }
+  }
+  file = config_file( cf, "prevalence" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "prevalence" }, src ) ){
+      typedef map<string,prevalence> M;
+      queue_lexicon<M>( jobs, "prevalence",
+			[=]( M& m ){ return fill_prevalences( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "prevalence", m, src );
+			  return m.size(); } );
+    }
+  }
+  file = cf.lookUp( "stop_lemmata" );
+  if ( !file.empty() ){
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "stop_lemmata" }, src ) ){
+      typedef map<CGN::Type, set<string> > M;
+      queue_lexicon<M>( jobs, "stop_lemmata",
+			[=]( M& m ){ return fill_stop_lemmata( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  map<string,tag_mask> masks = tag_masks( m );
+			  b.add_table( "stop_lemmata", masks, src );
+			  return masks.size(); } );
+    }
+  }
+  file = cf.lookUp( "my_classification" );
+  if ( !file.empty() ){
+    // full path necessary to allow custom input
+    Lexicon::sourceInfo src( file );
+    if ( !use_compiled( { "my_classification" }, src ) ){
+      typedef map<string,tagged_classification> M;
+      queue_lexicon<M>( jobs, "my_classification",
+			[=]( M& m ){ return fill( m, file ); },
+			[=]( Lexicon::Builder& b, const M& m ){
+			  b.add_table( "my_classification",
+				       classification_entries( m, b ), src );
+			  return m.size(); } );
+    }
+  }
+  if ( !read_lexicons( jobs, builder ) ){
+    return false;
+  }
+
+  loaded.assign( builder );
+  bind_tables();
+  // the fused word table can only be taken from the bundle when it was
+  // compiled from exactly the lexicons used now
+  Lexicon::sourceInfo fused;
+  fused.file = word_table_signature();
+  if ( !use_compiled( { "words" }, fused ) ){
+    fuse( builder, fused );
+    loaded.assign( builder );
+    bind_tables();
+  }
+  bind( "words", words );
+  build_phrases();
+  return true;
+}
+
+size_t settingData::heap_size() const {
+  return loaded.size() + phrases.heap_size();
+}
+
+void settingData::bind_tables(){
+  bind( "adj_semtypes", adj_sem );
+  bind( "noun_semtypes", noun_sem );
+  bind( "verb_semtypes", verb_sem );
+  bind( "intensify", intensify );
+  bind( "general_nouns", general_nouns );
+  bind( "general_verbs", general_verbs );
+  bind( "adverbs", adverbs );
+  bind( "staph_word_freq_lex", staph_word_freq_lex );
+  staph_total = table_total( "staph_word_freq_lex" );
+  bind( "word_freq_lex", word_freq_lex );
+  word_total = table_total( "word_freq_lex" );
+  bind( "lemma_freq_lex", lemma_freq_lex );
+  lemma_total = table_total( "lemma_freq_lex" );
+  bind( "top_freq_lex", top_freq_lex );
+  bind( "temporals", temporals1 );
+  bind( "temporals.multi", multi_temporals );
+  bind( "opsom_connectors_wg", opsommers_wg );
+  bind( "opsom_connectors_wg.multi", multi_opsommers_wg );
+  bind( "opsom_connectors_zin", opsommers_zin );
+  bind( "opsom_connectors_zin.multi", multi_opsommers_zin );
+  bind( "contrast", contrast1 );
+  bind( "contrast.multi", multi_contrast );
+  bind( "compars", compars1 );
+  bind( "compars.multi", multi_compars );
+  bind( "causals", causals1 );
+  bind( "causals.multi", multi_causals );
+  bind( "causal_situation", causal_sits );
+  bind( "causal_situation.multi", multi_causal_sits );
+  bind( "space_situation", space_sits );
+  bind( "space_situation.multi", multi_space_sits );
+  bind( "time_situation", time_sits );
+  bind( "time_situation.multi", multi_time_sits );
+  bind( "emotion_situation", emotion_sits );
+  bind( "emotion_situation.multi", multi_emotion_sits );
+  bind( "voorzetselexpr.2", vzexpr2 );
+  bind( "voorzetselexpr.3", vzexpr3 );
+  bind( "voorzetselexpr.4", vzexpr4 );
+  bind( "afkortingen", afkos );
+  bind( "prevalence", prevalences );
+  bind( "stop_lemmata", stop_lemmata );
+  bind( "my_classification", my_classification );
+}
+
+// the tables the fused word table is made of
+static const char *word_tables[] = {
+  "adj_semtypes", "noun_semtypes", "verb_semtypes", "intensify",
+  "general_nouns", "general_verbs", "adverbs", "staph_word_freq_lex",
+  "word_freq_lex", "lemma_freq_lex", "top_freq_lex", "temporals",
+  "opsom_connectors_wg", "opsom_connectors_zin", "contrast", "compars",
+  "causals", "causal_situation", "space_situation", "time_situation",
+  "emotion_situation", "afkortingen", "prevalence", "stop_lemmata",
+  "my_classification", 0 };
+
+// Describes the sources of all component tables, so a compiled word table
+// is only used when it was fused from the same lexicons.
+string settingData::word_table_signature() const {
+  string result;
+  for ( const char **name = word_tables; *name; ++name ){
+    const Lexicon::Image *img = &loaded;
+    if ( from_compiled.find( *name ) != from_compiled.end() ){
+      img = &compiled;
+    }
+    const Lexicon::tableEntry *e = img->entry( *name );
+    if ( !e ){
+      continue;
+    }
+    ostringstream os;
+    os << *name << ":" << img->str( e->source ) << ":" << e->source_size << ":" << e->source_mtime
+       << ":" << e->param << ":" << e->count << ";";
+    result += os.str();
+  }
+  return result;
+}
+
+template <typename R>
+static void add_phrases( Phrases& phrases,
+			 const Lexicon::Table<R>& t,
+			 Phrases::Form form,
+			 uint32_t category ){
+  // single words are left out by Phrases::add
+  for ( size_t i=0; i < t.size(); ++i ){
+    phrases.add( form, t.key( i ), category );
+  }
+}
+
+// Compiles all multi-word lists into one trie, so sentStats finds the
+// expressions in a sentence in one pass.
+void settingData::build_phrases(){
+  phrases.clear();
+  const Lexicon::Table<uint8_t> *conns[CONN_LISTS];
+  conns[TEMPORALS] = &multi_temporals;
+  conns[OPSOMMERS_WG] = &multi_opsommers_wg;
+  conns[OPSOMMERS_ZIN] = &multi_opsommers_zin;
+  conns[CONTRAST] = &multi_contrast;
+  conns[COMPARS] = &multi_compars;
+  conns[CAUSALS] = &multi_causals;
+  for ( int i=0; i < CONN_LISTS; ++i ){
+    add_phrases( phrases, *conns[i], Phrases::LTEXT,
+		 conn_phrase( conn_list(i) ) );
+  }
+  const char *negatives_long[] = { "afgezien van", "zomin als",
+				   "met uitzondering van" };
+  for ( const auto& neg : negatives_long ){
+    phrases.add( Phrases::LTEXT, neg, NEG_LONG );
+  }
+  const Lexicon::Table<uint8_t> *sits[SIT_LISTS];
+  sits[TIME_SITS] = &multi_time_sits;
+  sits[CAUSAL_SITS] = &multi_causal_sits;
+  sits[SPACE_SITS] = &multi_space_sits;
+  sits[EMOTION_SITS] = &multi_emotion_sits;
+  for ( int i=0; i < SIT_LISTS; ++i ){
+    add_phrases( phrases, *sits[i], Phrases::LEMMA,
+		 sit_phrase( sit_list(i) ) );
+  }
+  add_phrases( phrases, intensify, Phrases::TEXT, MULTI_INTENSIFY );
+  add_phrases( phrases, vzexpr2, Phrases::LTEXT, PREP_EXPR );
+  add_phrases( phrases, vzexpr3, Phrases::LTEXT, PREP_EXPR );
+  add_phrases( phrases, vzexpr4, Phrases::LTEXT, PREP_EXPR );
+  add_phrases( phrases, afkos, Phrases::TEXT, MULTI_AFK );
+}
+
+template <typename R>
+static void add_keys( const Lexicon::Table<R>& t,
+		      map<string,word_entry>& words ){
+  for ( size_t i=0; i < t.size(); ++i ){
+    string key = t.key( i );
+    if ( words.find( key ) == words.end() ){
+      word_entry e;
+      memset( &e, 0, sizeof(e) );
+      words[key] = e;
+    }
+  }
+}
+
+// Adds the 'words' table, which holds for every string what all single
+// word lexicons know about it.
+void settingData::fuse( Lexicon::Builder& builder,
+			const Lexicon::sourceInfo& src ) const {
+  const Lexicon::Table<tag_mask> *conns[CONN_LISTS];
+  conns[TEMPORALS] = &temporals1;
+  conns[OPSOMMERS_WG] = &opsommers_wg;
+  conns[OPSOMMERS_ZIN] = &opsommers_zin;
+  conns[CONTRAST] = &contrast1;
+  conns[COMPARS] = &compars1;
+  conns[CAUSALS] = &causals1;
+  const Lexicon::Table<tag_mask> *sits[SIT_LISTS];
+  sits[TIME_SITS] = &time_sits;
+  sits[CAUSAL_SITS] = &causal_sits;
+  sits[SPACE_SITS] = &space_sits;
+  sits[EMOTION_SITS] = &emotion_sits;
+  map<string,word_entry> m;
+  add_keys( adj_sem, m );
+  add_keys( noun_sem, m );
+  add_keys( verb_sem, m );
+  add_keys( intensify, m );
+  add_keys( general_nouns, m );
+  add_keys( general_verbs, m );
+  add_keys( adverbs, m );
+  add_keys( staph_word_freq_lex, m );
+  add_keys( word_freq_lex, m );
+  add_keys( lemma_freq_lex, m );
+  add_keys( top_freq_lex, m );
+  for ( int i=0; i < CONN_LISTS; ++i ){
+    add_keys( *conns[i], m );
+  }
+  for ( int i=0; i < SIT_LISTS; ++i ){
+    add_keys( *sits[i], m );
+  }
+  add_keys( afkos, m );
+  add_keys( prevalences, m );
+  add_keys( stop_lemmata, m );
+  add_keys( my_classification, m );
+  for ( auto& it : m ){
+    const string& key = it.first;
+    word_entry& e = it.second;
+    for ( int i=0; i < CONN_LISTS; ++i ){
+      const tag_mask *t = conns[i]->find( key );
+      e.connectives[i] = t ? *t : 0;
+    }
+    for ( int i=0; i < SIT_LISTS; ++i ){
+      const tag_mask *t = sits[i]->find( key );
+      e.situations[i] = t ? *t : 0;
+    }
+    const tag_mask *stop = stop_lemmata.find( key );
+    e.stop = stop ? *stop : 0;
+    const SEM::Type *sem = adj_sem.find( key );
+    if ( sem ){
+      e.fields |= ADJ_SEM;
+      e.adj_sem = *sem;
+    }
+    sem = verb_sem.find( key );
+    if ( sem ){
+      e.fields |= VERB_SEM;
+      e.verb_sem = *sem;
+    }
+    const noun_entry *n = noun_sem.find( key );
+    if ( n ){
+      e.fields |= NOUN_SEM;
+      e.noun = *n;
+      e.noun.head = builder.add_string( noun_sem.str( n->head ) );
+      e.noun.satellite_clean
+	= builder.add_string( noun_sem.str( n->satellite_clean ) );
+    }
+    const Intensify::Type *ints = intensify.find( key );
+    if ( ints ){
+      e.fields |= INTENSIFY;
+      e.intensify = *ints;
+    }
+    const General::Type *gen = general_nouns.find( key );
+    if ( gen ){
+      e.fields |= GENERAL_NOUN;
+      e.general_noun = *gen;
+    }
+    gen = general_verbs.find( key );
+    if ( gen ){
+      e.fields |= GENERAL_VERB;
+      e.general_verb = *gen;
+    }
+    const Adverb::adverb *adv = adverbs.find( key );
+    if ( adv ){
+      e.fields |= ADVERB;
+      e.adverb = *adv;
+    }
+    const cf_data *cf = staph_word_freq_lex.find( key );
+    if ( cf ){
+      e.fields |= STAPH_FREQ;
+      e.staph_freq = *cf;
+    }
+    cf = word_freq_lex.find( key );
+    if ( cf ){
+      e.fields |= WORD_FREQ;
+      e.word_freq = *cf;
+    }
+    cf = lemma_freq_lex.find( key );
+    if ( cf ){
+      e.fields |= LEMMA_FREQ;
+      e.lemma_freq = *cf;
+    }
+    const top_val *top = top_freq_lex.find( key );
+    if ( top ){
+      e.fields |= TOP_FREQ;
+      e.top_freq = *top;
+    }
+    const prevalence *prev = prevalences.find( key );
+    if ( prev ){
+      e.fields |= PREVALENCE;
+      e.prev = *prev;
+    }
+    const Afk::Type *afk = afkos.find( key );
+    if ( afk ){
+      e.fields |= AFK;
+      e.afk = *afk;
+    }
+    const classification_entry *cl = my_classification.find( key );
+    if ( cl ){
+      e.fields |= CLASSIFICATION;
+      e.classification = *cl;
+      e.classification.classification
+	= builder.add_string( my_classification.str( cl->classification ) );
+    }
+  }
+  builder.add_table( "words", m, src );
+}
+
+// the custom word lists that can be layered over the shared lexicons
+static const char *overlay_lists[] = {
+  "noun_semtypes", "adj_semtypes", "intensify", "stop_lemmata",
+  "my_classification", 0 };
+
+// strings of this layer are marked, to tell them from the shared ones
+const uint32_t OVERLAY_STRING = 1u << 31;
+
+bool LexiconOverlay::is_list( const string& name ){
+  for ( const char **list = overlay_lists; *list; ++list ){
+    if ( name == *list ){
+      return true;
+    }
+  }
+  return false;
+}
+
+word_entry& LexiconOverlay::entry( const string& key ){
+  // a new entry starts as a copy of the shared one, if any
+  auto it = entries.find( key );
+  if ( it == entries.end() ){
+    word_entry e;
+    const word_entry *shared = base->words.find( key );
+    if ( shared ){
+      e = *shared;
+    }
+    else {
+      memset( &e, 0, sizeof(e) );
+    }
+    it = entries.insert( make_pair( key, e ) ).first;
+  }
+  return it->second;
+}
+
+uint32_t LexiconOverlay::add_string( const string& s ){
+  strings.push_back( s );
+  return ( strings.size() - 1 ) | OVERLAY_STRING;
+}
+
+LexiconOverlay::LexiconOverlay( const LexiconOverlay *below ):
+  base( below->base ),
+  entries( below->entries ),
+  strings( below->strings ),
+  multi( below->multi ),
+  memo( settings.featureMemo )
+{}
+
+bool LexiconOverlay::read( const string& name, const string& file ){
+  ifstream is( file.c_str() );
+  if ( !is ){
+    cerr << "couldn't open file: " << file << endl;
+    return false;
+  }
+  return read( name, is );
+}
+
+bool LexiconOverlay::read( const string& name, istream& is ){
+  size_t count = 0;
+  if ( name == "noun_semtypes" ){
+    map<string,noun> m;
+    if ( !fillN( m, is ) )
+      return false;
+    for ( const auto& it : m ){
+      word_entry& e = entry( it.first );
+      e.fields |= NOUN_SEM;
+      e.noun.type = it.second.type;
+      e.noun.is_compound = it.second.is_compound;
+      e.noun.compound_parts = it.second.compound_parts;
+      e.noun.head = add_string( it.second.head );
+      e.noun.satellite_clean = add_string( it.second.satellite_clean );
+    }
+    count = m.size();
+  }
+  else if ( name == "adj_semtypes" ){
+    map<string,SEM::Type> m;
+    if ( !fillADJ( m, is ) )
+      return false;
+    for ( const auto& it : m ){
+      word_entry& e = entry( it.first );
+      e.fields |= ADJ_SEM;
+      e.adj_sem = it.second;
+    }
+    count = m.size();
+  }
+  else if ( name == "intensify" ){
+    map<string,Intensify::Type> m;
+    if ( !fill_intensify( m, is ) )
+      return false;
+    for ( const auto& it : m ){
+      word_entry& e = entry( it.first );
+      e.fields |= INTENSIFY;
+      e.intensify = it.second;
+      multi.add( Phrases::TEXT, it.first, MULTI_INTENSIFY );
+    }
+    count = m.size();
+  }
+  else if ( name == "stop_lemmata" ){
+    map<CGN::Type, set<string> > m;
+    if ( !fill_stop_lemmata( m, is ) )
+      return false;
+    map<string,tag_mask> masks = tag_masks( m );
+    for ( const auto& it : masks ){
+      entry( it.first ).stop = it.second;
+    }
+    count = masks.size();
+  }
+  else if ( name == "my_classification" ){
+    map<string,tagged_classification> m;
+    if ( !fill( m, is ) )
+      return false;
+    for ( const auto& it : m ){
+      word_entry& e = entry( it.first );
+      e.fields |= CLASSIFICATION;
+      e.classification.tag = it.second.tag;
+      e.classification.classification
+	= add_string( it.second.classification );
+    }
+    count = m.size();
+  }
+  else {
+    cerr << "no custom word list '" << name << "' possible" << endl;
+    return false;
+  }
+  cerr << "custom " << name << ": " << count << " entries" << endl;
+  return true;
+}
+
+const word_entry *LexiconOverlay::find( const string& key ) const {
+  auto it = entries.find( key );
+  if ( it != entries.end() ){
+    return &it->second;
+  }
+  return base->words.find( key );
+}
+
+string LexiconOverlay::str( uint32_t off ) const {
+  if ( off & OVERLAY_STRING ){
+    return strings[off & ~OVERLAY_STRING];
+  }
+  return base->words.str( off );
+}
+
+// Returns true when all tables in 'names' can be taken from the compiled
+// lexicon bundle, i.e. they were compiled from the same, unchanged, source.
+bool settingData::use_compiled( const vector<string>& names,
+				const Lexicon::sourceInfo& src ){
+  if ( compiled.empty() ){
+    return false;
+  }
+  for ( const auto& name : names ){
+    if ( !compiled.is_current( name, src ) ){
+      cerr << "lexicon bundle: '" << name << "' is missing or outdated"
+	   << endl;
+      return false;
+    }
+  }
+  for ( const auto& name : names ){
+    cerr << "lexicon " << name << ": " << compiled.entry( name )->count
+	 << " entries, from the bundle" << endl;
+  }
+  from_compiled.insert( names.begin(), names.end() );
+  return true;
+}
+
+template <typename R>
+void settingData::bind( const string& name, Lexicon::Table<R>& t ) const {
+  if ( from_compiled.find( name ) != from_compiled.end() ){
+    compiled.table( name, t );
+  }
+  else if ( !loaded.table( name, t ) ){
+    t = Lexicon::Table<R>();
+  }
+}
+
+long int settingData::table_total( const string& name ) const {
+  const Lexicon::tableEntry *e = 0;
+  if ( from_compiled.find( name ) != from_compiled.end() ){
+    e = compiled.entry( name );
+  }
+  else {
+    e = loaded.entry( name );
+  }
+  return e ? e->total : 0;
+}
+
+bool settingData::save_lexicons( const string& filename ) const {
+  return loaded.save( filename );
+}
@@ -77,6 +77,8 @@ void structStats::CSVheader( ostream& os, const string& intro ) const {
   prepPhraseHeader( os );
   intensHeader( os );
   miscHeader( os );
+  os << ",Alpino_split,Syntax_frog";
+  scheduleHeader( os );
   os << endl;
 }
 
@@ -112,6 +114,9 @@ void structStats::toCSV( ostream& os ) const {
   prepPhraseToCSV( os );
   intensToCSV( os );
   miscToCSV( os );
+  os << "," << parseSplitCnt;
+  os << "," << frogSyntaxCnt;
+  scheduleToCSV( os );
 
   os << endl;
 }
@@ -1270,6 +1275,8 @@ void structStats::merge( structStats *ss ){
     parseFailCnt = -1;
   else
     parseFailCnt += ss->parseFailCnt;
+  parseSplitCnt += ss->parseSplitCnt;
+  frogSyntaxCnt += ss->frogSyntaxCnt;
   wordCnt += ss->wordCnt;
   wordInclCnt += ss->wordInclCnt;
   if ( ss->wordCnt != 0 ) // don't count sentences without words
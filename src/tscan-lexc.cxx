@@ -0,0 +1,98 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// tscan-lexc: compiles all lexicons referenced from a tscan configuration
+// into one lexicon bundle, which tscan maps into memory at startup.
+
+#include <string>
+#include <iostream>
+#include "config.h"
+#include "ticcutils/Configuration.h"
+#include "ticcutils/CommandLine.h"
+#include "tscan/settings.h"
+
+using namespace std;
+
+inline void usage(){
+  cerr << "usage:  tscan-lexc --config=<file> [-o <bundle>]" << endl;
+  cerr << "options: " << endl;
+  cerr << "\t--config=<file> read the lexicon names from 'file'" << endl;
+  cerr << "\t-o <bundle> store the bundle in 'bundle'. (default: the value "
+       << "of 'lexicon_bundle' in the config)" << endl;
+  cerr << "\t-V or --version show version " << endl;
+  cerr << endl;
+}
+
+int main( int argc, char *argv[] ){
+  TiCC::CL_Options opts( "hVo:", "config:,help,version" );
+  try {
+    opts.init( argc, argv );
+  }
+  catch( TiCC::OptionError& e ){
+    cerr << e.what() << endl;
+    usage();
+    exit( EXIT_FAILURE );
+  }
+  if ( opts.extract( 'h' ) ||
+       opts.extract( "help" ) ){
+    usage();
+    exit( EXIT_SUCCESS );
+  }
+  if ( opts.extract( 'V' ) ||
+       opts.extract( "version" ) ){
+    cerr << "tscan-lexc " << VERSION << endl;
+    exit( EXIT_SUCCESS );
+  }
+  string configFile;
+  opts.extract( "config", configFile );
+  string outName;
+  opts.extract( 'o', outName );
+  if ( !opts.empty() ){
+    cerr << "unsupported options in command: " << opts.toString() << endl;
+    exit( EXIT_FAILURE );
+  }
+  TiCC::Configuration config;
+  if ( configFile.empty() || !config.fill( configFile ) ){
+    cerr << "invalid configuration" << endl;
+    exit( EXIT_FAILURE );
+  }
+  if ( outName.empty() ){
+    string val = config.lookUp( "lexicon_bundle" );
+    if ( val.empty() ){
+      cerr << "no -o option, and no 'lexicon_bundle' in "
+	   << configFile << endl;
+      exit( EXIT_FAILURE );
+    }
+    outName = val;
+    if ( outName[0] != '/' ){
+      outName = config.configDir() + "/" + val;
+    }
+  }
+  // read all text lexicons, ignoring any existing bundle
+  settings.init( config, false );
+  if ( !settings.save_lexicons( outName ) ){
+    cerr << "storing the lexicon bundle in " << outName << " FAILED!" << endl;
+    exit( EXIT_FAILURE );
+  }
+  cerr << "stored the lexicon bundle in " << outName << endl;
+  exit( EXIT_SUCCESS );
+}
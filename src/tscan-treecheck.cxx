@@ -0,0 +1,366 @@
+/*
+  T-scan
+
+  Copyright (c) 1998 - 2018
+
+  This file is part of tscan
+
+  tscan is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  tscan is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affere General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// tscan-treecheck: compares the one-walk analysis of Alpino trees with the
+// XPath definitions of the same counts. Used by tests/testtrees.
+// With --frog the files are FoLiA documents with Frog's dependency layer,
+// and the counts of the trees that frogDependencyTree builds from them are
+// printed per sentence, to be compared with the expected output.
+// With --random <count> [<seed>] the comparison is done on that many
+// randomly generated trees. They don't need to make sense as Dutch: they
+// mix the categories, relations and words the counts look at, and have
+// co-indexed nodes, to exercise the corners of both implementations.
+// With --split a file holds the maximal piece length on its first line,
+// and then a token and its Frog tag per line. The pieces of splitForAlpino
+// are printed, and the parses of the pieces, in <file>.1.xml, <file>.2.xml
+// and so on (without the .txt extension), are joined with
+// joinAlpinoParses. The joined tree and its counts are printed too.
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include "ticcutils/StringOps.h"
+#include "libxml/parser.h"
+#include "libfolia/folia.h"
+#include "tscan/Alpino.h"
+#include "tscan/AlpinoTree.h"
+#include "tscan/FrogTree.h"
+
+using namespace std;
+
+const string frog_pos_set = "http://ilk.uvt.nl/folia/sets/frog-mbpos-cgn";
+const string frog_lemma_set = "http://ilk.uvt.nl/folia/sets/frog-mblem-nl";
+
+static bool check_tree( xmlDoc *doc, const string& name ){
+  AlpinoTreeStats walk = analyseAlpinoTree( doc );
+  AlpinoTreeStats xpath = xpathAlpinoTree( doc );
+  if ( walk == xpath ){
+    cout << name << ": " << walk << endl;
+    return true;
+  }
+  cerr << name << " differs:" << endl
+       << "walk:  " << walk << endl
+       << "xpath: " << xpath << endl;
+  return false;
+}
+
+static int check_alpino( const string& file ){
+  xmlDoc *doc = xmlReadFile( file.c_str(), 0, XML_PARSE_NOBLANKS );
+  if ( !doc ){
+    cerr << "unable to read " << file << endl;
+    return 1;
+  }
+  int failures = check_tree( doc, file ) ? 0 : 1;
+  xmlFreeDoc( doc );
+  return failures;
+}
+
+static int check_frog( const string& file ){
+  folia::Document doc;
+  try {
+    doc.readFromFile( file );
+  }
+  catch ( exception& e ){
+    cerr << "unable to read " << file << ": " << e.what() << endl;
+    return 1;
+  }
+  int failures = 0;
+  for ( const auto& s : doc.sentences() ){
+    string name = file + " " + s->id();
+    xmlDoc *tree = frogDependencyTree( s, frog_pos_set, frog_lemma_set );
+    if ( !tree ){
+      cerr << name << ": no dependencies" << endl;
+      ++failures;
+      continue;
+    }
+    if ( !check_tree( tree, name ) ){
+      ++failures;
+    }
+    xmlFreeDoc( tree );
+  }
+  return failures;
+}
+
+static string sentence_text( xmlDoc *doc ){
+  xmlNode *root = xmlDocGetRootElement( doc );
+  for ( xmlNode *pnt = root ? root->children : 0; pnt; pnt = pnt->next ){
+    if ( pnt->type == XML_ELEMENT_NODE
+	 && xmlStrEqual( pnt->name, (const xmlChar*)"sentence" ) ){
+      xmlChar *content = xmlNodeGetContent( pnt );
+      string result = (const char*)content;
+      xmlFree( content );
+      return result;
+    }
+  }
+  return "";
+}
+
+static int check_split( const string& file ){
+  ifstream is( file );
+  size_t max = 0;
+  if ( !( is >> max ) ){
+    cerr << "unable to read " << file << endl;
+    return 1;
+  }
+  string sentence;
+  vector<string> tags;
+  string word;
+  string tag;
+  while ( is >> word >> tag ){
+    if ( !sentence.empty() ){
+      sentence += " ";
+    }
+    sentence += word;
+    tags.push_back( tag );
+  }
+  vector<string> pieces = splitForAlpino( sentence, tags, max );
+  string base = file.substr( 0, file.rfind( ".txt" ) );
+  vector<xmlDoc*> parses;
+  int failures = 0;
+  for ( size_t i=0; i < pieces.size(); ++i ){
+    cout << file << " piece " << i+1 << ": " << pieces[i] << endl;
+    string name = base + "." + TiCC::toString( i+1 ) + ".xml";
+    xmlDoc *doc = xmlReadFile( name.c_str(), 0, XML_PARSE_NOBLANKS );
+    if ( !doc ){
+      cerr << "unable to read " << name << endl;
+      ++failures;
+    }
+    else if ( sentence_text( doc ) != pieces[i] ){
+      cerr << name << " is the parse of another piece: "
+	   << sentence_text( doc ) << endl;
+      ++failures;
+    }
+    parses.push_back( doc );
+  }
+  if ( failures > 0 ){
+    for ( const auto& doc : parses ){
+      xmlFreeDoc( doc );
+    }
+    return failures;
+  }
+  xmlDoc *joined = joinAlpinoParses( parses, pieces );
+  if ( !joined ){
+    cerr << file << ": the parses are not joined" << endl;
+    return 1;
+  }
+  xmlDocFormatDump( stdout, joined, 1 );
+  fflush( stdout );
+  if ( !check_tree( joined, file ) ){
+    ++failures;
+  }
+  xmlFreeDoc( joined );
+  return failures;
+}
+
+// the material of the random trees
+static const char *cats[] = { "smain", "ssub", "sv1", "rel", "whrel", "cp",
+			      "oti", "ti", "whsub", "whq", "conj", "np", "pp",
+			      "ap", "advp", "inf", "ppart", "ppres", "du",
+			      "mwu", "detp" };
+static const char *rels[] = { "su", "hd", "hd", "obj1", "obj2", "mod", "mod",
+			      "cnj", "cnj", "crd", "body", "cmp", "rhd", "whd",
+			      "vc", "predc", "sat", "nucl", "dp", "det", "app",
+			      "ld", "svp", "pc", "me", "obcomp", "hdf", "se",
+			      "sup", "pobj1", "dlink", "tag", "predm", "--" };
+// pos, pt, word, lemma
+static const char *leaves[][4] = {
+  { "verb", "ww", "leest", "lezen" },
+  { "verb", "ww", "gaan", "gaan" },
+  { "verb", "ww", "gelezen", "lezen" },
+  { "noun", "n", "boek", "boek" },
+  { "name", "n", "Pietje", "Pietje" },
+  { "adj", "adj", "snel", "snel" },
+  { "adj", "adj", "erg", "erg" },
+  { "adv", "bw", "niet", "niet" },
+  { "adv", "bw", "zeer", "zeer" },
+  { "prep", "vz", "naar", "naar" },
+  { "comp", "vg", "dat", "dat" },
+  { "comp", "vg", "omdat", "omdat" },
+  { "comp", "vg", "te", "te" },
+  { "comp", "vg", "om", "om" },
+  { "vg", "vg", "en", "en" },
+  { "vg", "vg", "maar", "maar" },
+  { "pron", "vnw", "die", "die" },
+  { "pron", "vnw", "wat", "wat" },
+  { "pron", "vnw", "hij", "hij" },
+  { "det", "lid", "de", "de" },
+  { "num", "tw", "twee", "twee" },
+  { "punct", "let", ",", "," },
+  { "fixed", "spec", "zo", "zo" },
+  { "tag", "tsw", "ja", "ja" } };
+
+class RandomTree {
+public:
+  explicit RandomTree( unsigned int seed ): gen( seed ) {};
+  xmlDoc *next();
+private:
+  size_t pick( size_t n ) { return gen() % n; };
+  void set( xmlNode *, const string&, const string& );
+  void set( xmlNode *, const string&, int );
+  xmlNode *node( xmlNode *, const string&, int );
+  mt19937 gen; // not a distribution, so the trees are the same everywhere
+  int id;
+  int pos;
+  vector<xmlNode*> indexed;
+};
+
+void RandomTree::set( xmlNode *node, const string& att, const string& val ){
+  xmlSetProp( node, (const xmlChar*)att.c_str(), (const xmlChar*)val.c_str() );
+}
+
+void RandomTree::set( xmlNode *node, const string& att, int val ){
+  set( node, att, TiCC::toString( val ) );
+}
+
+xmlNode *RandomTree::node( xmlNode *parent, const string& rel, int depth ){
+  xmlNode *result = xmlNewChild( parent, 0, (const xmlChar*)"node", 0 );
+  set( result, "id", id++ );
+  set( result, "rel", rel );
+  if ( !indexed.empty() && pick( 8 ) == 0 ){
+    // a trace of an earlier node
+    xmlNode *antecedent = indexed[pick( indexed.size() )];
+    set( result, "index", TiCC::getAttribute( antecedent, "index" ) );
+    set( result, "begin", TiCC::getAttribute( antecedent, "begin" ) );
+    set( result, "end", TiCC::getAttribute( antecedent, "end" ) );
+    return result;
+  }
+  if ( depth >= 5 || pick( 3 ) == 0 ){
+    const char **leaf = leaves[pick( sizeof(leaves)/sizeof(leaves[0]) )];
+    set( result, "pos", leaf[0] );
+    set( result, "pt", leaf[1] );
+    set( result, "word", leaf[2] );
+    set( result, "lemma", leaf[3] );
+    set( result, "root", leaf[3] );
+    if ( pick( 6 ) == 0 ){
+      set( result, "lcat", cats[pick( sizeof(cats)/sizeof(cats[0]) )] );
+    }
+    if ( string( leaf[0] ) == "verb" && pick( 4 ) == 0 ){
+      set( result, "sc", "passive" );
+    }
+    set( result, "begin", pos );
+    set( result, "end", pos + 1 );
+    ++pos;
+  }
+  else {
+    set( result, "cat", cats[pick( sizeof(cats)/sizeof(cats[0]) )] );
+    int begin = pos;
+    size_t children = 1 + pick( 4 );
+    for ( size_t i=0; i < children; ++i ){
+      node( result, rels[pick( sizeof(rels)/sizeof(rels[0]) )], depth + 1 );
+    }
+    if ( pos == begin ){
+      // only traces below
+      node( result, "hd", 5 );
+    }
+    set( result, "begin", begin );
+    set( result, "end", pos );
+  }
+  if ( pick( 6 ) == 0 ){
+    set( result, "index", (int)indexed.size() + 1 );
+    indexed.push_back( result );
+  }
+  return result;
+}
+
+xmlDoc *RandomTree::next(){
+  id = 0;
+  pos = 0;
+  indexed.clear();
+  xmlDoc *doc = xmlNewDoc( (const xmlChar*)"1.0" );
+  xmlNode *root = xmlNewDocNode( doc, 0, (const xmlChar*)"alpino_ds", 0 );
+  xmlDocSetRootElement( doc, root );
+  set( root, "version", "1.3" );
+  xmlNode *top = xmlNewChild( root, 0, (const xmlChar*)"node", 0 );
+  set( top, "cat", "top" );
+  set( top, "id", id++ );
+  set( top, "rel", "top" );
+  size_t children = 1 + pick( 3 );
+  for ( size_t i=0; i < children; ++i ){
+    node( top, "--", 1 );
+  }
+  set( top, "begin", 0 );
+  set( top, "end", pos );
+  return doc;
+}
+
+static int check_random( size_t count, unsigned int seed ){
+  RandomTree trees( seed );
+  int failures = 0;
+  for ( size_t i=0; i < count; ++i ){
+    xmlDoc *doc = trees.next();
+    AlpinoTreeStats walk = analyseAlpinoTree( doc );
+    AlpinoTreeStats xpath = xpathAlpinoTree( doc );
+    if ( !( walk == xpath ) ){
+      cerr << "random tree " << i << " (seed " << seed << ") differs:"
+	   << endl << "walk:  " << walk << endl
+	   << "xpath: " << xpath << endl;
+      xmlDocFormatDump( stderr, doc, 1 );
+      ++failures;
+    }
+    xmlFreeDoc( doc );
+  }
+  cout << count << " random trees (seed " << seed << "), "
+       << failures << " differ" << endl;
+  return failures;
+}
+
+int main( int argc, char *argv[] ){
+  if ( argc > 2 && string( argv[1] ) == "--random" ){
+    size_t count;
+    unsigned int seed = 1;
+    if ( !TiCC::stringTo( argv[2], count )
+	 || ( argc > 3 && !TiCC::stringTo( argv[3], seed ) ) ){
+      cerr << "usage:  tscan-treecheck --random <count> [<seed>]" << endl;
+      exit( EXIT_FAILURE );
+    }
+    exit( check_random( count, seed ) == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+  }
+  int first = 1;
+  string mode;
+  if ( argc > 1
+       && ( string( argv[1] ) == "--frog" || string( argv[1] ) == "--split" ) ){
+    mode = argv[1];
+    ++first;
+  }
+  if ( argc <= first ){
+    cerr << "usage:  tscan-treecheck <alpino xml file> ..." << endl;
+    cerr << "        tscan-treecheck --frog <folia xml file> ..." << endl;
+    cerr << "        tscan-treecheck --split <tagged sentence file> ..." << endl;
+    cerr << "        tscan-treecheck --random <count> [<seed>]" << endl;
+    exit( EXIT_FAILURE );
+  }
+  int failures = 0;
+  for ( int i=first; i < argc; ++i ){
+    if ( mode == "--frog" ){
+      failures += check_frog( argv[i] );
+    }
+    else if ( mode == "--split" ){
+      failures += check_split( argv[i] );
+    }
+    else {
+      failures += check_alpino( argv[i] );
+    }
+  }
+  exit( failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
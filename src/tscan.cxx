@@ -24,6 +24,14 @@
 #include <fstream>
 #include <cmath>
 #include <algorithm>
+#include <sstream>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <csignal>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include "config.h"
@@ -42,6 +50,13 @@
 #include "libfolia/folia.h"
 #include "frog/FrogAPI.h"
 #include "tscan/Alpino.h"
+#include "tscan/AlpinoTree.h"
+#include "tscan/AlpinoClient.h"
+#include "tscan/AlpinoPool.h"
+#include "tscan/FrogTree.h"
+#include "tscan/WoprClient.h"
+#include "tscan/Endpoints.h"
+#include "tscan/ParseCache.h"
 #include "tscan/cgn.h"
 #include "tscan/sem.h"
 #include "tscan/intensify.h"
@@ -53,6 +68,7 @@
 #include "tscan/ner.h"
 #include "tscan/utils.h"
 #include "tscan/stats.h"
+#include "tscan/settings.h"
 
 using namespace std;
 
@@ -63,919 +79,18 @@ const string frog_morph_set = "http://ilk.uvt.nl/folia/sets/frog-mbma-nl";
 string configFile = "tscan.cfg";
 string probFilename = "problems.log";
 ofstream problemFile;
+mutex problemMutex;
 TiCC::Configuration config;
 string workdir_name;
-
-struct cf_data {
-  long int count;
-  double freq;
-};
-
-struct noun {
-  noun(): type(SEM::NO_SEMTYPE),is_compound(false), compound_parts(0){};
-  SEM::Type type;
-  bool is_compound;
-  string head;
-  string satellite_clean;
-  int compound_parts;
-};
-
-struct prevalence {
-  double percentage;
-  double zscore;
-};
-
-struct tagged_classification {
-  CGN::Type tag;
-  string classification;
-};
-
-struct settingData {
-  void init( const TiCC::Configuration& );
-  bool doAlpino;
-  bool doAlpinoServer;
-  bool doWopr;
-  bool doXfiles;
-  bool showProblems;
-  bool sentencePerLine;
-  string style;
-  int rarityLevel;
-  unsigned int overlapSize;
-  double freq_clip;
-  double mtld_threshold;
-  map<string, SEM::Type> adj_sem;
-  map<string, noun> noun_sem;
-  map<string, SEM::Type> verb_sem;
-  map<string, Intensify::Type> intensify;
-  map<string, General::Type> general_nouns;
-  map<string, General::Type> general_verbs;
-  map<string, Adverb::adverb> adverbs;
-  map<string, double> pol_lex;
-  map<string, cf_data> staph_word_freq_lex;
-  long int staph_total;
-  map<string, cf_data> word_freq_lex;
-  long int word_total;
-  map<string, cf_data> lemma_freq_lex;
-  long int lemma_total;
-  map<string, top_val> top_freq_lex;
-  map<CGN::Type, set<string> > temporals1;
-  set<string> multi_temporals;
-  map<CGN::Type, set<string> > causals1;
-  set<string> multi_causals;
-  map<CGN::Type, set<string> > opsommers_wg;
-  set<string> multi_opsommers_wg;
-  map<CGN::Type, set<string> > opsommers_zin;
-  set<string> multi_opsommers_zin;
-  map<CGN::Type, set<string> > contrast1;
-  set<string> multi_contrast;
-  map<CGN::Type, set<string> > compars1;
-  set<string> multi_compars;
-  map<CGN::Type, set<string> > causal_sits;
-  set<string> multi_causal_sits;
-  map<CGN::Type, set<string> > space_sits;
-  set<string> multi_space_sits;
-  map<CGN::Type, set<string> > time_sits;
-  set<string> multi_time_sits;
-  map<CGN::Type, set<string> > emotion_sits;
-  set<string> multi_emotion_sits;
-  set<string> vzexpr2;
-  set<string> vzexpr3;
-  set<string> vzexpr4;
-  map<string, Afk::Type> afkos;
-  map<string, prevalence> prevalences;
-  map<CGN::Type, set<string> > stop_lemmata;
-  map<string, tagged_classification> my_classification;
-};
-
-settingData settings;
-
-bool fillN( map<string,noun>& m, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    // Trim the lines
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-
-    // Split at a tab; the line should contain either 3 (non-compounds) or 6 (compounds) values
-    vector<string> parts;
-    int i = TiCC::split_at( line, parts, "\t" );
-    if (i != 3 && i != 6) {
-      cerr << "skip line: " << line << " (expected 3 or 6 values, got " << i << ")" << endl;
-      continue;
-    }
-
-    // Classify the noun, set the compound values and add the noun to the map
-    noun n;
-    n.type = SEM::classifyNoun(parts[1]);
-    n.is_compound = parts[2] == "1";
-    if (n.is_compound) {
-      n.head = parts[3];
-      n.satellite_clean = parts[4];
-      n.compound_parts = atoi(parts[5].c_str());
-    }
-    m[parts[0]] = n;
-  }
-  return true;
-}
-
-bool fillN( map<string,noun>& m, const string& filename ) {
-  ifstream is( filename.c_str() );
-  if (is) {
-    return fillN(m, is);
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fillWW( map<string,SEM::Type>& m, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    vector<string> parts;
-    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
-    if ( n != 3 ){
-      cerr << "skip line: " << line << " (expected 3 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    SEM::Type res = SEM::classifyWW( parts[1], parts[2] );
-    if ( res != SEM::UNFOUND_VERB ){
-      // no use to store undefined values
-      m[parts[0]] = res;
-    }
-  }
-  return true;
-}
-
-bool fillADJ( map<string,SEM::Type>& m, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    vector<string> parts;
-    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
-    if ( n <2 || n > 3 ){
-      cerr << "skip line: " << line << " (expected 2 or 3 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    SEM::Type res = SEM::UNFOUND_ADJ;
-    if ( n == 2 ){
-      res = SEM::classifyADJ( parts[1] );
-    }
-    else {
-      res = SEM::classifyADJ( parts[1], parts[2] );
-    }
-    string low = TiCC::lowercase( parts[0] );
-    if ( m.find(low) != m.end() ){
-      cerr << "Information: multiple entry '" << low << "' in ADJ lex" << endl;
-    }
-    if ( res != SEM::UNFOUND_ADJ ){
-      // no use to store undefined values
-      m[low] = res;
-    }
-  }
-  return true;
-}
-
-bool fill( CGN::Type tag, map<string,SEM::Type>& m, const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    if ( tag == CGN::WW )
-      return fillWW( m, is );
-    else if ( tag == CGN::ADJ )
-      return fillADJ( m, is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_intensify(map<string,Intensify::Type>& m, istream& is){
-  string line;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    vector<string> parts;
-    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
-    if ( n < 2 || n > 2 ){
-      cerr << "skip line: " << line << " (expected 2 values, got "
-       << n << ")" << endl;
-      continue;
-    }
-    string low = TiCC::trim(TiCC::lowercase( parts[0] ));
-    Intensify::Type res = Intensify::classify(TiCC::lowercase(parts[1]));
-    if ( m.find(low) != m.end() ){
-      cerr << "Information: multiple entry '" << low << "' in Intensify lex" << endl;
-    }
-    if ( res != Intensify::NO_INTENSIFY ){
-      // no use to store undefined values
-      m[low] = res;
-    }
-  }
-  return true;
-}
-
-bool fill_intensify(map<string,Intensify::Type>& m, const string& filename) {
-  ifstream is( filename.c_str() );
-  if (is) {
-    return fill_intensify(m, is);
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_general(map<string,General::Type>& m, istream& is){
-  string line;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    vector<string> parts;
-    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
-    if ( n < 2 || n > 2 ){
-      cerr << "skip line: " << line << " (expected 2 values, got "
-       << n << ")" << endl;
-      continue;
-    }
-    string low = TiCC::trim(TiCC::lowercase( parts[0] ));
-    General::Type res = General::classify(TiCC::lowercase(parts[1]));
-    if ( m.find(low) != m.end() ){
-      cerr << "Information: multiple entry '" << low << "' in general lex" << endl;
-    }
-    if ( res != General::NO_GENERAL ){
-      // no use to store undefined values
-      m[low] = res;
-    }
-  }
-  return true;
-}
-
-bool fill_general(map<string,General::Type>& m, const string& filename) {
-  ifstream is( filename.c_str() );
-  if (is) {
-    return fill_general(m, is);
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_adverbs(map<string,Adverb::adverb>& m, istream& is){
-  string line;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    vector<string> parts;
-    int n = TiCC::split_at( line, parts, "\t" ); // split at tab
-    if ( n != 3 ){
-      cerr << "skip line: " << line << " (expected 3 values, got "
-       << n << ")" << endl;
-      continue;
-    }
-    string low = TiCC::trim(TiCC::lowercase(parts[0]));
-    Adverb::adverb a;
-    a.type = Adverb::classifyType(TiCC::lowercase(parts[1]));
-    a.subtype = Adverb::classifySubType(TiCC::lowercase(parts[2]));
-    if ( m.find(low) != m.end() ){
-      cerr << "Information: multiple entry '" << low << "' in adverbs lex" << endl;
-    }
-    if ( a.type != Adverb::NO_ADVERB ){
-      // no use to store undefined values
-      m[low] = a;
-    }
-  }
-  return true;
-}
-
-bool fill_adverbs(map<string,Adverb::adverb>& m, const string& filename) {
-  ifstream is( filename.c_str() );
-  if (is) {
-    return fill_adverbs(m, is);
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_freqlex( map<string,cf_data>& m, long int& total, istream& is ){
-  total = 0;
-  string line;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    vector<string> parts;
-    size_t n = TiCC::split_at( line, parts, "\t" ); // split at tabs
-    if ( n != 4 ){
-      cerr << "skip line: " << line << " (expected 4 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    cf_data data;
-    data.count = TiCC::stringTo<long int>( parts[1] );
-    data.freq = TiCC::stringTo<double>( parts[3] );
-    if ( data.count == 1 ){
-      // we are done. Skip all singleton stuff
-      return true;
-    }
-    if ( settings.freq_clip > 0 ){
-      // skip low frequent word, when desired
-      if ( data.freq > settings.freq_clip ){
-	return true;
-      }
-    }
-    total += data.count;
-    m[parts[0]] = data;
-  }
-  return true;
-}
-
-bool fill_freqlex( map<string,cf_data>& m, long int& total,
-		   const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    fill_freqlex( m, total, is );
-    cout << "read " << filename << " (" << total << " entries)" << endl;
-    return true;
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_topvals( map<string,top_val>& m, istream& is ){
-  string line;
-  int line_count = 0;
-  top_val val = top2000;
-  while( safe_getline( is, line ) ){
-    line = TiCC::trim( line );
-    if ( line.empty() )
-      continue;
-    ++line_count;
-    if ( line_count > 10000 )
-      val = top20000;
-    else if ( line_count > 5000 )
-      val = top10000;
-    else if ( line_count > 3000 )
-      val = top5000;
-    else if ( line_count > 2000 )
-      val = top3000;
-    else if ( line_count > 1000 )
-      val = top2000;
-    else
-      val = top1000;
-    vector<string> parts;
-    size_t n = TiCC::split_at( line, parts, "\t" ); // split at tabs
-    if ( n != 4 ){
-      cerr << "skip line: " << line << " (expected 2 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    m[parts[0]] = val;
-  }
-  return true;
-}
-
-bool fill_topvals( map<string,top_val>& m, const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill_topvals( m, is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_connectors( map<CGN::Type,set<string> >& c1,
-		      set<string>& cM,
-		      istream& is ){
-  cM.clear();
-  string line;
-  while( safe_getline( is, line ) ){
-    // a line is supposed to be :
-    // a comment, starting with '#'
-    // like: '# comment'
-    // OR an entry of 1 to 4 words seperated by a single space
-    // like: 'dus' OR 'de facto'
-    // OR the 1 word followed by a TAB ('\t') and a CGN tag
-    // like: 'maar   VG'
-    line = TiCC::trim( line );
-    if ( line.empty() || line[0] == '#' )
-      continue;
-    vector<string> vec;
-    int n = TiCC::split_at( line, vec, "\t" );
-    if ( n == 0 || n > 2 ){
-      cerr << "skip line: " << line << " (expected 1 or 2 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    CGN::Type tag = CGN::UNASS;
-    if ( n == 2 ){
-      tag = CGN::toCGN( vec[1] );
-    }
-    vector<string> dum;
-    n = TiCC::split_at( vec[0], dum, " " );
-    if ( n < 1 || n > 4 ){
-      cerr << "skip line: " << line
-	   << " (expected 1, to 4 values in the first part: " << vec[0]
-	   << ", got " << n << ")" << endl;
-      continue;
-    }
-    if ( n == 1 ){
-      c1[tag].insert( vec[0] );
-    }
-    else if ( n > 1 && tag != CGN::UNASS ){
-      cerr << "skip line: " << line
-	   << " (no GCN tag info allowed for multiword entries) " << endl;
-      continue;
-    }
-    else {
-      cM.insert( vec[0] );
-    }
-  }
-  return true;
-}
-
-bool fill_connectors( map<CGN::Type, set<string> >& c1,
-		      set<string>& cM,
-		      const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill_connectors( c1, cM, is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_vzexpr( set<string>& vz2, set<string>& vz3, set<string>& vz4,
-		  istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    // a line is supposed to be :
-    // a comment, starting with '#'
-    // like: '# comment'
-    // OR an entry of 2, 3 or 4 words seperated by whitespace
-    line = TiCC::trim( line );
-    if ( line.empty() || line[0] == '#' )
-      continue;
-    vector<string> vec;
-    int n = TiCC::split_at_first_of( line, vec, " \t" );
-    if ( n == 0 || n > 4 ){
-      cerr << "skip line: " << line << " (expected 2, 3 or 4 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    switch ( n ){
-    case 2: {
-      string line = vec[0] + " " + vec[1];
-      vz2.insert( line );
-    }
-      break;
-    case 3: {
-      string line = vec[0] + " " + vec[1] + " " + vec[2];
-      vz3.insert( line );
-    }
-      break;
-    case 4: {
-      string line = vec[0] + " " + vec[1] + " " + vec[2] + " " + vec[3];
-      vz4.insert( line );
-    }
-      break;
-    default:
-      throw logic_error( "switch out of range" );
-    }
-  }
-  return true;
-}
-
-bool fill_vzexpr( set<string>& vz2, set<string>& vz3, set<string>& vz4,
-		  const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill_vzexpr( vz2, vz3, vz4 , is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill( map<string,Afk::Type>& afkos, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    // a line is supposed to be :
-    // a comment, starting with '#'
-    // like: '# comment'
-    // OR an entry of 2 words seperated by whitespace
-    line = TiCC::trim( line );
-    if ( line.empty() || line[0] == '#' )
-      continue;
-    vector<string> vec;
-    int n = TiCC::split_at_first_of( line, vec, " \t" );
-    if ( n < 2 ){
-      cerr << "skip line: " << line << " (expected at least 2 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-    if ( n == 2 ){
-      Afk::Type at = Afk::classify( vec[1] );
-      if ( at != Afk::NO_A )
-	afkos[vec[0]] = at;
-    }
-    else if ( n == 3 ){
-      Afk::Type at = Afk::classify( vec[2] );
-      if ( at != Afk::NO_A ){
-	string s = vec[0] + " " + vec[1];
-	afkos[s] = at;
-      }
-    }
-    else if ( n == 4 ){
-      Afk::Type at = Afk::classify( vec[3] );
-      if ( at != Afk::NO_A ){
-	string s = vec[0] + " " + vec[1] + " " + vec[2];
-	afkos[s] = at;
-      }
-    }
-    else {
-      cerr << "skip line: " << line << " (expected at most 4 values, got "
-	   << n << ")" << endl;
-      continue;
-    }
-  }
-  return true;
-}
-
-bool fill( map<string,Afk::Type>& afks, const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill( afks , is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_prevalences( map<string, prevalence>& prevalences, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    // a line is supposed to be :
-    // a comment, starting with '#'
-    // like: '# comment'
-    // OR: a lemma with prevalence values in columns 2 and 3
-    line = TiCC::trim( line );
-    if ( line.empty() || line[0] == '#' )
-      continue;
-    vector<string> vec;
-    int n = TiCC::split_at_first_of( line, vec, " \t" );
-    if ( n != 6 ) {
-      cerr << "skip line: " << line << " (expected 6 values, got " << n << ")" << endl;
-      continue;
-    }
-    else {
-      prevalence p;
-      p.percentage = TiCC::stringTo<double>(vec[2]);
-      p.zscore = TiCC::stringTo<double>(vec[3]);
-      prevalences[vec[0]] = p;
-    }
-  }
-  return true;
-}
-
-bool fill_prevalences( map<string, prevalence>& prevalences, const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill_prevalences( prevalences, is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill_stop_lemmata( map<CGN::Type, set<string> >& stop_lemmata, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    // a line is supposed to be :
-    // a comment, starting with '#'
-    // like: '# comment'
-    // OR: a lemma followed by an optional CGN tag
-    line = TiCC::trim( line );
-    if ( line.empty() || line[0] == '#' )
-      continue;
-    vector<string> vec;
-    int n = TiCC::split_at_first_of( line, vec, " \t" );
-    if ( n == 0 || n > 2 ) {
-      cerr << "skip line: " << line << " (expected 1 or 2 values, got "
-     << n << ")" << endl;
-      continue;
-    }
-    CGN::Type tag = CGN::UNASS;
-    if ( n == 2 ){
-      tag = CGN::toCGN(vec[1]);
-    }
-    stop_lemmata[tag].insert(vec[0]);
-  }
-  return true;
-}
-
-bool fill_stop_lemmata( map<CGN::Type, set<string> >& stop_lemmata, const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill_stop_lemmata( stop_lemmata, is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-bool fill( map<string,tagged_classification>& my_classification, istream& is ){
-  string line;
-  while( safe_getline( is, line ) ){
-    // a line is supposed to be :
-    // a comment, starting with '#'
-    // like: '# comment'
-    // OR: a lemma with an optional pos-tag, followed by a categorization
-    line = TiCC::trim( line );
-    if ( line.empty() || line[0] == '#' )
-      continue;
-    vector<string> vec;
-    int n = TiCC::split_at_first_of( line, vec, " \t" );
-    if ( n < 2 ) {
-      cerr << "skip line: " << line << " (expected at least 2 values, got " << n << ")" << endl;
-      continue;
-    }
-    if ( n == 2 ) {
-      tagged_classification tc;
-      tc.tag = CGN::UNASS;
-      tc.classification = vec[1];
-      my_classification[vec[0]] = tc;
-    }
-    else if ( n == 3 ) {
-      tagged_classification tc;
-      tc.tag = CGN::toCGN( vec[1] );
-      tc.classification = vec[2];
-      my_classification[vec[0]] = tc;
-    }
-    else {
-      cerr << "skip line: " << line << " (expected at most 3 values, got " << n << ")" << endl;
-      continue;
-    }
-  }
-  return true;
-}
-
-bool fill( map<string,tagged_classification>& my_classification, const string& filename ){
-  ifstream is( filename.c_str() );
-  if ( is ){
-    return fill( my_classification , is );
-  }
-  else {
-    cerr << "couldn't open file: " << filename << endl;
-  }
-  return false;
-}
-
-void settingData::init( const TiCC::Configuration& cf ){
-  doXfiles = true;
-  doAlpino = false;
-  doAlpinoServer = false;
-  string val = cf.lookUp( "useAlpinoServer" );
-  if ( !val.empty() ){
-    if ( !TiCC::stringTo( val, doAlpinoServer ) ){
-      cerr << "invalid value for 'useAlpinoServer' in config file" << endl;
-      exit( EXIT_FAILURE );
-    }
-  }
-  if ( !doAlpinoServer ){
-    val = cf.lookUp( "useAlpino" );
-    if( !TiCC::stringTo( val, doAlpino ) ){
-      cerr << "invalid value for 'useAlpino' in config file" << endl;
-      exit( EXIT_FAILURE );
-    }
-  }
-  doWopr = false;
-  val = cf.lookUp( "useWopr" );
-  if ( !val.empty() ){
-    if ( !TiCC::stringTo( val, doWopr ) ){
-      cerr << "invalid value for 'useWopr' in config file" << endl;
-      exit( EXIT_FAILURE );
-    }
-  }
-  showProblems = true;
-  val = cf.lookUp( "logProblems" );
-  if ( !val.empty() ){
-    if ( !TiCC::stringTo( val, showProblems ) ){
-      cerr << "invalid value for 'showProblems' in config file" << endl;
-      exit( EXIT_FAILURE );
-    }
-  }
-  sentencePerLine = false;
-  val = cf.lookUp( "sentencePerLine" );
-  if ( !val.empty() ){
-    if ( !TiCC::stringTo( val, sentencePerLine ) ){
-      cerr << "invalid value for 'sentencePerLine' in config file" << endl;
-      exit( EXIT_FAILURE );
-    }
-  }
-  val = cf.lookUp( "styleSheet" );
-  if( !val.empty() ){
-    style = val;
-  }
-  val = cf.lookUp( "rarityLevel" );
-  if ( val.empty() ){
-    rarityLevel = 10;
-  }
-  else if ( !TiCC::stringTo( val, rarityLevel ) ){
-    cerr << "invalid value for 'rarityLevel' in config file" << endl;
-  }
-  val = cf.lookUp( "overlapSize" );
-  if ( val.empty() ){
-    overlapSize = 50;
-  }
-  else if ( !TiCC::stringTo( val, overlapSize ) ){
-    cerr << "invalid value for 'overlapSize' in config file" << endl;
-    exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "frequencyClip" );
-  if ( val.empty() ){
-    freq_clip = 90;
-  }
-  else if ( !TiCC::stringTo( val, freq_clip )
-	    || (freq_clip < 0) || (freq_clip > 100) ){
-    cerr << "invalid value for 'frequencyClip' in config file" << endl;
-    exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "mtldThreshold" );
-  if ( val.empty() ){
-    mtld_threshold = 0.720;
-  }
-  else if ( !TiCC::stringTo( val, mtld_threshold )
-	    || (mtld_threshold < 0) || (mtld_threshold > 1.0) ){
-    cerr << "invalid value for 'frequencyClip' in config file" << endl;
-    exit( EXIT_FAILURE );
-  }
-
-  val = cf.lookUp( "adj_semtypes" );
-  if ( !val.empty() ){
-    if ( !fill( CGN::ADJ, adj_sem, val ) ) // 20150316: Full path necessary to allow custom input
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "noun_semtypes" );
-  if ( !val.empty() ){
-    if ( !fillN( noun_sem, val ) ) // 20141121: Full path necessary to allow custom input
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "verb_semtypes" );
-  if ( !val.empty() ){
-    if ( !fill( CGN::WW, verb_sem, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "intensify" );
-  if ( !val.empty() ){
-    if ( !fill_intensify( intensify, val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "general_nouns" );
-  if ( !val.empty() ){
-    if ( !fill_general( general_nouns, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "general_verbs" );
-  if ( !val.empty() ){
-    if ( !fill_general( general_verbs, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "adverbs" );
-  if ( !val.empty() ){
-    if ( !fill_adverbs( adverbs, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  staph_total = 0;
-  val = cf.lookUp( "staph_word_freq_lex" );
-  if ( !val.empty() ){
-    if ( !fill_freqlex( staph_word_freq_lex, staph_total,
-			cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  word_total = 0;
-  val = cf.lookUp( "word_freq_lex" );
-  if ( !val.empty() ){
-    if ( !fill_freqlex( word_freq_lex, word_total,
-			cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  lemma_total = 0;
-  val = cf.lookUp( "lemma_freq_lex" );
-  if ( !val.empty() ){
-    if ( !fill_freqlex( lemma_freq_lex, lemma_total,
-			cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "top_freq_lex" );
-  if ( !val.empty() ){
-    if ( !fill_topvals( top_freq_lex, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "temporals" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( temporals1, multi_temporals, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "opsom_connectors_wg" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( opsommers_wg, multi_opsommers_wg, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "opsom_connectors_zin" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( opsommers_zin, multi_opsommers_zin, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "contrast" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( contrast1, multi_contrast, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "compars" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( compars1, multi_compars, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "causals" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( causals1, multi_causals, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "causal_situation" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( causal_sits, multi_causal_sits, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "space_situation" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( space_sits, multi_space_sits, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "time_situation" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( time_sits, multi_time_sits, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-
-  val = cf.lookUp( "emotion_situation" );
-  if ( !val.empty() ){
-    if ( !fill_connectors( emotion_sits, multi_emotion_sits, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-
-  val = cf.lookUp( "voorzetselexpr" );
-  if ( !val.empty() ){
-    if ( !fill_vzexpr( vzexpr2, vzexpr3, vzexpr4, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "afkortingen" );
-  if ( !val.empty() ){
-    if ( !fill( afkos, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-  val = cf.lookUp( "prevalence" );
-  if ( !val.empty() ){
-    if ( !fill_prevalences( prevalences, cf.configDir() + "/" + val ) )
-      exit( EXIT_FAILURE );
-  }
-
-  val = cf.lookUp( "stop_lemmata" );
-  if ( !val.empty() ){
-    if ( !fill_stop_lemmata( stop_lemmata, val ) )
-      exit( EXIT_FAILURE );
-  }
-
-  val = cf.lookUp( "my_classification" );
-  if ( !val.empty() ){
-    if ( !fill( my_classification, val ) ) // full path necessary to allow custom input
-      exit( EXIT_FAILURE );
-  }
-}
+AlpinoClient *alpino_client = 0;
+AlpinoPool *alpino_pool = 0;
+Endpoints *frog_servers = 0;
+Endpoints *wopr_fwd_servers = 0;
+Endpoints *wopr_bwd_servers = 0;
+ParseCache *parse_cache = 0;
+// the lexicons new jobs start with: the current lexicon snapshot, with the
+// [[overlay]] lists of the config file. Replaced by reload_lexicons()
+shared_ptr<const LexiconOverlay> job_lexicons;
 
 inline void usage(){
   cerr << "usage:  tscan [options] <inputfiles> " << endl;
@@ -985,143 +100,120 @@ inline void usage(){
   cerr << "\t-V or --version show version " << endl;
   cerr << "\t-n assume input file to hold one sentence per line" << endl;
   cerr << "\t--skip=[aclw]    Skip Alpino (a), CSV output (c) or Wopr (w).\n";
+  cerr << "\t--syntax=frog approximate the Alpino metrics from Frog's "
+       << "dependencies" << endl;
   cerr << "\t-t <file> process the 'file'. (deprecated)" << endl;
+  cerr << "\t--threads=<num> analyse at most 'num' sentences at the same time"
+       << endl;
+  cerr << "\t--jobs=<num> analyse at most 'num' input files at the same time"
+       << endl;
+  cerr << "\t--serve run as a server, analysing documents sent to 'port'"
+       << endl;
+  cerr << "\t\t--port=<num> the port to listen on" << endl;
+  cerr << "\t\t--maxconn=<num> the maximum number of concurrent clients"
+       << endl;
+  cerr << "\t\t--logfile=<file> log to 'file'" << endl;
+  cerr << "\t\t--pidfile=<file> store the process id in 'file'" << endl;
+  cerr << "\t\t--daemonize=[yes|no] detach from the terminal (default yes)"
+       << endl;
   cerr << endl;
 }
 
-Conn::Type wordStats::checkConnective() const {
+// Appends a line to the problems file.
+// Several documents may be analysed at the same time, so serialize.
+void logProblem( const string& line ){
+  lock_guard<mutex> lock( problemMutex );
+  problemFile << line << endl;
+}
+
+Conn::Type wordStats::checkConnective( const word_lexicon& lex ) const {
   if ( tag != CGN::VG && tag != CGN::VZ && tag != CGN::BW )
     return Conn::NOCONN;
+  if ( !lex.lemma )
+    return Conn::NOCONN;
 
-  if ( settings.temporals1[tag].find( lemma )
-       != settings.temporals1[tag].end() )
-    return Conn::TEMPOREEL;
-  else if ( settings.temporals1[CGN::UNASS].find( lemma )
-	    != settings.temporals1[CGN::UNASS].end() )
+  const tag_mask *conns = lex.lemma->connectives;
+  if ( tagged( conns[TEMPORALS], tag ) )
     return Conn::TEMPOREEL;
-
-  else if ( settings.opsommers_wg[tag].find( lemma )
-      != settings.opsommers_wg[tag].end() )
-    return Conn::OPSOMMEND_WG;
-  else if ( settings.opsommers_wg[CGN::UNASS].find( lemma )
-      != settings.opsommers_wg[CGN::UNASS].end() )
+  else if ( tagged( conns[OPSOMMERS_WG], tag ) )
     return Conn::OPSOMMEND_WG;
-
-  else if ( settings.opsommers_zin[tag].find( lemma )
-      != settings.opsommers_zin[tag].end() )
+  else if ( tagged( conns[OPSOMMERS_ZIN], tag ) )
     return Conn::OPSOMMEND_ZIN;
-  else if ( settings.opsommers_zin[CGN::UNASS].find( lemma )
-      != settings.opsommers_zin[CGN::UNASS].end() )
-    return Conn::OPSOMMEND_ZIN;
-
-  else if ( settings.contrast1[tag].find( lemma )
-	    != settings.contrast1[tag].end() )
+  else if ( tagged( conns[CONTRAST], tag ) )
     return Conn::CONTRASTIEF;
-  else if ( settings.contrast1[CGN::UNASS].find( lemma )
-	    != settings.contrast1[CGN::UNASS].end() )
-    return Conn::CONTRASTIEF;
-
-  else if ( settings.compars1[tag].find( lemma )
-	    != settings.compars1[tag].end() )
+  else if ( tagged( conns[COMPARS], tag ) )
     return Conn::COMPARATIEF;
-  else if ( settings.compars1[CGN::UNASS].find( lemma )
-	    != settings.compars1[CGN::UNASS].end() )
-    return Conn::COMPARATIEF;
-
-  else if ( settings.causals1[tag].find( lemma )
-	    != settings.causals1[tag].end() )
-    return Conn::CAUSAAL;
-  else if ( settings.causals1[CGN::UNASS].find( lemma )
-	    != settings.causals1[CGN::UNASS].end() )
+  else if ( tagged( conns[CAUSALS], tag ) )
     return Conn::CAUSAAL;
 
   return Conn::NOCONN;
 }
 
-Situation::Type wordStats::checkSituation() const {
-  if ( settings.time_sits[tag].find( lemma )
-       != settings.time_sits[tag].end() ){
-    return Situation::TIME_SIT;
+Situation::Type wordStats::checkSituation( const word_lexicon& lex ) const {
+  if ( !lex.lemma ){
+    return Situation::NO_SIT;
   }
-  else if ( settings.time_sits[CGN::UNASS].find( lemma )
-	    != settings.time_sits[CGN::UNASS].end() ){
+  const tag_mask *sits = lex.lemma->situations;
+  if ( tagged( sits[TIME_SITS], tag ) ){
     return Situation::TIME_SIT;
   }
-  else if ( settings.causal_sits[tag].find( lemma )
-	    != settings.causal_sits[tag].end() ){
-    return Situation::CAUSAL_SIT;
-  }
-  else if ( settings.causal_sits[CGN::UNASS].find( lemma )
-	    != settings.causal_sits[CGN::UNASS].end() ){
+  else if ( tagged( sits[CAUSAL_SITS], tag ) ){
     return Situation::CAUSAL_SIT;
   }
-  else if ( settings.space_sits[tag].find( lemma )
-	    != settings.space_sits[tag].end() ){
+  else if ( tagged( sits[SPACE_SITS], tag ) ){
     return Situation::SPACE_SIT;
   }
-  else if ( settings.space_sits[CGN::UNASS].find( lemma )
-	    != settings.space_sits[CGN::UNASS].end() ){
-    return Situation::SPACE_SIT;
-  }
-  else if ( settings.emotion_sits[tag].find( lemma )
-	    != settings.emotion_sits[tag].end() ){
-    return Situation::EMO_SIT;
-  }
-  else if ( settings.emotion_sits[CGN::UNASS].find( lemma )
-	    != settings.emotion_sits[CGN::UNASS].end() ){
+  else if ( tagged( sits[EMOTION_SITS], tag ) ){
     return Situation::EMO_SIT;
   }
   return Situation::NO_SIT;
 }
 
-void wordStats::checkNoun() {
+void wordStats::checkNoun( const word_lexicon& lex ) {
   if ( tag == CGN::N ){
     //    cerr << "lookup " << lemma << endl;
-    map<string,noun>::const_iterator sit = settings.noun_sem.find( lemma );
-    if ( sit != settings.noun_sem.end() ){
-      noun n = sit->second;
+    if ( has( lex.lemma, NOUN_SEM ) ){
+      const noun_entry& n = lex.lemma->noun;
       sem_type = n.type;
       if (n.is_compound) {
         is_compound = n.is_compound;
         compound_parts = n.compound_parts;
-        compound_head = n.head;
-        compound_sat = n.satellite_clean;
+        compound_head = overlay->str( n.head );
+        compound_sat = overlay->str( n.satellite_clean );
       }
     }
     else {
       // If we still haven't found a SEM::Type, add this to the problemfile
       sem_type = SEM::UNFOUND_NOUN;
       if ( settings.showProblems ){
-        problemFile << "N," << word << ", " << lemma << endl;
+        problems.push_back( "N," + word + ", " + lemma );
       }
     }
   }
 }
 
-SEM::Type wordStats::checkSemProps( ) const {
+SEM::Type wordStats::checkSemProps( const word_lexicon& lex ) {
   if ( prop == CGN::ISNAME ){
     // Names are te be looked up in the Noun list too, but use the word instead of the lemma (case-sensitivity)
     SEM::Type sem = SEM::UNFOUND_NOUN;
-    map<string,noun>::const_iterator sit = settings.noun_sem.find( word );
-    if ( sit != settings.noun_sem.end() ){
-      sem = sit->second.type;
+    if ( has( lex.word, NOUN_SEM ) ){
+      sem = lex.word->noun.type;
     }
     return sem;
   }
   else if ( tag == CGN::ADJ ) {
     //    cerr << "ADJ check semtype " << l_lemma << endl;
     SEM::Type sem = SEM::UNFOUND_ADJ;
-    map<string,SEM::Type>::const_iterator sit = settings.adj_sem.find( l_lemma );
-    if ( sit == settings.adj_sem.end() ){
+    if ( has( lex.l_lemma, ADJ_SEM ) ){
+      sem = lex.l_lemma->adj_sem;
+    }
+    else if ( has( lex.l_word, ADJ_SEM ) ){
       // lemma not found. maybe the whole word?
       //      cerr << "ADJ check semtype " << word << endl;
-      sit = settings.adj_sem.find( l_word );
-    }
-    if ( sit != settings.adj_sem.end() ){
-      sem = sit->second;
+      sem = lex.l_word->adj_sem;
     }
     else if ( settings.showProblems ){
-      problemFile << "ADJ," << l_word << "," << l_lemma << endl;
+      problems.push_back( "ADJ," + l_word + "," + l_lemma );
     }
     //    cerr << "found semtype " << sem << endl;
     return sem;
@@ -1129,33 +221,25 @@ SEM::Type wordStats::checkSemProps( ) const {
   else if ( tag == CGN::WW ) {
     //    cerr << "check semtype " << lemma << endl;
     SEM::Type sem = SEM::UNFOUND_VERB;
-    map<string,SEM::Type>::const_iterator sit = settings.verb_sem.end();
-    if ( !full_lemma.empty() ) {
-      sit = settings.verb_sem.find( full_lemma );
-    }
-    if ( sit == settings.verb_sem.end() ){
-      if ( position == CGN::PRENOM
-	   && ( prop == CGN::ISVD || prop == CGN::ISOD ) ){
-	// might be a 'hidden' adj!
-	//	cerr << "lookup a probable ADJ " << prop << " (" << word << ") " << endl;
-	sit = settings.adj_sem.find( l_word );
-	if ( sit == settings.adj_sem.end() )
-	  sit = settings.verb_sem.end();
-      }
+    if ( has( lex.full_lemma, VERB_SEM ) ){
+      sem = lex.full_lemma->verb_sem;
     }
-    if ( sit == settings.verb_sem.end() ){
-      //      cerr << "lookup lemma as verb (" << lemma << ") " << endl;
-      sit = settings.verb_sem.find( l_lemma );
+    else if ( position == CGN::PRENOM
+	      && ( prop == CGN::ISVD || prop == CGN::ISOD )
+	      && has( lex.l_word, ADJ_SEM ) ){
+      // might be a 'hidden' adj!
+      //	cerr << "lookup a probable ADJ " << prop << " (" << word << ") " << endl;
+      sem = lex.l_word->adj_sem;
     }
-    if ( sit != settings.verb_sem.end() ){
-      sem = sit->second;
+    else if ( has( lex.l_lemma, VERB_SEM ) ){
+      //      cerr << "lookup lemma as verb (" << lemma << ") " << endl;
+      sem = lex.l_lemma->verb_sem;
     }
     else if ( settings.showProblems ){
-      problemFile << "WW," << l_word << "," << l_lemma;
+      string line = "WW," + l_word + "," + l_lemma;
       if ( !full_lemma.empty() )
-	problemFile << "," << full_lemma << endl;
-      else
-	problemFile << endl;
+	line += "," + full_lemma;
+      problems.push_back( line );
     }
     //    cerr << "found semtype " << sem << endl;
     return sem;
@@ -1163,135 +247,104 @@ SEM::Type wordStats::checkSemProps( ) const {
   return SEM::NO_SEMTYPE;
 }
 
-// Looks up the Intensity type for a word, or NO_INTENSIFY if not found
-Intensify::Type wordStats::checkIntensify(const xmlNode *alpWord) const {
+// Looks up the Intensity type for a word, or NO_INTENSIFY if not found.
+// A BVBW still has to be checked for being a modifier in the sentence.
+Intensify::Type wordStats::checkIntensify( const word_lexicon& lex ) const {
   Intensify::Type res = Intensify::NO_INTENSIFY;
 
   // First check the full lemma (if available), then the normal lemma
-  map<string,Intensify::Type>::const_iterator sit = settings.intensify.end();
-  if (!full_lemma.empty()) {
-    sit = settings.intensify.find(full_lemma);
+  const word_entry *e = 0;
+  if ( has( lex.full_lemma, INTENSIFY ) ){
+    e = lex.full_lemma;
   }
-  if (sit == settings.intensify.end()) {
-    sit = settings.intensify.find(lemma);
+  else if ( has( lex.lemma, INTENSIFY ) ){
+    e = lex.lemma;
   }
 
-  if (sit != settings.intensify.end()) {
-    res = sit->second;
-
-    // Special case for BVBW: check if this is not a modifier
-    if (res == Intensify::BVBW)
-    {
-      if (!checkModifier(alpWord)) res = Intensify::NO_INTENSIFY;
-    }
+  if (e) {
+    res = e->intensify;
   }
   return res;
 }
 
 // Looks up the General type for a noun (based on lemma), or NO_GENERAL if not found
-General::Type wordStats::checkGeneralNoun() const {
+General::Type wordStats::checkGeneralNoun( const word_lexicon& lex ) const {
   if (tag == CGN::N) {
-    map<string,General::Type>::const_iterator sit = settings.general_nouns.find(lemma);
-    if (sit != settings.general_nouns.end()) {
-      return sit->second;
+    if ( has( lex.lemma, GENERAL_NOUN ) ) {
+      return lex.lemma->general_noun;
     }
   }
   return General::NO_GENERAL;
 }
 
 // Looks up the General type for a verb (based on (full) lemma), or NO_GENERAL if not found
-General::Type wordStats::checkGeneralVerb() const {
+General::Type wordStats::checkGeneralVerb( const word_lexicon& lex ) const {
   if (tag == CGN::WW) {
     // First check the full lemma (if available), then the normal lemma
-    map<string,General::Type>::const_iterator sit = settings.general_verbs.end();
-    if (!full_lemma.empty()) {
-      sit = settings.general_verbs.find(full_lemma);
-    }
-    if (sit == settings.general_verbs.end()) {
-      sit = settings.general_verbs.find(lemma);
+    if ( has( lex.full_lemma, GENERAL_VERB ) ) {
+      return lex.full_lemma->general_verb;
     }
-
-    if (sit != settings.general_verbs.end()) {
-      return sit->second;
+    if ( has( lex.lemma, GENERAL_VERB ) ) {
+      return lex.lemma->general_verb;
     }
   }
   return General::NO_GENERAL;
 }
 
-Adverb::Type checkAdverbType(string word, CGN::Type tag) {
-  if (tag == CGN::BW) {
-    map<string,Adverb::adverb>::const_iterator sit = settings.adverbs.find(word);
-    if (sit != settings.adverbs.end()) {
-      return sit->second.type;
-    }
+Adverb::Type checkAdverbType( const word_entry *e, CGN::Type tag ) {
+  if ( tag == CGN::BW && has( e, ADVERB ) ) {
+    return e->adverb.type;
   }
   return Adverb::NO_ADVERB;
 }
 
-Adverb::SubType checkAdverbSubType(string word, CGN::Type tag) {
-  if (tag == CGN::BW) {
-    map<string,Adverb::adverb>::const_iterator sit = settings.adverbs.find(word);
-    if (sit != settings.adverbs.end()) {
-      return sit->second.subtype;
-    }
+Adverb::SubType checkAdverbSubType( const word_entry *e, CGN::Type tag ) {
+  if ( tag == CGN::BW && has( e, ADVERB ) ) {
+    return e->adverb.subtype;
   }
   return Adverb::NO_ADVERB_SUBTYPE;
 }
 
-Afk::Type wordStats::checkAfk() const {
+Afk::Type wordStats::checkAfk( const word_lexicon& lex ) const {
   if ( tag == CGN::N || tag == CGN::SPEC) {
-    map<string,Afk::Type>::const_iterator sit = settings.afkos.find( word );
-    if ( sit != settings.afkos.end() ){
-      return sit->second;
+    if ( has( lex.word, AFK ) ){
+      return lex.word->afk;
     }
   }
   return Afk::NO_A;
 }
 
 // Returns the self-defined classification for a lemma (if its tag is correct)
-string wordStats::checkMyClassification() const {
+string wordStats::checkMyClassification( const word_lexicon& lex ) const {
   string result;
-  map<string,tagged_classification>::const_iterator sit = settings.my_classification.find( lemma );
-  if ( sit != settings.my_classification.end() ){
-    tagged_classification tc = sit->second;
+  if ( has( lex.lemma, CLASSIFICATION ) ){
+    const classification_entry& tc = lex.lemma->classification;
     if (tc.tag == CGN::UNASS || tc.tag == tag) {
-      result = tc.classification;
+      result = overlay->str( tc.classification );
     }
   }
   return result;
 }
 
 // Returns whether the lemma appears on the stoplist
-bool wordStats::checkStoplist() const {
-  bool result = false;
-
-  if ( settings.stop_lemmata[tag].find( lemma )
-       != settings.stop_lemmata[tag].end() ){
-    result = true;
-  }
-  else if ( settings.stop_lemmata[CGN::UNASS].find( lemma )
-	    != settings.stop_lemmata[CGN::UNASS].end() ){
-    result = true;
-  }
-  return result;
+bool wordStats::checkStoplist( const word_lexicon& lex ) const {
+  return lex.lemma && tagged( lex.lemma->stop, tag );
 }
 
 // Returns the position of a word in the top-20000 lexicon
-top_val wordStats::topFreqLookup(const string& w) const {
-  map<string,top_val>::const_iterator it = settings.top_freq_lex.find( w );
+top_val wordStats::topFreqLookup( const word_entry *e ) const {
   top_val result = notFound;
-  if ( it != settings.top_freq_lex.end() ){
-    result = it->second;
+  if ( has( e, TOP_FREQ ) ){
+    result = e->top_freq;
   }
   return result;
 }
 
 // Returns the frequency of a word in the word lexicon
-int wordStats::wordFreqLookup(const string& w) const {
+int wordStats::wordFreqLookup( const word_entry *e ) const {
   int result = 0;
-  map<string,cf_data>::const_iterator it = settings.word_freq_lex.find( w );
-  if ( it != settings.word_freq_lex.end() ){
-    result = it->second.count;
+  if ( has( e, WORD_FREQ ) ){
+    result = e->word_freq.count;
   }
   return result;
 }
@@ -1303,40 +356,39 @@ double freqLog(const long int& freq, const long int& total) {
 }
 
 // Find the frequencies of words and lemmata
-void wordStats::freqLookup(){
-  word_freq = wordFreqLookup(l_word);
-  word_freq_log = freqLog(word_freq, settings.word_total);
+void wordStats::freqLookup( const word_lexicon& lex,
+			    word_features& f ) const {
+  f.word_freq = wordFreqLookup( lex.l_word );
+  f.word_freq_log = freqLog(f.word_freq, overlay->lexicons().word_total);
 
-  map<string,cf_data>::const_iterator it = settings.lemma_freq_lex.end();
-  if ( !full_lemma.empty() ){
+  const word_entry *e = 0;
+  if ( has( lex.full_lemma, LEMMA_FREQ ) ){
     // scheidbaar ww
-    it = settings.lemma_freq_lex.find( full_lemma );
+    e = lex.full_lemma;
   }
-  if ( it == settings.lemma_freq_lex.end() ){
-    it = settings.lemma_freq_lex.find( l_lemma );
+  else if ( has( lex.l_lemma, LEMMA_FREQ ) ){
+    e = lex.l_lemma;
   }
-  if ( it != settings.lemma_freq_lex.end() ){
-    lemma_freq = it->second.count;
-    lemma_freq_log = freqLog(lemma_freq, settings.lemma_total);
+  if ( e ){
+    f.lemma_freq = e->lemma_freq.count;
+    f.lemma_freq_log = freqLog(f.lemma_freq, overlay->lexicons().lemma_total);
   }
   else {
-    lemma_freq = 0;
-    lemma_freq_log = freqLog(lemma_freq, settings.lemma_total);
+    f.lemma_freq = 0;
+    f.lemma_freq_log = freqLog(f.lemma_freq, overlay->lexicons().lemma_total);
   }
 }
 
-void wordStats::prevalenceLookup() {
-  map<string,prevalence>::const_iterator it = settings.prevalences.find( l_lemma );
-  if ( it != settings.prevalences.end() ){
-    prevalenceP = it->second.percentage;
-    prevalenceZ = it->second.zscore;
+void wordStats::prevalenceLookup( const word_lexicon& lex ) {
+  if ( has( lex.l_lemma, PREVALENCE ) ){
+    prevalenceP = lex.l_lemma->prev.percentage;
+    prevalenceZ = lex.l_lemma->prev.zscore;
   }
 }
 
-void wordStats::staphFreqLookup(){
-  map<string,cf_data>::const_iterator it = settings.staph_word_freq_lex.find( l_word );
-  if ( it != settings.staph_word_freq_lex.end() ){
-    double freq = it->second.freq;
+void wordStats::staphFreqLookup( const word_lexicon& lex ){
+  if ( has( lex.l_word, STAPH_FREQ ) ){
+    double freq = lex.l_word->staph_freq.freq;
     if ( freq <= 50 )
       f50 = true;
     if ( freq <= 65 )
@@ -1348,11 +400,132 @@ void wordStats::staphFreqLookup(){
   }
 }
 
+// Finds the lexicon entries for all forms of the word, probing each
+// distinct string only once.
+word_lexicon wordStats::lexiconLookup() const {
+  word_lexicon lex;
+  lex.word = overlay->find( word );
+  lex.l_word = ( l_word == word ) ? lex.word : overlay->find( l_word );
+  lex.lemma = overlay->find( lemma );
+  lex.l_lemma = ( l_lemma == lemma ) ? lex.lemma
+    : overlay->find( l_lemma );
+  lex.full_lemma = 0;
+  if ( !full_lemma.empty() ){
+    lex.full_lemma = ( full_lemma == l_lemma ) ? lex.l_lemma
+      : overlay->find( full_lemma );
+  }
+  return lex;
+}
+
+// Computes the features that only depend on the word itself and its
+// morphemes (see word_features), and copies them into 'f'.
+void wordStats::lookupFeatures( word_features& f ){
+  const word_lexicon lex = lexiconLookup();
+  isPropNeg = checkPropNeg();
+  isMorphNeg = checkMorphNeg();
+  connType = checkConnective( lex );
+  sitType = checkSituation( lex );
+  sem_type = checkSemProps( lex );
+  checkNoun( lex );
+  intensify_type = checkIntensify( lex );
+  general_noun_type = checkGeneralNoun( lex );
+  general_verb_type = checkGeneralVerb( lex );
+  adverb_type = checkAdverbType( lex.l_word, tag );
+  adverb_sub_type = checkAdverbSubType( lex.l_word, tag );
+  afkType = checkAfk( lex );
+  top_freq = topFreqLookup( lex.l_word );
+  prevalenceLookup( lex );
+  staphFreqLookup( lex );
+  freqLookup( lex, f );
+  if ( is_compound ) {
+    const word_entry *head = overlay->find( compound_head );
+    const word_entry *sat = overlay->find( compound_sat );
+    word_freq_log_head = freqLog(wordFreqLookup(head), overlay->lexicons().word_total);
+    word_freq_log_sat = freqLog(wordFreqLookup(sat), overlay->lexicons().word_total);
+    word_freq_log_head_sat = (word_freq_log_head + word_freq_log_sat) / double(2);
+    top_freq_head = topFreqLookup(head);
+    top_freq_sat = topFreqLookup(sat);
+  }
+  on_stoplist = checkStoplist( lex );
+  my_classification = checkMyClassification( lex );
+
+  f.morphemes = morphemes;
+  f.compstr = compstr;
+  f.isPropNeg = isPropNeg;
+  f.isMorphNeg = isMorphNeg;
+  f.connType = connType;
+  f.sitType = sitType;
+  f.sem_type = sem_type;
+  f.is_compound = is_compound;
+  f.compound_parts = compound_parts;
+  f.compound_head = compound_head;
+  f.compound_sat = compound_sat;
+  f.intensify_type = intensify_type;
+  f.general_noun_type = general_noun_type;
+  f.general_verb_type = general_verb_type;
+  f.adverb_type = adverb_type;
+  f.adverb_sub_type = adverb_sub_type;
+  f.afkType = afkType;
+  f.top_freq = top_freq;
+  f.prevalenceP = prevalenceP;
+  f.prevalenceZ = prevalenceZ;
+  f.f50 = f50;
+  f.f65 = f65;
+  f.f77 = f77;
+  f.f80 = f80;
+  f.word_freq_log_head = word_freq_log_head;
+  f.word_freq_log_sat = word_freq_log_sat;
+  f.word_freq_log_head_sat = word_freq_log_head_sat;
+  f.top_freq_head = top_freq_head;
+  f.top_freq_sat = top_freq_sat;
+  f.on_stoplist = on_stoplist;
+  f.my_classification = my_classification;
+  f.problems.swap( problems );
+}
+
+// Takes over the features found before for the same type. The frequencies
+// are only taken for content words, by the constructor.
+void wordStats::setFeatures( const word_features& f ){
+  morphemes = f.morphemes;
+  compstr = f.compstr;
+  isPropNeg = f.isPropNeg;
+  isMorphNeg = f.isMorphNeg;
+  connType = f.connType;
+  sitType = f.sitType;
+  sem_type = f.sem_type;
+  is_compound = f.is_compound;
+  compound_parts = f.compound_parts;
+  compound_head = f.compound_head;
+  compound_sat = f.compound_sat;
+  intensify_type = f.intensify_type;
+  general_noun_type = f.general_noun_type;
+  general_verb_type = f.general_verb_type;
+  adverb_type = f.adverb_type;
+  adverb_sub_type = f.adverb_sub_type;
+  afkType = f.afkType;
+  top_freq = f.top_freq;
+  prevalenceP = f.prevalenceP;
+  prevalenceZ = f.prevalenceZ;
+  f50 = f.f50;
+  f65 = f.f65;
+  f77 = f.f77;
+  f80 = f.f80;
+  word_freq_log_head = f.word_freq_log_head;
+  word_freq_log_sat = f.word_freq_log_sat;
+  word_freq_log_head_sat = f.word_freq_log_head_sat;
+  top_freq_head = f.top_freq_head;
+  top_freq_sat = f.top_freq_sat;
+  on_stoplist = f.on_stoplist;
+  my_classification = f.my_classification;
+}
+
 wordStats::wordStats( int index,
 		      folia::Word *w,
-		      const xmlNode *alpWord,
-		      const set<size_t>& puncts,
-		      bool fail ):
+		      const AlpinoTree *alpTree,
+		      int alpWord,
+		      const PunctuationIndex& puncts,
+		      bool fail,
+		      const LexiconOverlay *ov ):
   basicStats( index, w, "word" ), parseFail(fail), wwform(::NO_VERB),
   isPersRef(false), isPronRef(false),
   archaic(false), isContent(false), isContentStrict(false),
@@ -1370,7 +543,8 @@ wordStats::wordStats( int index,
   general_noun_type(General::NO_GENERAL), general_verb_type(General::NO_GENERAL),
   adverb_type(Adverb::NO_ADVERB), adverb_sub_type(Adverb::NO_ADVERB_SUBTYPE),
   afkType(Afk::NO_A), is_compound(false), compound_parts(0),
-  word_freq_log_head(NAN), word_freq_log_sat(NAN), word_freq_log_head_sat(NAN), word_freq_log_corr(NAN), on_stoplist(false)
+  word_freq_log_head(NAN), word_freq_log_sat(NAN), word_freq_log_head_sat(NAN), word_freq_log_corr(NAN), on_stoplist(false),
+  overlay(ov)
 {
   icu::UnicodeString us = w->text();
   charCnt = us.length();
@@ -1389,11 +563,11 @@ wordStats::wordStats( int index,
   l_lemma = TiCC::UnicodeToUTF8( us.toLower() );
 
   setCGNProps( pa );
-  if ( alpWord ){
-    distances = getDependencyDist( alpWord, puncts);
+  if ( alpTree && alpWord >= 0 ){
+    distances = getDependencyDist( *alpTree, alpWord, puncts);
     if ( tag == CGN::WW ){
       string full;
-      wwform = classifyVerb( alpWord, lemma, full );
+      wwform = classifyVerb( *alpTree, alpWord, lemma, full );
       if ( !full.empty() ){
 	TiCC::to_lower( full );
 	//	cerr << "scheidbaar WW: " << full << endl;
@@ -1401,7 +575,7 @@ wordStats::wordStats( int index,
       }
       if ( (prop == CGN::ISPVTGW || prop == CGN::ISPVVERL) &&
 	   wwform != PASSIVE_VERB ){
-	isImperative = checkImp( alpWord );
+	isImperative = checkImp( *alpTree, alpWord );
       }
     }
   }
@@ -1411,74 +585,80 @@ wordStats::wordStats( int index,
     // like [appel][taart] of [veilig][heid]
     // there may be more readings/morpheme lists:
     // [ge][naken][t] versus [genaak][t]
-    size_t max = 0;
-    size_t pos = 0;
-    size_t match_pos = 0;
-    for ( auto const s : mv ){
-      vector<string> parts;
-      TiCC::split_at_first_of( s, parts, "[]" );
-      if ( parts.size() > max ){
-	// a hack: we assume the longest morpheme list to
-	// be the best choice.
-	morphemes = parts;
-	max = parts.size();
-	match_pos = pos;
+    vector<string> cmps = get_compound_analysis(w);
+    //    cerr << "Comps " << word << "= " << cmps << endl;
+    // the features that don't depend on the sentence are computed once per
+    // type, which includes the morphological analyses (see word_features)
+    string key = word + "\t" + lemma + "\t" + pos + "\t" + full_lemma;
+    for ( const auto& s : mv ){
+      key += "\t" + s;
+    }
+    key += "\t";
+    for ( const auto& s : cmps ){
+      key += "\t" + s;
+    }
+    word_features f;
+    if ( !overlay->features().find( key, f ) ){
+      size_t max = 0;
+      size_t pos = 0;
+      size_t match_pos = 0;
+      for ( auto const s : mv ){
+	vector<string> parts;
+	TiCC::split_at_first_of( s, parts, "[]" );
+	if ( parts.size() > max ){
+	  // a hack: we assume the longest morpheme list to
+	  // be the best choice.
+	  morphemes = parts;
+	  max = parts.size();
+	  match_pos = pos;
+	}
+	++pos;
+      }
+      if ( cmps.size() > match_pos ) {
+	// this might not be the case e.g. when frog isn't started
+	// with the --deep-morph option!
+	compstr = cmps[match_pos];
       }
-      ++pos;
+      lookupFeatures( f );
+      overlay->features().add( key, f );
     }
+    setFeatures( f );
     if ( morphemes.size() == 0 ){
       cerr << "unable to retrieve morphemes from folia." << endl;
     }
     //    cerr << "Morphemes " << word << "= " << morphemes << endl;
-    vector<string> cmps = get_compound_analysis(w);
-    //    cerr << "Comps " << word << "= " << cmps << endl;
-    if ( cmps.size() > match_pos ) {
-      // this might not be the case e.g. when frog isn't started
-      // with the --deep-morph option!
-      compstr = cmps[match_pos];
-    }
-    isPropNeg = checkPropNeg();
-    isMorphNeg = checkMorphNeg();
-    connType = checkConnective();
-    sitType = checkSituation();
+    for ( const auto& line : f.problems ){
+      logProblem( line );
+    }
     morphCnt = morphemes.size();
     if ( prop != CGN::ISNAME ){
       charCntExNames = charCnt;
       morphCntExNames = morphCnt;
     }
-    sem_type = checkSemProps();
-    checkNoun();
-    intensify_type = checkIntensify(alpWord);
-    general_noun_type = checkGeneralNoun();
-    general_verb_type = checkGeneralVerb();
-    adverb_type = checkAdverbType(l_word, tag);
-    adverb_sub_type = checkAdverbSubType(l_word, tag);
-    afkType = checkAfk();
-    if ( alpWord )
-      isNominal = checkNominal( alpWord );
-    top_freq = topFreqLookup(l_word);
-    prevalenceLookup();
-    staphFreqLookup();
+    // Special case for BVBW: check if this is not a modifier
+    if ( intensify_type == Intensify::BVBW
+	 && ( !alpTree || alpWord < 0
+	      || !checkModifier( *alpTree, alpWord ) ) ){
+      intensify_type = Intensify::NO_INTENSIFY;
+    }
+    if ( alpTree && alpWord >= 0 )
+      isNominal = checkNominal( *alpTree, alpWord );
     isContent = checkContent(false);
     isContentStrict = checkContent(true);
     if ( isContent ){
-      freqLookup();
+      word_freq = f.word_freq;
+      word_freq_log = f.word_freq_log;
+      lemma_freq = f.lemma_freq;
+      lemma_freq_log = f.lemma_freq_log;
     }
     if ( is_compound ) {
       charCntHead = compound_head.length();
       charCntSat = compound_sat.length();
-      word_freq_log_head = freqLog(wordFreqLookup(compound_head), settings.word_total);
-      word_freq_log_sat = freqLog(wordFreqLookup(compound_sat), settings.word_total);
-      word_freq_log_head_sat = (word_freq_log_head + word_freq_log_sat) / double(2);
-      top_freq_head = topFreqLookup(compound_head);
-      top_freq_sat = topFreqLookup(compound_sat);
       word_freq_log_corr = word_freq_log_head;
     }
     else {
       word_freq_log_corr = word_freq_log;
     }
-    on_stoplist = checkStoplist();
-    my_classification = checkMyClassification();
   }
 }
 
@@ -1654,94 +834,6 @@ void structStats::calculate_MTLDs() {
   all_conn_mtld = average_mtld( all_conn );
 }
 
-//#define DEBUG_WOPR
-void orderWopr( const string& type, const string& txt, vector<double>& wordProbsV,
-		double& sentProb, double& entropy, double& perplexity ){
-  string host = config.lookUp( "host_" + type, "wopr" );
-  string port = config.lookUp( "port_" + type, "wopr" );
-  Sockets::ClientSocket client;
-  if ( !client.connect( host, port ) ){
-    cerr << "failed to open Wopr connection: "<< host << ":" << port << endl;
-    cerr << "Reason: " << client.getMessage() << endl;
-    exit( EXIT_FAILURE );
-  }
-  cerr << "calling Wopr" << endl;
-  client.write( txt + "\n\n" );
-  string result;
-  string s;
-  while ( client.read(s) ){
-    result += s + "\n";
-  }
-#ifdef DEBUG_WOPR
-  cerr << "received data [" << result << "]" << endl;
-#endif
-  if ( !result.empty() && result.size() > 10 ){
-#ifdef DEBUG_WOPR
-    cerr << "start FoLiA parsing" << endl;
-#endif
-    folia::Document doc;
-    try {
-      doc.readFromString( result );
-#ifdef DEBUG_WOPR
-      cerr << "finished parsing" << endl;
-#endif
-      vector<folia::Word*> wv = doc.words();
-      if ( wv.size() !=  wordProbsV.size() ){
-	cerr << "unforseen mismatch between de number of words returned by WOPR"
-	    << endl << " and the number of words in the input sentence. "
-	    << endl;
-	return;
-      }
-      for ( size_t i=0; i < wv.size(); ++i ){
-	vector<folia::Metric*> mv = wv[i]->select<folia::Metric>();
-	if ( mv.size() > 0 ){
-	  for ( size_t j=0; j < mv.size(); ++j ){
-	    if ( mv[j]->cls() == "lprob10" ){
-	      wordProbsV[i] = TiCC::stringTo<double>( mv[j]->feat("value") );
-	    }
-	  }
-	}
-      }
-      vector<folia::Sentence*> sv = doc.sentences();
-      if ( sv.size() != 1 ){
-	throw logic_error( "The document returned by WOPR contains > 1 Sentence" );
-      }
-      vector<folia::Metric*> mv = sv[0]->select<folia::Metric>();
-      if ( mv.size() > 0 ){
-	for ( size_t j=0; j < mv.size(); ++j ){
-	  if ( mv[j]->cls() == "avg_prob10" ){
-	    string val = mv[j]->feat("value");
-	    if ( val != "nan" ){
-	      sentProb = TiCC::stringTo<double>( val );
-	    }
-	  }
-	  else if ( mv[j]->cls() == "entropy" ){
-	    string val = mv[j]->feat("value");
-	    if ( val != "nan" ){
-	      entropy = TiCC::stringTo<double>( val );
-	    }
-	  }
-	  else if ( mv[j]->cls() == "perplexity" ){
-	    string val = mv[j]->feat("value");
-	    if ( val != "nan" ){
-	      perplexity = TiCC::stringTo<double>( val );
-	    }
-	  }
-	}
-      }
-    }
-    catch ( std::exception& e ){
-      cerr << "FoLiaParsing failed:" << endl
-	  << e.what() << endl;
-    }
-  }
-  else {
-    cerr << "No usable FoLia data retrieved from Wopr. Got '"
-	<< result << "'" << endl;
-  }
-  cerr << "done with Wopr" << endl;
-}
-
 xmlDoc *AlpinoServerParse( folia::Sentence *);
 
 void fill_word_lemma_buffers( const sentStats* ss,
@@ -1778,103 +870,173 @@ void np_length( folia::Sentence *s, int& npcount, int& indefcount, int& size ) {
   }
 }
 
-sentStats::sentStats( int index, folia::Sentence *s, const sentStats* pred ):
-  structStats( index, s, "sent" ){
+vector<string> frog_tags( const folia::Sentence *s ){
+  // Frog's tags of the words, for splitForAlpino
+  vector<string> tags;
+  for ( const auto& w : s->words() ){
+    vector<folia::PosAnnotation*> posV = w->select<folia::PosAnnotation>(frog_pos_set);
+    tags.push_back( posV.size() == 1 ? posV[0]->cls() : "" );
+  }
+  return tags;
+}
+
+void dump_parse( xmlDoc *doc, const folia::Sentence *s ){
+  // for debugging. Every parse gets a file of its own, so concurrent
+  // sentences and documents with the same ids don't overwrite each other
+  static atomic<unsigned int> dumped( 0 );
+  string file = settings.alpinoDump + TiCC::toString( ++dumped )
+    + "-" + s->id() + ".xml";
+  xmlSaveFormatFileEnc( file.c_str(), doc, "UTF8", 1 );
+}
+
+sentStats::sentStats( int index, folia::Sentence *s,
+		      AlpinoBatch *alpino, size_t alpino_pos,
+		      WoprBatch *wopr, size_t wopr_pos,
+		      const LexiconOverlay *overlay ):
+  structStats( index, s, "sent" ), overlay( overlay ){
   text = TiCC::UnicodeToUTF8( s->toktext() );
   cerr << "analyse tokenized sentence=" << text << endl;
   vector<folia::Word*> w = s->words();
-  vector<double> woprProbsV_fwd(w.size(),NAN);
-  vector<double> woprProbsV_bwd(w.size(),NAN);
-  double sentProb_fwd = NAN;
-  double sentProb_bwd = NAN;
-  double sentEntropy_fwd = NAN;
-  double sentEntropy_bwd = NAN;
-  double sentPerplexity_fwd = NAN;
-  double sentPerplexity_bwd = NAN;
   xmlDoc *alpDoc = 0;
-  set<size_t> puncts;
+  AlpinoTree *alpTree = 0;
+  vector<bool> is_punct( w.size(), false );
   parseFailCnt = -1; // not parsed (yet)
-#pragma omp parallel sections
-  {
-#pragma omp section
-    {
-      if ( settings.doAlpino || settings.doAlpinoServer ){
-	if ( settings.doAlpinoServer ){
-	  cerr << "calling Alpino Server" << endl;
-	  alpDoc = AlpinoServerParse( s );
-	  if ( !alpDoc ){
-	    cerr << "alpino parser failed!" << endl;
-	  }
-	  cerr << "done with Alpino Server" << endl;
-	}
-	else if ( settings.doAlpino ){
-	  cerr << "calling Alpino parser" << endl;
-	  alpDoc = AlpinoParse( s, workdir_name );
-	  if ( !alpDoc ){
-	    cerr << "alpino parser failed!" << endl;
-	  }
-	  cerr << "done with Alpino parser" << endl;
+  if ( settings.doAlpino || settings.doAlpinoServer
+       || settings.doFrogSyntax ){
+    if ( settings.doFrogSyntax ){
+      alpDoc = frogDependencyTree( s, frog_pos_set, frog_lemma_set );
+      if ( !alpDoc ){
+	cerr << "no dependencies from Frog!" << endl;
+      }
+      else {
+	frogSyntaxCnt = 1;
+      }
+    }
+    else if ( settings.doAlpinoServer ){
+      cerr << "calling Alpino Server" << endl;
+      if ( alpino ){
+	alpDoc = alpino->result( alpino_pos );
+      }
+      else {
+	alpDoc = AlpinoServerParse( s );
+      }
+      if ( !alpDoc ){
+	cerr << "alpino parser failed!" << endl;
+      }
+      cerr << "done with Alpino Server" << endl;
+    }
+    else if ( settings.doAlpino ){
+      cerr << "calling Alpino parser" << endl;
+      vector<string> pieces = splitForAlpino( text, frog_tags( s ),
+					      settings.alpinoSplit );
+      vector<xmlDoc*> parses;
+      for ( const auto& txt : pieces ){
+	xmlDoc *doc = 0;
+	if ( parse_cache ){
+	  doc = parse_cache->lookup( txt );
 	}
-	if ( alpDoc ){
-	  parseFailCnt = 0; // OK
-	  for( size_t i=0; i < w.size(); ++i ){
-	    vector<folia::PosAnnotation*> posV = w[i]->select<folia::PosAnnotation>(frog_pos_set);
-	    if ( posV.size() != 1 )
-	      throw folia::ValueError( "word doesn't have Frog POS tag info" );
-	    folia::PosAnnotation *pa = posV[0];
-	    string posHead = pa->feat("head");
-	    if ( posHead == "LET" ){
-	      puncts.insert( i );
-	    }
+	if ( !doc ){
+	  doc = alpino_pool->parse( txt );
+	  if ( parse_cache ){
+	    parse_cache->store( txt, doc );
 	  }
-	  dLevel = get_d_level( s, alpDoc );
-	  if ( dLevel > 4 )
-	    dLevel_gt4 = 1;
-	  mod_stats( alpDoc, adjNpModCnt, npModCnt );
-	  resolveAdverbials(alpDoc);
-	  resolveRelativeClauses(alpDoc);
-	  resolveFiniteVerbs(alpDoc);
-	  resolveConjunctions(alpDoc);
-	  resolveSmallConjunctions(alpDoc);
-	}
-	else {
-	  parseFailCnt = 1; // failed
 	}
+	parses.push_back( doc );
       }
-    } // omp section
-
-#pragma omp section
-    {
-      if ( settings.doWopr ){
-	orderWopr( "fwd", text, woprProbsV_fwd, sentProb_fwd, sentEntropy_fwd, sentPerplexity_fwd );
+      if ( parses.size() == 1 ){
+	alpDoc = parses[0];
       }
-    } // omp section
-#pragma omp section
-    {
-      if ( settings.doWopr ){
-	orderWopr( "bwd", text, woprProbsV_bwd, sentProb_bwd, sentEntropy_bwd, sentPerplexity_bwd );
+      else {
+	alpDoc = joinAlpinoParses( parses, pieces );
+      }
+      if ( !alpDoc ){
+	cerr << "alpino parser failed!" << endl;
+      }
+      cerr << "done with Alpino parser" << endl;
+    }
+    if ( alpDoc ){
+      parseFailCnt = 0; // OK
+      if ( !settings.alpinoDump.empty() ){
+	dump_parse( alpDoc, s );
       }
-    } // omp section
-  } // omp sections
+      xmlNode *root = xmlDocGetRootElement( alpDoc );
+      if ( !TiCC::getAttribute( root, "split" ).empty() ){
+	parseSplitCnt = 1;
+      }
+      for( size_t i=0; i < w.size(); ++i ){
+	vector<folia::PosAnnotation*> posV = w[i]->select<folia::PosAnnotation>(frog_pos_set);
+	if ( posV.size() != 1 )
+	  throw folia::ValueError( "word doesn't have Frog POS tag info" );
+	folia::PosAnnotation *pa = posV[0];
+	string posHead = pa->feat("head");
+	if ( posHead == "LET" ){
+	  is_punct[i] = true;
+	}
+      }
+      alpTree = new AlpinoTree( alpDoc );
+      xmlFreeDoc( alpDoc );
+      alpDoc = 0;
+      AlpinoTreeStats ts = analyseAlpinoTree( *alpTree );
+      dLevel = get_d_level( s, ts.dLevel );
+      if ( dLevel > 4 )
+	dLevel_gt4 = 1;
+      adjNpModCnt = ts.adjNpModCnt;
+      npModCnt = ts.npModCnt;
+      resolveTreeStats( ts );
+    }
+    else {
+      parseFailCnt = 1; // failed
+    }
+  }
+
+  // the Wopr results were requested for the whole document by docStats
+  vector<double> woprProbsV_fwd(w.size(),NAN);
+  vector<double> woprProbsV_bwd(w.size(),NAN);
+  double sentProb_fwd = NAN;
+  double sentProb_bwd = NAN;
+  double sentEntropy_fwd = NAN;
+  double sentEntropy_bwd = NAN;
+  double sentPerplexity_fwd = NAN;
+  double sentPerplexity_bwd = NAN;
+  if ( wopr ){
+    WoprResult fwd;
+    WoprResult bwd;
+    wopr->result( wopr_pos, fwd, bwd );
+    if ( fwd.word_probs.size() == w.size() ){
+      woprProbsV_fwd = fwd.word_probs;
+      sentProb_fwd = fwd.sent_prob;
+      sentEntropy_fwd = fwd.entropy;
+      sentPerplexity_fwd = fwd.perplexity;
+    }
+    else if ( !fwd.word_probs.empty() ){
+      cerr << "unforseen mismatch between de number of words returned by WOPR"
+	   << endl << " and the number of words in the input sentence. "
+	   << endl;
+    }
+    if ( bwd.word_probs.size() == w.size() ){
+      woprProbsV_bwd = bwd.word_probs;
+      sentProb_bwd = bwd.sent_prob;
+      sentEntropy_bwd = bwd.entropy;
+      sentPerplexity_bwd = bwd.perplexity;
+    }
+    else if ( !bwd.word_probs.empty() ){
+      cerr << "unforseen mismatch between de number of words returned by WOPR"
+	   << endl << " and the number of words in the input sentence. "
+	   << endl;
+    }
+  }
 
   sentCnt = 1; // so only count the sentence when not failed
 
   bool question = false;
-  vector<string> wordbuffer;
-  vector<string> lemmabuffer;
-  if ( pred ){
-    fill_word_lemma_buffers( pred, wordbuffer, lemmabuffer );
-#ifdef DEBUG_OL
-    cerr << "call sentenceOverlap, wordbuffer " << wordbuffer << endl;
-    cerr << "call sentenceOverlap, lemmabuffer " << lemmabuffer << endl;
-#endif
-  }
+  PunctuationIndex puncts( is_punct );
   for ( size_t i=0; i < w.size(); ++i ){
-    xmlNode *alpWord = 0;
-    if ( alpDoc ){
-      alpWord = getAlpNodeWord( alpDoc, w[i] );
+    int alpWord = -1;
+    if ( alpTree ){
+      alpWord = getAlpNodeWord( *alpTree, w[i] );
     }
-    wordStats *ws = new wordStats( i, w[i], alpWord, puncts, parseFailCnt==1 );
+    wordStats *ws = new wordStats( i, w[i], alpTree, alpWord, puncts,
+				   parseFailCnt==1, overlay );
     if ( parseFailCnt ){
       sv.push_back( ws );
       continue;
@@ -1883,9 +1045,6 @@ sentStats::sentStats( int index, folia::Sentence *s, const sentStats* pred ):
       ws->logprob10_fwd = woprProbsV_fwd[i];
     if ( woprProbsV_bwd[i] != -99 )
       ws->logprob10_bwd = woprProbsV_bwd[i];
-    if ( pred ){
-      ws->getSentenceOverlap( wordbuffer, lemmabuffer );
-    }
 
     if ( ws->lemma[ws->lemma.length()-1] == '?' ){
       question = true;
@@ -2403,18 +1562,30 @@ sentStats::sentStats( int index, folia::Sentence *s, const sentStats* pred ):
       sv.push_back( ws );
     }
   }
-  if ( alpDoc ){
-    xmlFreeDoc( alpDoc );
-  }
+  delete alpTree;
   al_gem = getMeanAL();
   al_max = getHighestAL();
-  resolveConnectives();
-  resolveSituations();
+  // find all multi-word expressions in one pass
+  vector<string> forms[Phrases::FORMS];
+  for ( const auto& w : sv ){
+    forms[Phrases::TEXT].push_back( w->text() );
+    forms[Phrases::LTEXT].push_back( w->ltext() );
+    forms[Phrases::LEMMA].push_back( w->Lemma() );
+  }
+  PhraseMatches phrases;
+  overlay->lexicons().phrases.match( forms, phrases );
+  if ( overlay->phrases().size() > 0 ){
+    PhraseMatches custom;
+    overlay->phrases().match( forms, custom );
+    phrases.merge( custom );
+  }
+  resolveConnectives( phrases );
+  resolveSituations( phrases );
   calculate_MTLDs();
-  resolveMultiWordIntensify();
+  resolveMultiWordIntensify( phrases );
   // Disabled for now
-  //  resolveMultiWordAfks();
-  resolvePrepExpr();
+  //  resolveMultiWordAfks( phrases );
+  resolvePrepExpr( phrases );
   if ( question )
     questCnt = 1;
   if ( (morphNegCnt + propNegCnt) > 1 )
@@ -2458,64 +1629,68 @@ sentStats::sentStats( int index, folia::Sentence *s, const sentStats* pred ):
   perplexity_bwd_norm = proportion(perplexity_bwd, pow(w.size(), 2)).p;
 }
 
-Conn::Type sentStats::checkMultiConnectives( const string& mword ){
-  Conn::Type conn = Conn::NOCONN;
-  if ( settings.multi_temporals.find( mword ) != settings.multi_temporals.end() ){
-    conn = Conn::TEMPOREEL;
-  }
-  else if ( settings.multi_opsommers_wg.find( mword ) != settings.multi_opsommers_wg.end() ){
-    conn = Conn::OPSOMMEND_WG;
-  }
-  else if ( settings.multi_opsommers_zin.find( mword ) != settings.multi_opsommers_zin.end() ){
-    conn = Conn::OPSOMMEND_ZIN;
-  }
-  else if ( settings.multi_contrast.find( mword ) != settings.multi_contrast.end() ){
-    conn = Conn::CONTRASTIEF;
+// Counts the words that also occur in the preceding sentence. This is the
+// only part of the analysis that depends on another sentence, so it is done
+// afterwards, in document order, when all sentences are analysed.
+void sentStats::resolveOverlap( const sentStats *pred ){
+  if ( !pred || parseFailCnt ){
+    return;
   }
-  else if ( settings.multi_compars.find( mword ) != settings.multi_compars.end() ){
-    conn = Conn::COMPARATIEF;
+  vector<string> wordbuffer;
+  vector<string> lemmabuffer;
+  fill_word_lemma_buffers( pred, wordbuffer, lemmabuffer );
+#ifdef DEBUG_OL
+  cerr << "call sentenceOverlap, wordbuffer " << wordbuffer << endl;
+  cerr << "call sentenceOverlap, lemmabuffer " << lemmabuffer << endl;
+#endif
+  for ( const auto& it : sv ){
+    wordStats *ws = dynamic_cast<wordStats*>( it );
+    ws->getSentenceOverlap( wordbuffer, lemmabuffer );
+    if ( ws->prop != CGN::ISLET ){
+      // setCommonCounts() saw these words before their overlap was known
+      wordOverlapCnt += ws->wordOverlapCnt;
+      lemmaOverlapCnt += ws->lemmaOverlapCnt;
+    }
   }
-  else if ( settings.multi_causals.find( mword ) != settings.multi_causals.end() ){
-    conn = Conn::CAUSAAL;
+}
+
+Conn::Type sentStats::checkMultiConnectives( uint32_t cats ){
+  // the first list that holds the expression
+  static const Conn::Type types[CONN_LISTS] = {
+    Conn::TEMPOREEL, Conn::OPSOMMEND_WG, Conn::OPSOMMEND_ZIN,
+    Conn::CONTRASTIEF, Conn::COMPARATIEF, Conn::CAUSAAL };
+  for ( int l=0; l < CONN_LISTS; ++l ){
+    if ( cats & conn_phrase( conn_list(l) ) ){
+      return types[l];
+    }
   }
-  //  cerr << "multi-conn " << mword << " = " << conn << endl;
-  return conn;
+  return Conn::NOCONN;
 }
 
-Situation::Type sentStats::checkMultiSituations( const string& mword ){
-  //  cerr << "check multi-sit '" << mword << "'" << endl;
+Situation::Type sentStats::checkMultiSituations( uint32_t cats ){
   Situation::Type sit = Situation::NO_SIT;
-  if ( settings.multi_time_sits.find( mword ) != settings.multi_time_sits.end() ){
+  if ( cats & sit_phrase( TIME_SITS ) ){
     sit = Situation::TIME_SIT;
   }
-  else if ( settings.multi_space_sits.find( mword ) != settings.multi_space_sits.end() ){
+  else if ( cats & sit_phrase( SPACE_SITS ) ){
     sit = Situation::SPACE_SIT;
   }
-  else if ( settings.multi_causal_sits.find( mword ) != settings.multi_causal_sits.end() ){
+  else if ( cats & sit_phrase( CAUSAL_SITS ) ){
     sit = Situation::CAUSAL_SIT;
   }
-  else if ( settings.multi_emotion_sits.find( mword ) != settings.multi_emotion_sits.end() ){
+  else if ( cats & sit_phrase( EMOTION_SITS ) ){
     sit = Situation::EMO_SIT;
   }
-  //  cerr << "multi-sit " << mword << " = " << sit << endl;
   return sit;
 }
 
-void sentStats::resolveMultiWordIntensify(){
+void sentStats::resolveMultiWordIntensify( const PhraseMatches& phrases ){
   size_t max_length_intensify = 5;
-  for ( size_t i = 0; i < sv.size() - 1; ++i ){
-    string startword = sv[i]->text();
-    string multiword = startword;
-
+  for ( size_t i = 0; i+1 < sv.size(); ++i ){
     for ( size_t j = 1; i + j < sv.size() && j < max_length_intensify; ++j ){
-      // Attach the next word to the expression
-      multiword += " " + sv[i+j]->text();
-
-      // Look for the expression in the list of intensifiers
-      map<string,Intensify::Type>::const_iterator sit;
-      sit = settings.intensify.find( multiword );
+      // Look for the expression of j+1 words in the list of intensifiers
       // If found, update the counts, if not, continue
-      if ( sit != settings.intensify.end() ){
+      if ( phrases.at( i, j+1 ) & MULTI_INTENSIFY ){
         intensCombiCnt += j + 1;
         intensCnt += j + 1;
         // Break and skip to the first word after this expression
@@ -2526,98 +1701,66 @@ void sentStats::resolveMultiWordIntensify(){
   }
 }
 
-void sentStats::resolveMultiWordAfks(){
-  if ( sv.size() > 1 ){
-    for ( size_t i=0; i < sv.size()-2; ++i ){
-      string word = sv[i]->text();
-      string multiword2 = word + " " + sv[i+1]->text();
-      string multiword3 = multiword2 + " " + sv[i+2]->text();
-      Afk::Type at = Afk::NO_A;
-      map<string,Afk::Type>::const_iterator sit
-  = settings.afkos.find( multiword3 );
-      if ( sit == settings.afkos.end() ){
-  sit = settings.afkos.find( multiword2 );
-      }
-      else {
-  cerr << "FOUND a 3-word AFK: '" << multiword3 << "'" << endl;
-      }
-      if ( sit != settings.afkos.end() ){
-  cerr << "FOUND a 2-word AFK: '" << multiword2 << "'" << endl;
-  at = sit->second;
-      }
-      if ( at != Afk::NO_A ){
-  ++afks[at];
+void sentStats::resolveMultiWordAfks( const PhraseMatches& phrases ){
+  for ( size_t i=0; i+1 < sv.size(); ++i ){
+    // 3 words first, but only 2 for the last 2 words
+    for ( size_t len = ( i+2 < sv.size() ? 3 : 2 ); len > 1; --len ){
+      if ( phrases.at( i, len ) & MULTI_AFK ){
+	string multiword = sv[i]->text();
+	for ( size_t j=1; j < len; ++j ){
+	  multiword += " " + sv[i+j]->text();
+	}
+	cerr << "FOUND a " << len << "-word AFK: '" << multiword << "'" << endl;
+	// a phrase of a custom list may have matched, which needn't be an
+	// abbreviation
+	const word_entry *e = overlay->find( multiword );
+	if ( has( e, AFK ) && e->afk != Afk::NO_A ){
+	  ++afks[e->afk];
+	}
+	break;
       }
     }
-    // don't forget the last 2 words
-    string multiword2 = sv[sv.size()-2]->text() + " " + sv[sv.size()-1]->text();
-    map<string,Afk::Type>::const_iterator sit
-      = settings.afkos.find( multiword2 );
-    if ( sit != settings.afkos.end() ){
-      cerr << "FOUND a 2-word AFK: '" << multiword2 << "'" << endl;
-      Afk::Type at = sit->second;
-      ++afks[at];
-    }
   }
 }
 
-void sentStats::resolvePrepExpr(){
+void sentStats::resolvePrepExpr( const PhraseMatches& phrases ){
   if ( sv.size() > 2 ){
     for ( size_t i=0; i < sv.size()-1; ++i ){
-      string word = sv[i]->ltext();
-      string mw2 = word + " " + sv[i+1]->ltext();
-      if ( settings.vzexpr2.find( mw2 ) != settings.vzexpr2.end() ){
-  ++prepExprCnt;
-  i += 1;
-  continue;
-      }
-      if ( i < sv.size() - 2 ){
-  string mw3 = mw2 + " " + sv[i+2]->ltext();
-  if ( settings.vzexpr3.find( mw3 ) != settings.vzexpr3.end() ){
-    ++prepExprCnt;
-    i += 2;
-    continue;
-  }
-  if ( i < sv.size() - 3 ){
-    string mw4 = mw3 + " " + sv[i+3]->ltext();
-    if ( settings.vzexpr4.find( mw4 ) != settings.vzexpr4.end() ){
-      ++prepExprCnt;
-      i += 3;
-      continue;
-    }
-  }
+      // the shortest expression first
+      for ( size_t len=2; len <= 4 && i+len <= sv.size(); ++len ){
+	if ( phrases.at( i, len ) & PREP_EXPR ){
+	  ++prepExprCnt;
+	  i += len-1;
+	  break;
+	}
       }
     }
   }
 }
 
-// Finds nodes of adverbials and reports counts
-void sentStats::resolveAdverbials(xmlDoc *alpDoc) {
-  list<xmlNode*> nodes = getAdverbialNodes(alpDoc);
-  vcModCnt = nodes.size();
+// Reports counts of the adverbial nodes
+void sentStats::resolveAdverbials(const AlpinoTreeStats& ts) {
+  vcModCnt = ts.vcModCnt;
 
   // Check for adverbials consisting of a single node that has the 'GENERAL' type.
-  for (auto& node : nodes) {
-    string word = TiCC::getAttribute(node, "word");
-    if (word != "")
+  for (const auto& w : ts.vcModWords) {
+    string word = TiCC::lowercase(w);
+    if (checkAdverbType(overlay->find(word), CGN::BW) == Adverb::GENERAL)
     {
-      word = TiCC::lowercase(word);
-      if (checkAdverbType(word, CGN::BW) == Adverb::GENERAL)
-      {
-        vcModSingleCnt++;
-      }
+      vcModSingleCnt++;
     }
   }
 }
 
-parStats::parStats( int index, folia::Paragraph *p ):
+parStats::parStats( int index,
+		    folia::Paragraph *p,
+		    const vector<sentStats*>& sents ):
   structStats( index, p, "par" )
 {
   sentCnt = 0;
-  vector<folia::Sentence*> sents = p->sentences();
   sentStats *prev = 0;
-  for ( size_t i=0; i < sents.size(); ++i ){
-    sentStats *ss = new sentStats( i, sents[i], prev );
+  for ( const auto& ss : sents ){
+    ss->resolveOverlap( prev );
     prev = ss;
     merge( ss );
   }
@@ -2689,9 +1832,11 @@ void docStats::calculate_doc_overlap( ){
   }
 }
 
-docStats::docStats( folia::Document *doc ):
+docStats::docStats( folia::Document *doc, AlpinoBatch *prefetch,
+		    const LexiconOverlay *overlay ):
   structStats( 0, 0, "document" ),
-  doc_word_overlapCnt(0), doc_lemma_overlapCnt(0)
+  doc_word_overlapCnt(0), doc_lemma_overlapCnt(0),
+  alpino_scheduled( false )
 {
   sentCnt = 0;
   doc->declare( folia::AnnotationType::METRIC,
@@ -2706,9 +1851,84 @@ docStats::docStats( folia::Document *doc ):
   vector<folia::Paragraph*> pars = doc->paragraphs();
   if ( pars.size() > 0 )
     folia_node = pars[0]->parent();
+  // analyse all sentences of the document concurrently. they are merged
+  // into their paragraphs afterwards, in document order.
+  vector<folia::Sentence*> sents;
+  vector<size_t> par_start; // index in sents of the first sentence
+  for ( const auto& par : pars ){
+    par_start.push_back( sents.size() );
+    vector<folia::Sentence*> ps = par->sentences();
+    sents.insert( sents.end(), ps.begin(), ps.end() );
+  }
+  par_start.push_back( sents.size() );
+  vector<int> sent_index( sents.size() );
+  for ( size_t i=0; i < pars.size(); ++i ){
+    for ( size_t j=par_start[i]; j < par_start[i+1]; ++j ){
+      sent_index[j] = j - par_start[i];
+    }
+  }
+  vector<string> texts;
+  vector<vector<string>> tags;
+  for ( const auto& sent : sents ){
+    texts.push_back( TiCC::UnicodeToUTF8( sent->toktext() ) );
+    tags.push_back( frog_tags( sent ) );
+  }
+  AlpinoBatch *alpino = prefetch;
+  vector<size_t> alpino_pos( sents.size() );
+  if ( prefetch ){
+    // most sentences were queued while Frog returned them
+    alpino_pos = prefetch->positions( texts, tags );
+  }
+  else if ( settings.doAlpinoServer ){
+    // send all sentences to Alpino right away
+    alpino = new AlpinoBatch( *alpino_client, texts, tags, parse_cache,
+			      settings.alpinoSplit );
+    for ( size_t i=0; i < sents.size(); ++i ){
+      alpino_pos[i] = i;
+    }
+  }
+  WoprBatch *wopr = 0;
+  if ( settings.doWopr ){
+    // and to both Wopr servers, in one request each
+    wopr = new WoprBatch( config, *wopr_fwd_servers, *wopr_bwd_servers,
+			  texts );
+  }
+  vector<sentStats*> sstats( sents.size(), 0 );
+  vector<exception_ptr> failures( sents.size() );
+#pragma omp parallel for schedule(dynamic)
+  for ( long int i=0; i < (long int)sents.size(); ++i ){
+    try {
+      sstats[i] = new sentStats( sent_index[i], sents[i], alpino, alpino_pos[i],
+				 wopr, i, overlay );
+    }
+    catch ( ... ){
+      failures[i] = current_exception();
+    }
+  }
+  if ( alpino ){
+    alpino_scheduled = true;
+    alpino_schedule = alpino->schedule();
+    cerr << "Alpino: " << alpino_schedule << endl;
+  }
+  cerr << "word features: " << overlay->features().stats() << endl;
+  if ( alpino != prefetch ){
+    delete alpino;
+  }
+  delete wopr;
+  for ( size_t i=0; i < sents.size(); ++i ){
+    if ( failures[i] ){
+      // report the first failure, as a sequential run would have done
+      for ( const auto& ss : sstats ){
+	delete ss;
+      }
+      rethrow_exception( failures[i] );
+    }
+  }
   for ( size_t i=0; i != pars.size(); ++i ){
-    parStats *ps = new parStats( i, pars[i] );
-      merge( ps );
+    vector<sentStats*> ps( sstats.begin() + par_start[i],
+			   sstats.begin() + par_start[i+1] );
+    parStats *ps_stats = new parStats( i, pars[i], ps );
+    merge( ps_stats );
   }
   calculate_MTLDs();
 
@@ -2729,15 +1949,107 @@ docStats::docStats( folia::Document *doc ):
 
 //#define DEBUG_FROG
 
-folia::Document *getFrogResult( istream& is ){
-  string host = config.lookUp( "host", "frog" );
-  string port = config.lookUp( "port", "frog" );
-  Sockets::ClientSocket client;
-  if ( !client.connect( host, port ) ){
-    cerr << "failed to open Frog connection: "<< host << ":" << port << endl;
-    cerr << "Reason: " << client.getMessage() << endl;
-    return 0;
+// the tokenized text of the words below 'node', like Sentence::toktext()
+static void collect_words( const xmlNode *node, string& txt,
+			   vector<string>& tags ){
+  for ( const xmlNode *pnt = node->children; pnt; pnt = pnt->next ){
+    if ( pnt->type != XML_ELEMENT_NODE ){
+      continue;
+    }
+    if ( TiCC::Name( pnt ) != "w" ){
+      collect_words( pnt, txt, tags );
+      continue;
+    }
+    string tag;
+    for ( const xmlNode *t = pnt->children; t; t = t->next ){
+      if ( t->type != XML_ELEMENT_NODE ){
+	continue;
+      }
+      if ( TiCC::Name( t ) == "t" ){
+	string cls = TiCC::getAttribute( t, "class" );
+	if ( cls.empty() || cls == "current" ){
+	  if ( !txt.empty() ){
+	    txt += " ";
+	  }
+	  txt += TiCC::XmlContent( t );
+	}
+      }
+      else if ( TiCC::Name( t ) == "pos" ){
+	string set = TiCC::getAttribute( t, "set" );
+	if ( set.empty() || set == frog_pos_set ){
+	  tag = TiCC::getAttribute( t, "class" );
+	}
+      }
+    }
+    tags.push_back( tag );
+  }
+}
+
+// Picks the complete <s> elements out of Frog's output while it is still
+// coming in, and queues them for Alpino. So Alpino parses the first
+// sentences while Frog is still busy with the rest of the document.
+class FrogSentenceScanner {
+public:
+  explicit FrogSentenceScanner( AlpinoBatch *b ):
+    batch( b ), pos( 0 ), depth( 0 ), start( 0 ) {};
+  void scan( const string& );
+private:
+  void queue( const string& );
+  AlpinoBatch *batch;
+  size_t pos;   // where to continue scanning
+  int depth;    // of nested <s> elements
+  size_t start; // of the outermost <s>
+};
+
+void FrogSentenceScanner::scan( const string& data ){
+  while ( ( pos = data.find( '<', pos ) ) != string::npos ){
+    size_t end = data.find( '>', pos );
+    if ( end == string::npos ){
+      return; // the tag is not complete yet
+    }
+    if ( data.compare( pos, 4, "</s>" ) == 0 ){
+      if ( depth > 0 && --depth == 0 ){
+	queue( data.substr( start, end + 1 - start ) );
+      }
+    }
+    else if ( ( data.compare( pos, 3, "<s " ) == 0
+		|| data.compare( pos, 3, "<s>" ) == 0 )
+	      && data[end-1] != '/' ){
+      if ( depth++ == 0 ){
+	start = pos;
+      }
+    }
+    pos = end + 1;
   }
+  pos = data.size();
+}
+
+void FrogSentenceScanner::queue( const string& xml ){
+  xmlDoc *doc = xmlReadMemory( xml.c_str(), xml.length(), 0, 0,
+			       XML_PARSE_NOBLANKS|XML_PARSE_NONET
+			       |XML_PARSE_NOERROR|XML_PARSE_NOWARNING );
+  if ( !doc ){
+    return; // docStats will queue this sentence itself
+  }
+  string txt;
+  vector<string> tags;
+  collect_words( xmlDocGetRootElement( doc ), txt, tags );
+  xmlFreeDoc( doc );
+  if ( !txt.empty() ){
+#ifdef DEBUG_FROG
+    cerr << "queue for Alpino: '" << txt << "'" << endl;
+#endif
+    batch->add( txt, tags );
+  }
+}
+
+// Sends the input over a connection to Frog, and reads the answer.
+// 'answered' is false when Frog didn't send anything back (an error in
+// the input isn't held against the server).
+static folia::Document *frogExchange( Sockets::ClientSocket& client,
+				      istream& is, AlpinoBatch *alpino,
+				      bool& answered ){
+  answered = true;
 #ifdef DEBUG_FROG
   cerr << "start input loop" << endl;
 #endif
@@ -2781,16 +2093,21 @@ folia::Document *getFrogResult( istream& is ){
     }
   }
   client.write( "\nEOT\n" );
+  FrogSentenceScanner scanner( alpino );
   string result;
   string s;
   while ( client.read(s) ){
     if ( s == "READY" )
       break;
     result += s + "\n";
+    if ( alpino ){
+      scanner.scan( result );
+    }
   }
 #ifdef DEBUG_FROG
   cerr << "received data [" << result << "]" << endl;
 #endif
+  answered = !result.empty();
   folia::Document *doc = 0;
   if ( !result.empty() && result.size() > 10 ){
 #ifdef DEBUG_FROG
@@ -2811,38 +2128,406 @@ folia::Document *getFrogResult( istream& is ){
   return doc;
 }
 
+// Sends the input to Frog and returns the FoLiA document it makes. When
+// 'alpino' is given, the sentences are queued for parsing as soon as
+// Frog returns them.
+folia::Document *getFrogResult( istream& is, AlpinoBatch *alpino ){
+  // when a Frog server can't be reached, try the next one
+  for ( size_t attempt=0; attempt < frog_servers->size(); ++attempt ){
+    int server = frog_servers->acquire();
+    Sockets::ClientSocket client;
+    if ( !client.connect( frog_servers->host( server ),
+			  frog_servers->port( server ) ) ){
+      cerr << "failed to open Frog connection: "
+	   << frog_servers->name( server ) << endl;
+      cerr << "Reason: " << client.getMessage() << endl;
+      frog_servers->release( server, false );
+      continue;
+    }
+    // the input can't be sent again, so a Frog server that drops the
+    // connection is only left out for the next documents
+    bool answered;
+    folia::Document *doc = frogExchange( client, is, alpino, answered );
+    frog_servers->release( server, answered );
+    return doc;
+  }
+  return 0;
+}
+
 //#define DEBUG_ALPINO
 
 xmlDoc *AlpinoServerParse( folia::Sentence *sent ){
-  string host = config.lookUp( "host", "alpino" );
-  string port = config.lookUp( "port", "alpino" );
-  Sockets::ClientSocket client;
-  if ( !client.connect( host, port ) ){
-    cerr << "failed to open Alpino connection: "<< host << ":" << port << endl;
-    cerr << "Reason: " << client.getMessage() << endl;
-    exit( EXIT_FAILURE );
-  }
-#ifdef DEBUG_ALPINO
-  cerr << "start input loop" << endl;
-#endif
   string txt = TiCC::UnicodeToUTF8(sent->toktext());
-  client.write( txt + "\n\n" );
+  vector<string> tags = frog_tags( sent );
+  if ( splitForAlpino( txt, tags, settings.alpinoSplit ).size() > 1 ){
+    // let a batch parse the pieces side by side
+    AlpinoBatch batch( *alpino_client, vector<string>( 1, txt ),
+		       vector<vector<string>>( 1, tags ),
+		       parse_cache, settings.alpinoSplit );
+    return batch.result( 0 );
+  }
+  if ( parse_cache ){
+    xmlDoc *doc = parse_cache->lookup( txt );
+    if ( doc ){
+      return doc;
+    }
+  }
   string result;
-  string s;
-  while ( client.read(s) ){
-    result += s + "\n";
+  if ( !alpino_client->parse( txt, result ) ){
+    return 0;
   }
-#ifdef DEBUG_ALPINO
-  cerr << "received data [" << result << "]" << endl;
-#endif
   xmlDoc *doc = xmlReadMemory( result.c_str(), result.length(),
 			       0, 0, XML_PARSE_NOBLANKS );
-  string txtfile = workdir_name + "1.xml";
-  xmlSaveFormatFileEnc( txtfile.c_str(), doc, "UTF8", 1 );
+  if ( parse_cache ){
+    parse_cache->store( txt, doc );
+  }
   return doc;
 }
 
-int main(int argc, char *argv[]) {
+// The lexicons for the jobs: 'snapshot' with the custom word lists in the
+// [[overlay]] section of the config file, e.g.
+//   noun_semtypes=<file>
+// which add entries to the lexicons of the same name, or override theirs.
+// Returns 0 when a list can't be read.
+LexiconOverlay *init_job_lexicons( const TiCC::Configuration& cf,
+				   const lexicon_snapshot& snapshot ){
+  LexiconOverlay *result = new LexiconOverlay( snapshot );
+  const string lists[] = { "noun_semtypes", "adj_semtypes", "intensify",
+			   "stop_lemmata", "my_classification" };
+  for ( const auto& list : lists ){
+    string file = cf.lookUp( list, "overlay" );
+    if ( file.empty() ){
+      continue;
+    }
+    if ( file[0] != '/' ){
+      file = cf.configDir() + "/" + file;
+    }
+    if ( !result->read( list, file ) ){
+      delete result;
+      return 0;
+    }
+  }
+  return result;
+}
+
+void report_lexicons( const settingData& lexicons, long int msecs ){
+  cerr << "lexicons loaded in " << msecs << " ms: "
+       << lexicons.heap_size() / 1024 << " KB in memory, "
+       << lexicons.mapped_size() / 1024 << " KB mapped from the bundle"
+       << endl;
+}
+
+mutex reload_mutex;
+
+// Reads all lexicons (and the [[overlay]] lists) again, into a new snapshot
+// next to the current one, and gives it to the jobs that start from now on.
+// Running jobs finish with the snapshot they started with, which is freed
+// after the last of them. When a lexicon can't be read, the current ones
+// stay in use. The file names are those of the config file at startup.
+bool reload_lexicons(){
+  unique_lock<mutex> lock( reload_mutex, try_to_lock );
+  if ( !lock.owns_lock() ){
+    cerr << "the lexicons are being reloaded already" << endl;
+    return false;
+  }
+  cerr << "reloading the lexicons" << endl;
+  auto start = chrono::steady_clock::now();
+  // only the lexicons of this settingData are used, see lexicon_snapshot
+  shared_ptr<settingData> fresh = make_shared<settingData>();
+  LexiconOverlay *lists = 0;
+  if ( fresh->load_lexicons( config ) ){
+    lists = init_job_lexicons( config, fresh );
+  }
+  if ( !lists ){
+    cerr << "reloading the lexicons failed, the current ones are kept"
+	 << endl;
+    return false;
+  }
+  report_lexicons( *fresh, chrono::duration_cast<chrono::milliseconds>
+		   ( chrono::steady_clock::now() - start ).count() );
+  atomic_store( &job_lexicons, shared_ptr<const LexiconOverlay>( lists ) );
+  return true;
+}
+
+// a SIGHUP asks the server to reload the lexicons. The signal handler only
+// sets a flag, the reload itself is done by a watcher thread.
+volatile sig_atomic_t reload_requested = 0;
+
+extern "C" void request_reload( int ){
+  reload_requested = 1;
+}
+
+void watch_reload_requests(){
+  while ( true ){
+    this_thread::sleep_for( chrono::seconds( 1 ) );
+    if ( reload_requested ){
+      reload_requested = 0;
+      reload_lexicons();
+    }
+  }
+}
+
+once_flag reload_watcher;
+
+void start_reload_watcher(){
+  // started in the process that serves the requests (so after the server
+  // became a daemon)
+  call_once( reload_watcher,
+	     []{ thread( watch_reload_requests ).detach(); } );
+}
+
+//#define DEBUG_SERVER
+
+class TscanServer : public TiCC::TcpServerBase {
+public:
+  explicit TscanServer( const TiCC::Configuration *c ):
+    TcpServerBase( c, 0 ){};
+  void callback( TiCC::childArgs * );
+};
+
+void TscanServer::callback( TiCC::childArgs *args ){
+  // One document per connection.
+  // The client sends some optional header lines:
+  //   %input=text|folia  (default text, which is sent to Frog first)
+  //   %output=folia|csv  (default folia)
+  //   %name=<name>       (used in the 'Inputfile' column of the CSV output)
+  //   %<list>            a custom word list for this document, on top of the
+  //                      lexicons of the server (see LexiconOverlay): the
+  //                      lines up to a line holding only '%end'
+  //   %command=reload    no document: reload the lexicons (see
+  //                      reload_lexicons())
+  // followed by the document and a line holding only 'EOT'.
+  // The answer is terminated by a line holding only 'READY'.
+  // Problems are reported on a line starting with 'ERROR'.
+  istream& is = args->is();
+  ostream& os = args->os();
+  bool folia_input = false;
+  bool csv_output = false;
+  string name = "doc-" + TiCC::toString( args->id() );
+  vector<pair<string,string> > lists;
+  string data;
+  string line;
+  bool in_header = true;
+  while ( safe_getline( is, line ) ){
+    if ( line == "EOT" )
+      break;
+    if ( in_header && !line.empty() && line[0] == '%' ){
+      string list = TiCC::trim( line.substr(1) );
+      if ( LexiconOverlay::is_list( list ) ){
+	// the list itself is sent, the server opens no files for a client
+	string content;
+	bool ended = false;
+	while ( safe_getline( is, line ) ){
+	  if ( line == "%end" ){
+	    ended = true;
+	    break;
+	  }
+	  content += line + "\n";
+	}
+	if ( !ended ){
+	  os << "ERROR no %end after the list " << list << endl;
+	  os << "READY" << endl;
+	  return;
+	}
+	lists.push_back( make_pair( list, content ) );
+	continue;
+      }
+      vector<string> parts;
+      if ( TiCC::split_at( line.substr(1), parts, "=" ) != 2 ){
+	os << "ERROR invalid header line: " << line << endl;
+	os << "READY" << endl;
+	return;
+      }
+      string key = TiCC::trim( parts[0] );
+      string value = TiCC::trim( parts[1] );
+      if ( key == "input" && ( value == "text" || value == "folia" ) ){
+	folia_input = ( value == "folia" );
+      }
+      else if ( key == "output" && ( value == "folia" || value == "csv" ) ){
+	csv_output = ( value == "csv" );
+      }
+      else if ( key == "name" ){
+	name = value;
+      }
+      else if ( key == "command" && value == "reload" ){
+	start_reload_watcher();
+	if ( reload_lexicons() ){
+	  os << "OK lexicons reloaded" << endl;
+	}
+	else {
+	  os << "ERROR reloading the lexicons failed" << endl;
+	}
+	os << "READY" << endl;
+	return;
+      }
+      else {
+	os << "ERROR unsupported header: " << line << endl;
+	os << "READY" << endl;
+	return;
+      }
+      continue;
+    }
+    in_header = false;
+    data += line + "\n";
+  }
+#ifdef DEBUG_SERVER
+  cerr << "request " << args->id() << " received "
+       << data.size() << " bytes" << endl;
+#endif
+  start_reload_watcher();
+  // this document is analysed with the lexicons of this moment, also when
+  // they are reloaded in the meantime
+  shared_ptr<const LexiconOverlay> lexicons = atomic_load( &job_lexicons );
+  const LexiconOverlay *overlay = lexicons.get();
+  LexiconOverlay *request_lists = 0;
+  if ( !lists.empty() ){
+    // only this document uses them, on top of the [[overlay]] lists
+    request_lists = new LexiconOverlay( lexicons.get() );
+    for ( const auto& list : lists ){
+      istringstream ls( list.second );
+      if ( !request_lists->read( list.first, ls ) ){
+	os << "ERROR invalid list " << list.first << endl;
+	os << "READY" << endl;
+	delete request_lists;
+	return;
+      }
+    }
+    overlay = request_lists;
+  }
+  folia::Document *doc = 0;
+  AlpinoBatch *prefetch = 0;
+  try {
+    if ( folia_input ){
+      doc = new folia::Document();
+      doc->readFromString( data );
+    }
+    else {
+      istringstream ss( data );
+      if ( settings.doAlpinoServer ){
+	prefetch = new AlpinoBatch( *alpino_client, parse_cache,
+				   settings.alpinoSplit );
+      }
+      doc = getFrogResult( ss, prefetch );
+    }
+    if ( !doc ){
+      os << "ERROR no FoLiA document created" << endl;
+    }
+    else {
+      docStats analyse( doc, prefetch, overlay );
+      analyse.addMetrics(); // add metrics info to doc
+      if ( csv_output ){
+	const csvKind kinds[] = { DOC_CSV, PAR_CSV, SENT_CSV, WORD_CSV };
+	for ( const auto kind : kinds ){
+	  os << "#CSV " << csv_label( kind ) << endl;
+	  analyse.toCSV( os, name, kind );
+	}
+      }
+      else {
+	os << doc->toXml();
+      }
+    }
+  }
+  catch ( std::exception& e ){
+    cerr << "request " << args->id() << " failed: " << e.what() << endl;
+    os << "ERROR " << e.what() << endl;
+  }
+  delete prefetch;
+  delete doc;
+  delete request_lists;
+  os << "READY" << endl;
+}
+
+// The parse cache is configured in the [[alpino]] section:
+//   cache=<dir>         the cache directory (relative to the config file)
+//   cache_size=<MB>     its maximum size in megabytes (default 1024)
+//   cache_tag=<string>  describes the parser setup, e.g. the Alpino version
+//                       and flags of the server. Change it to start afresh.
+ParseCache *init_parse_cache( const TiCC::Configuration& cf ){
+  string dir = cf.lookUp( "cache", "alpino" );
+  if ( dir.empty() ){
+    return 0;
+  }
+  if ( dir[0] != '/' ){
+    dir = cf.configDir() + "/" + dir;
+  }
+  uint64_t size = 1024;
+  string val = cf.lookUp( "cache_size", "alpino" );
+  if ( !val.empty() && ( !TiCC::stringTo( val, size ) || size == 0 ) ){
+    cerr << "invalid value for 'cache_size' in config file" << endl;
+    exit( EXIT_FAILURE );
+  }
+  string identity;
+  if ( settings.doAlpinoServer ){
+    // all servers listed should run the same Alpino
+    string servers = cf.lookUp( "servers", "alpino" );
+    if ( servers.empty() ){
+      servers = cf.lookUp( "host", "alpino" )
+	+ ":" + cf.lookUp( "port", "alpino" );
+    }
+    identity = "server " + servers;
+  }
+  else {
+    identity = "Alpino -fast";
+  }
+  identity += " " + cf.lookUp( "cache_tag", "alpino" );
+  cerr << "using the Alpino parse cache in " << dir << endl;
+  return new ParseCache( dir, identity, size * 1024 * 1024 );
+}
+
+// Analyses one input file. Returns false, after reporting the problem, when
+// the file could not be processed; other files are not affected.
+bool process_file( const string& inName, const string& outName ){
+  ifstream is( inName.c_str() );
+  if ( !is ){
+    cerr << "failed to open file '" << inName << "'" << endl;
+    return false;
+  }
+  cerr << "opened file " <<  inName << endl;
+  folia::Document *doc = 0;
+  AlpinoBatch *prefetch = 0;
+  if ( settings.doAlpinoServer ){
+    prefetch = new AlpinoBatch( *alpino_client, parse_cache,
+			       settings.alpinoSplit );
+  }
+  try {
+    doc = getFrogResult( is, prefetch );
+    if ( !doc ){
+      cerr << "big trouble: no FoLiA document created for " << inName << endl;
+      delete prefetch;
+      return false;
+    }
+    shared_ptr<const LexiconOverlay> lexicons = atomic_load( &job_lexicons );
+    docStats analyse( doc, prefetch, lexicons.get() );
+    analyse.addMetrics(); // add metrics info to doc
+    doc->save( outName );
+    if ( settings.doXfiles ){
+      analyse.toCSV( inName, DOC_CSV );
+      analyse.toCSV( inName, PAR_CSV );
+      analyse.toCSV( inName, SENT_CSV );
+      analyse.toCSV( inName, WORD_CSV );
+    }
+  }
+  catch ( std::exception& e ){
+    cerr << "processing " << inName << " failed: " << e.what() << endl;
+    delete prefetch;
+    delete doc;
+    return false;
+  }
+  delete prefetch;
+  delete doc;
+  cerr << "saved output in " << outName << endl;
+  return true;
+}
+
+void remove_workdir(){
+  // the Alpino processes must stop using it first
+  delete alpino_pool;
+  alpino_pool = 0;
+  rmdir( workdir_name.c_str() );
+}
+
+void make_workdir(){
+  // only local Alpino processes need a working dir
   struct stat sbuf;
   pid_t pid = getpid();
   workdir_name = "/tmp/tscan-" + TiCC::toString( pid ) + "/";
@@ -2855,10 +2540,14 @@ int main(int argc, char *argv[]) {
       exit( EXIT_FAILURE );
     }
   }
-  cerr << "TScan " << VERSION << endl;
   cerr << "working dir " << workdir_name << endl;
+}
+
+int main(int argc, char *argv[]) {
+  cerr << "TScan " << VERSION << endl;
   string shortOpt = "ht:o:Vn";
-  string longOpt = "threads:,config:,skip:,version";
+  string longOpt = "threads:,jobs:,config:,skip:,syntax:,version,"
+    "serve,port:,maxconn:,logfile:,pidfile:,daemonize:";
   TiCC::CL_Options opts( shortOpt, longOpt );
   try {
     opts.init( argc, argv );
@@ -2880,6 +2569,29 @@ int main(int argc, char *argv[]) {
     exit( EXIT_SUCCESS );
   }
 
+  bool serve = opts.extract( "serve" );
+  TiCC::Configuration server_config;
+  if ( serve ){
+    string val;
+    if ( !opts.extract( "port", val ) ){
+      cerr << "missing --port option for --serve" << endl;
+      exit(EXIT_FAILURE);
+    }
+    server_config.setatt( "port", val );
+    if ( opts.extract( "maxconn", val ) ){
+      server_config.setatt( "maxconn", val );
+    }
+    if ( opts.extract( "logfile", val ) ){
+      server_config.setatt( "logfile", val );
+    }
+    if ( opts.extract( "pidfile", val ) ){
+      server_config.setatt( "pidfile", val );
+    }
+    if ( opts.extract( "daemonize", val ) ){
+      server_config.setatt( "daemonize", val );
+    }
+  }
+
   string t_option;
   opts.extract( 't', t_option );
   vector<string> inputnames;
@@ -2890,7 +2602,13 @@ int main(int argc, char *argv[]) {
     inputnames = TiCC::searchFiles( t_option );
   }
 
-  if ( inputnames.size() == 0 ){
+  if ( serve ){
+    if ( !inputnames.empty() ){
+      cerr << "no input files allowed with --serve" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  else if ( inputnames.size() == 0 ){
     cerr << "no input file(s) found" << endl;
     exit(EXIT_FAILURE);
   }
@@ -2906,8 +2624,8 @@ int main(int argc, char *argv[]) {
   if ( opts.extract( "threads", val ) ){
 #ifdef HAVE_OPENMP
     int num = TiCC::stringTo<int>( val );
-    if ( num < 1 || num > 4 ){
-      cerr << "wrong value for 'threads' option. (must be >=1 and <= 4 )"
+    if ( num < 1 || num > 32 ){
+      cerr << "wrong value for 'threads' option. (must be >=1 and <= 32 )"
 	   << endl;
       exit(EXIT_FAILURE);
     }
@@ -2918,11 +2636,70 @@ int main(int argc, char *argv[]) {
     cerr << "No OPEN_MP support available. 'threads' option ignored." << endl;
 #endif
   }
+  int jobs = 1;
+  if ( opts.extract( "jobs", val ) ){
+#ifdef HAVE_OPENMP
+    if ( !TiCC::stringTo( val, jobs ) || jobs < 1 || jobs > 32 ){
+      cerr << "wrong value for 'jobs' option. (must be >=1 and <= 32 )"
+	   << endl;
+      exit(EXIT_FAILURE);
+    }
+#else
+    cerr << "No OPEN_MP support available. 'jobs' option ignored." << endl;
+#endif
+  }
+
+  bool frog_syntax = false;
+  if ( opts.extract( "syntax", val ) ){
+    if ( val == "frog" ){
+      frog_syntax = true;
+    }
+    else if ( val != "alpino" ){
+      cerr << "wrong value for 'syntax' option. (must be alpino or frog)"
+	   << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
 
   opts.extract( "config", configFile );
   if ( !configFile.empty() &&
        config.fill( configFile ) ){
+    auto start = chrono::steady_clock::now();
     settings.init( config );
+    report_lexicons( settings,
+		     chrono::duration_cast<chrono::milliseconds>
+		     ( chrono::steady_clock::now() - start ).count() );
+    if ( frog_syntax ){
+      // no Alpino at all
+      settings.doFrogSyntax = true;
+      settings.doAlpino = false;
+      settings.doAlpinoServer = false;
+    }
+    frog_servers = new Endpoints( config, "frog" );
+    wopr_fwd_servers = new Endpoints( config, "wopr", "_fwd" );
+    wopr_bwd_servers = new Endpoints( config, "wopr", "_bwd" );
+    if ( settings.doAlpinoServer ){
+      alpino_client = new AlpinoClient( config );
+    }
+    else if ( settings.doAlpino ){
+      make_workdir();
+      alpino_pool = new AlpinoPool( config, workdir_name );
+      atexit( remove_workdir );
+    }
+    if ( !settings.alpinoDump.empty() &&
+	 !TiCC::createPath( settings.alpinoDump ) ){
+      cerr << "unable to create the Alpino dump directory '"
+	   << settings.alpinoDump << "'" << endl;
+      exit( EXIT_FAILURE );
+    }
+    parse_cache = init_parse_cache( config );
+    // 'settings' is the first lexicon snapshot, it is never deleted
+    lexicon_snapshot first( &settings, []( const settingData* ){} );
+    LexiconOverlay *lists = init_job_lexicons( config, first );
+    if ( !lists ){
+      exit( EXIT_FAILURE );
+    }
+    job_lexicons.reset( lists );
   }
   else {
     cerr << "invalid configuration" << endl;
@@ -2953,10 +2730,27 @@ int main(int argc, char *argv[]) {
     exit(EXIT_FAILURE);
   }
 
+  // documents are analysed by several threads, which all use libxml2
+  xmlInitParser();
+  if ( serve ){
+    // all lexicons are loaded now. Keep them for every request, until they
+    // are reloaded on a SIGHUP or a '%command=reload' request.
+    signal( SIGHUP, request_reload );
+    if ( server_config.lookUp( "daemonize" ) == "no" ){
+      start_reload_watcher();
+    }
+    TscanServer server( &server_config );
+    exit( server.Run() );
+  }
+
   if ( inputnames.size() > 1 ){
     cerr << "processing " << inputnames.size() << " files." << endl;
   }
-  for ( size_t i = 0; i < inputnames.size(); ++i ){
+  size_t failed = 0;
+  // every file is analysed by one job, at most 'jobs' files at the same
+  // time. All jobs share the (read-only) settings.
+#pragma omp parallel for schedule(dynamic) num_threads(jobs) reduction(+:failed) if(jobs > 1)
+  for ( long int i = 0; i < (long int)inputnames.size(); ++i ){
     string inName = inputnames[i];
     string outName;
     if ( !o_option.empty() ){
@@ -2966,39 +2760,22 @@ int main(int argc, char *argv[]) {
     else {
       outName = inName + ".tscan.xml";
     }
-    ifstream is( inName.c_str() );
-    if ( !is ){
-      cerr << "failed to open file '" << inName << "'" << endl;
-      if ( !o_option.empty() ){
-	// just 1 inputfile
-	exit(EXIT_FAILURE);
-      }
-      continue;
+    if ( !process_file( inName, outName ) ){
+      ++failed;
     }
-    else {
-      cerr << "opened file " <<  inName << endl;
-      folia::Document *doc = getFrogResult( is );
-      if ( !doc ){
-	cerr << "big trouble: no FoLiA document created " << endl;
-	if ( !o_option.empty() ){
-	  // just 1 inputfile
-	  exit(EXIT_FAILURE);
-	}
-	continue;
-      }
-      else {
-	docStats analyse( doc );
-	analyse.addMetrics(); // add metrics info to doc
-	doc->save( outName );
-	if ( settings.doXfiles ){
-	  analyse.toCSV( inName, DOC_CSV );
-	  analyse.toCSV( inName, PAR_CSV );
-	  analyse.toCSV( inName, SENT_CSV );
-	  analyse.toCSV( inName, WORD_CSV );
-	}
-	delete doc;
-	cerr << "saved output in " << outName << endl;
-      }
+  }
+  if ( parse_cache ){
+    cerr << "parse cache: " << parse_cache->hits() << " hits, "
+	 << parse_cache->misses() << " misses" << endl;
+  }
+  if ( failed > 0 ){
+    if ( inputnames.size() > 1 ){
+      cerr << failed << " of the " << inputnames.size()
+	   << " files failed" << endl;
+    }
+    if ( !o_option.empty() ){
+      // just 1 inputfile
+      exit(EXIT_FAILURE);
     }
   }
   exit(EXIT_SUCCESS);
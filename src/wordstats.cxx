@@ -58,7 +58,7 @@ bool match_tail( const string& word, const string& tail ){
 
 //#define DEBUG_NOMINAL
 
-bool wordStats::checkNominal( const xmlNode *alpWord ) const {
+bool wordStats::checkNominal( const AlpinoTree& alpTree, int alpWord ) const {
   static string morphList[] = { "ing", "sel", "nis", "enis", "heid", "te",
 				"schap", "dom", "sie", "ie", "iek", "iteit",
 				"isme", "age", "atie", "esse",	"name" };
@@ -117,14 +117,11 @@ bool wordStats::checkNominal( const xmlNode *alpWord ) const {
     }
   }
 
-  string pos = TiCC::getAttribute( alpWord, "pos" );
-  if ( pos == "verb" ){
+  if ( alpTree[alpWord].pos == AlpPos::VERB ){
     // Alpino heeft de voor dit feature prettige eigenschap dat het nogal
     // eens nominalisaties wil taggen als werkwoord dat onder een
     // NP knoop hangt
-    alpWord = alpWord->parent;
-    string cat = TiCC::getAttribute( alpWord, "cat" );
-    if ( cat == "np" ){
+    if ( alpTree.cat( alpTree[alpWord].parent ) == AlpCat::NP ){
 #ifdef DEBUG_NOMINAL
       cerr << "Alpino says NOMINAL!" << endl;
 #endif
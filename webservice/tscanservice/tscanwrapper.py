@@ -56,20 +56,18 @@ if not 'top_freq_lex' in clamdata:
 
 
 def load_custom_wordlist(configfile, inputdir, tscan_name, inputtemplate, default_location=None):
-    """This allows custom word lists. Does require to specify the full path to the files."""
-    wordlist = None
-
+    """This allows custom word lists. Does require to specify the full path to the files.
+    The default list (if there is one) is written to the config file, an uploaded list is
+    remembered for the [[overlay]] section, so it adds to or overrides the default entries."""
     for inputfile in clamdata.inputfiles(inputtemplate):
-        wordlist = inputdir + inputfile.filename
+        custom_wordlists.append((tscan_name, inputdir + inputfile.filename))
         break
-    else:
-        # When no inputfile is found, revert to the default (if there is one)
-        if default_location:
-            wordlist = TSCANDIR + default_location
 
-    # Write the wordlist to the config file
-    if wordlist:
-        configfile.write(tscan_name + "=\"" + wordlist + "\"\n")
+    # Write the default wordlist to the config file
+    if default_location:
+        configfile.write(tscan_name + "=\"" + TSCANDIR + default_location + "\"\n")
+
+custom_wordlists = []
 
 #Write configuration file
 
@@ -158,6 +156,12 @@ if 'prevalence' in clamdata:
 f.write("prevalence=\"prevalence_" + prevalence + ".data\"\n")
 
 
+if custom_wordlists:
+    f.write("[[overlay]]\n")
+    for tscan_name, wordlist in custom_wordlists:
+        f.write(tscan_name + "=\"" + wordlist + "\"\n")
+    f.write("\n")
+
 f.write("[[frog]]\n")  # Frog server should already be runnning, start manually
 f.write("port=7001\n")
 f.write("host=127.0.0.1\n\n")